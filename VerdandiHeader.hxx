@@ -177,6 +177,17 @@ namespace Verdandi
 } // namespace Verdandi.
 
 
+// The C++11 detection precedes the includes below, since the declaration
+// of 'OutputSaver' depends on it.
+#ifdef __GXX_EXPERIMENTAL_CXX0X__
+#define VERDANDI_HAS_CXX11
+#elif defined __clang__
+#define VERDANDI_HAS_CXX11
+#elif __cplusplus > 199711L
+#define VERDANDI_HAS_CXX11
+#endif
+
+
 #ifndef VERDANDI_PYTHON_VERSION
 #define VERDANDI_PYTHON_VERSION 3.8
 #endif
@@ -185,6 +196,7 @@ namespace Verdandi
 #include "share/Logger.hxx"
 #include "share/Error.hxx"
 #include "share/UsefulFunction.hxx"
+#include "share/SymmetricFactorization.hxx"
 #include "share/MessageHandler.hxx"
 #include "share/VerdandiBase.hxx"
 #include "share/OutputSaver.hxx"
@@ -200,14 +212,6 @@ namespace Verdandi
 #define VERDANDI_STATE_ERROR_DENSE
 #endif
 
-#ifdef __GXX_EXPERIMENTAL_CXX0X__
-#define VERDANDI_HAS_CXX11
-#elif defined __clang__
-#define VERDANDI_HAS_CXX11
-#elif __cplusplus > 199711L
-#define VERDANDI_HAS_CXX11
-#endif
-
 
 #define VERDANDI_FILE_VERDANDIHEADER_HXX
 #endif
@@ -80,8 +80,17 @@ extended_kalman_filter = {
 
    -- Computation mode for BLUE: "vector" or "matrix".
    BLUE_computation = "matrix",
-   -- Computation mode for covariance: "vector" or "matrix".
+   -- Computation mode for covariance: "vector", "matrix", "packed" or
+   -- "low_rank". With "packed", only the upper part of the covariance is
+   -- stored. With "low_rank", the covariance is carried as a factor S S^T,
+   -- with 'covariance_rank' columns.
    covariance_computation = "vector",
+   covariance_rank = 10,
+   -- Number of threads sharing the applications of the tangent linear model
+   -- in the covariance propagation, with "vector", "packed" or "low_rank"
+   -- (requires OpenMP). Each additional thread creates its own instance of
+   -- the model.
+   Nthread = 1,
 
    data_assimilation = {
 
@@ -166,6 +175,21 @@ unscented_kalman_filter = {
 -- Simulation with assimilation using ROUKF.
 reduced_order_unscented_kalman_filter = {
 
+   checkpoint = {
+
+      -- Binary file in which the state of the filter is regularly saved, so
+      -- that a run may be resumed. No checkpoint is written if empty. With
+      -- MPI, every process writes its own file: the markup "%{rank}" is
+      -- replaced with the process rank.
+      file = "",
+      -- Number of iterations between two checkpoints.
+      period = 10,
+      -- Checkpoint from which the run is resumed, instead of starting from
+      -- the initial condition.
+      restart_file = ""
+
+   },
+
    data_assimilation = {
 
       analyze_first_step = false,
@@ -261,6 +285,51 @@ four_dimensional_variational = {
    -- How the tangent linear operator is accessed: "element" or "matrix".
    observation_tangent_linear_operator_access = "matrix",
 
+   -- Access to the observations: "step" (the observation manager is queried
+   -- at every step of every integration) or "window" (the observations of
+   -- the assimilation window are read once, during the first integration,
+   -- and the innovations are then computed from them; the observation
+   -- operator and error covariance matrix must not depend on time).
+   observation_access = "step",
+
+   -- Minimization: "nonlinear" (NLopt minimizes the full cost function) or
+   -- "incremental" (outer loops relinearize the model around the current
+   -- trajectory, and inner loops minimize a quadratic cost with the tangent
+   -- linear model and its adjoint, by conjugate gradient).
+   minimization = "nonlinear",
+
+   incremental = {
+
+      -- Number of outer loops.
+      Nouter_loop = 3,
+      -- Maximum number of conjugate gradient iterations per outer loop.
+      Ninner_iteration_max = 50,
+      -- Relative tolerance on the residual of the inner problem.
+      inner_tolerance = 1.e-6
+
+   },
+
+   -- Model constraint: "strong" (the model is perfect and the initial state
+   -- is controlled) or "weak" (multiple shooting: the initial states of
+   -- 'Nsub_window' sub-windows are controlled, and the jumps between
+   -- consecutive sub-windows are penalized with the model error covariance
+   -- matrix). Only the "nonlinear" minimization supports "weak".
+   constraint = "strong",
+
+   weak_constraint = {
+
+      -- Number of sub-windows.
+      Nsub_window = 4,
+      -- Number of threads sharing the integration of the sub-windows
+      -- (requires OpenMP). Each additional thread creates its own instances
+      -- of the model and of the observation manager.
+      Nthread = 1,
+      -- Model error variance, used if the model provides no model error
+      -- covariance matrix.
+      model_error_variance = 1.e-2
+
+   },
+
    nlopt = {
 
       -- Optimization algorithm (LD_VAR1, LD_LBFGS, LD_SLSQP, LD_MMA,
@@ -279,6 +348,13 @@ four_dimensional_variational = {
 
    },
 
+   -- Precision of the trajectories stored in memory between the forward and
+   -- backward integrations (all trajectories without the trajectory
+   -- manager, and the linearization and sub-window trajectories with it):
+   -- "double" or "single" (halves the memory, at the cost of rounding the
+   -- states used by the tangent linear and adjoint models).
+   trajectory_precision = "double",
+
    trajectory_manager = {
 
       -- Checkpoint recording mode (memory or disk).
@@ -291,6 +367,12 @@ four_dimensional_variational = {
       trajectory_recording_file = "trajectory.bin",
       -- Recording period.
       Nskip_step = 10,
+      -- Checkpoint schedule: "uniform" (a checkpoint every 'Nskip_step'
+      -- steps) or "binomial" (optimal binomial schedule, which minimizes the
+      -- number of recomputed steps for at most 'Ncheckpoint_max' checkpoints
+      -- in memory).
+      checkpoint_schedule = "uniform",
+      Ncheckpoint_max = 10,
 
 
    },
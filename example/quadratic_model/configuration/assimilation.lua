@@ -148,8 +148,17 @@ extended_kalman_filter = {
 
    -- Computation mode for BLUE: "vector" or "matrix".
    BLUE_computation = "matrix",
-   -- Computation mode for covariance: "vector" or "matrix".
+   -- Computation mode for covariance: "vector", "matrix", "packed" or
+   -- "low_rank". With "packed", only the upper part of the covariance is
+   -- stored. With "low_rank", the covariance is carried as a factor S S^T,
+   -- with 'covariance_rank' columns.
    covariance_computation = "vector",
+   covariance_rank = 10,
+   -- Number of threads sharing the applications of the tangent linear model
+   -- in the covariance propagation, with "vector", "packed" or "low_rank"
+   -- (requires OpenMP). Each additional thread creates its own instance of
+   -- the model.
+   Nthread = 1,
 
    data_assimilation = {
 
@@ -269,9 +278,75 @@ ensemble_kalman_filter = {
 
    Nmember = 100,
 
+   -- Number of threads sharing the forecast of the members (requires
+   -- OpenMP). Each additional thread creates its own instance of the model.
+   Nthread = 1,
+
    -- How the tangent linear operator is accessed: "element" or "matrix".
    observation_tangent_linear_operator_access = "matrix",
 
+   -- Space in which the analysis is computed: "observation" (a matrix of the
+   -- size of the observations is inverted) or "ensemble" (a matrix of the
+   -- size of the ensemble is inverted, with R^{-1}). "ensemble" is
+   -- preferable with many observations, but it cannot be used with
+   -- localization.
+   analysis_space = "observation",
+
+   -- Square root analysis, in which the deviations of the members from the
+   -- mean are transformed instead of applying the gain to every member:
+   -- "none", "ETKF" (ensemble transform Kalman filter) or "EAKF" (ensemble
+   -- adjustment Kalman filter). It cannot be used with localization.
+   square_root = "none",
+
+   localization = {
+
+      -- Localization of the sample covariance: "none" or "Gaspari-Cohn".
+      type = "none",
+      -- Half-width of the localization function, which vanishes beyond
+      -- twice this distance.
+      radius = 1.,
+      -- Binary file (Seldon format) storing the coordinates of the state
+      -- components, as a matrix with one row per state component.
+      state_coordinate_file = "",
+      -- Binary file storing the coordinates of the observations. If empty,
+      -- they are derived from the tangent linear observation operator.
+      observation_coordinate_file = ""
+
+   },
+
+   inflation = {
+
+      -- Inflation of the ensemble: "none", "multiplicative" (the forecast
+      -- covariance is multiplied by 'factor'), "RTPS" (relaxation of the
+      -- analysis spread to the forecast spread, with coefficient 'factor')
+      -- or "adaptive" (the covariance factor is estimated from the
+      -- innovations, and weighted by 'factor').
+      type = "none",
+      factor = 1.05,
+      -- Binary file (Seldon format) storing one coefficient per state
+      -- component. If not empty, it replaces 'factor'.
+      factor_file = "",
+      -- Bounds of the adaptive inflation factor.
+      minimum = 1.,
+      maximum = 2.
+
+   },
+
+   checkpoint = {
+
+      -- Binary file in which the state of the filter is regularly saved, so
+      -- that a run may be resumed. No checkpoint is written if empty. With
+      -- MPI, every process writes its own file: the markup "%{rank}" is
+      -- replaced with the process rank.
+      file = "",
+      -- Number of iterations between two checkpoints.
+      period = 10,
+      -- Checkpoint from which the run is resumed, instead of starting from
+      -- the initial condition.
+      restart_file = ""
+
+   },
+
    data_assimilation = {
 
       analyze_first_step = false,
@@ -284,7 +359,8 @@ ensemble_kalman_filter = {
       time = true,
       analysis_time = true,
       state_average = true,
-      state_minimum_maximum = false
+      state_minimum_maximum = false,
+      inflation = false
 
    },
 
@@ -292,7 +368,13 @@ ensemble_kalman_filter = {
 
       variable_list = {"forecast_time", "forecast_state",
                        "analysis_time", "analysis_state"},
-      file = output_directory .. "enkf-%{name}.%{extension}"
+      file = output_directory .. "enkf-%{name}.%{extension}",
+      -- Should the outputs be written by a background thread? The saved
+      -- variables are copied, so that the filter may proceed while the
+      -- copies are written.
+      asynchronous = false,
+      -- Maximum number of pending writes in asynchronous mode.
+      queue_size = 2
 
    },
 
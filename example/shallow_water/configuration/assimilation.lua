@@ -86,9 +86,75 @@ ensemble_kalman_filter = {
 
    Nmember = 10,
 
+   -- Number of threads sharing the forecast of the members (requires
+   -- OpenMP). Each additional thread creates its own instance of the model.
+   Nthread = 1,
+
    -- How the tangent linear operator is accessed: "element" or "matrix".
    observation_tangent_linear_operator_access = "matrix",
 
+   -- Space in which the analysis is computed: "observation" (a matrix of the
+   -- size of the observations is inverted) or "ensemble" (a matrix of the
+   -- size of the ensemble is inverted, with R^{-1}). "ensemble" is
+   -- preferable with many observations, but it cannot be used with
+   -- localization.
+   analysis_space = "observation",
+
+   -- Square root analysis, in which the deviations of the members from the
+   -- mean are transformed instead of applying the gain to every member:
+   -- "none", "ETKF" (ensemble transform Kalman filter) or "EAKF" (ensemble
+   -- adjustment Kalman filter). It cannot be used with localization.
+   square_root = "none",
+
+   localization = {
+
+      -- Localization of the sample covariance: "none" or "Gaspari-Cohn".
+      type = "none",
+      -- Half-width of the localization function, which vanishes beyond
+      -- twice this distance.
+      radius = 1.,
+      -- Binary file (Seldon format) storing the coordinates of the state
+      -- components, as a matrix with one row per state component.
+      state_coordinate_file = "",
+      -- Binary file storing the coordinates of the observations. If empty,
+      -- they are derived from the tangent linear observation operator.
+      observation_coordinate_file = ""
+
+   },
+
+   inflation = {
+
+      -- Inflation of the ensemble: "none", "multiplicative" (the forecast
+      -- covariance is multiplied by 'factor'), "RTPS" (relaxation of the
+      -- analysis spread to the forecast spread, with coefficient 'factor')
+      -- or "adaptive" (the covariance factor is estimated from the
+      -- innovations, and weighted by 'factor').
+      type = "none",
+      factor = 1.05,
+      -- Binary file (Seldon format) storing one coefficient per state
+      -- component. If not empty, it replaces 'factor'.
+      factor_file = "",
+      -- Bounds of the adaptive inflation factor.
+      minimum = 1.,
+      maximum = 2.
+
+   },
+
+   checkpoint = {
+
+      -- Binary file in which the state of the filter is regularly saved, so
+      -- that a run may be resumed. No checkpoint is written if empty. With
+      -- MPI, every process writes its own file: the markup "%{rank}" is
+      -- replaced with the process rank.
+      file = "",
+      -- Number of iterations between two checkpoints.
+      period = 10,
+      -- Checkpoint from which the run is resumed, instead of starting from
+      -- the initial condition.
+      restart_file = ""
+
+   },
+
    data_assimilation = {
 
       analyze_first_step = false,
@@ -101,7 +167,8 @@ ensemble_kalman_filter = {
       time = true,
       analysis_time = true,
       state_average = true,
-      state_minimum_maximum = false
+      state_minimum_maximum = false,
+      inflation = false
    },
 
    output_saver = {
@@ -110,6 +177,12 @@ ensemble_kalman_filter = {
                        "analysis_time", "analysis_state"},
       file = output_directory .. "enkf-%{name}.%{extension}",
       time = "step " .. Delta_t_shallow_water * Nskip_save .. " 1.e-6",
+      -- Should the outputs be written by a background thread? The saved
+      -- variables are copied, so that the filter may proceed while the
+      -- copies are written.
+      asynchronous = false,
+      -- Maximum number of pending writes in asynchronous mode.
+      queue_size = 2
 
    },
 
@@ -129,6 +202,71 @@ for i = 0, ensemble_kalman_filter.Nmember do
 end
 
 
+-- Simulation with assimilation using the local ensemble transform Kalman
+-- filter.
+local_ensemble_transform_kalman_filter = {
+
+   Nmember = 10,
+
+   -- Number of threads sharing the forecast of the members and the local
+   -- analyses (requires OpenMP). Each additional thread creates its own
+   -- instance of the model.
+   Nthread = 1,
+   -- Number of consecutive state components sharing a local analysis.
+   Nstate_batch = 1,
+
+   localization = {
+
+      -- Half-width of the localization function, in the units of the state
+      -- coordinates: only the observations closer than twice this distance
+      -- enter a local analysis.
+      radius = 5.,
+      -- Binary file (Seldon format) storing the coordinates of the state
+      -- components, as a matrix with one row per state component. If empty,
+      -- the coordinate of a state component is its index. The provided file
+      -- stores the coordinates (x, y) of the 100 x 1 cells of the model,
+      -- with x = x_min + i Delta_x and y = y_min + j Delta_y for the state
+      -- component i Ny + j. It should be regenerated if the grid is changed.
+      state_coordinate_file = "configuration/state_coordinate.bin",
+      -- Binary file storing the coordinates of the observations. If empty,
+      -- they are derived from the tangent linear observation operator.
+      observation_coordinate_file = ""
+
+   },
+
+   data_assimilation = {
+
+      analyze_first_step = false,
+
+   },
+
+   display = {
+
+      iteration = false,
+      time = true,
+      analysis_time = true,
+      state_average = true,
+      state_minimum_maximum = false
+   },
+
+   output_saver = {
+
+      variable_list = {"forecast_time", "forecast_state",
+                       "analysis_time", "analysis_state"},
+      file = output_directory .. "letkf-%{name}.%{extension}",
+      time = "step " .. Delta_t_shallow_water * Nskip_save .. " 1.e-6",
+
+   },
+
+   output = {
+
+     configuration = output_directory .. "letkf.lua",
+     log = output_directory .. "letkf.log"
+
+  }
+}
+
+
 -- Forward simulation.
 forward = {
 
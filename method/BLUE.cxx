@@ -74,10 +74,11 @@ namespace Verdandi
                 + (rank - div) * Nlocal_state;
 #endif
 
-        // Temporary matrix and vector.
-        // 'HBHR_inv' will eventually contain the matrix (HBH' + R)^(-1).
-        Matrix<T> HBHR_inv(Nobservation, Nobservation);
-        HBHR_inv.Fill(T(0));
+        // Temporary matrix and vector. Only the upper part of the symmetric
+        // matrix (HBH' + R) is stored; it is overwritten with its Cholesky
+        // factor.
+        Matrix<T, Symmetric, RowSymPacked> HBHR(Nobservation, Nobservation);
+        HBHR.Fill(T(0));
 
         Vector<T> row(Nobservation);
 
@@ -101,29 +102,34 @@ namespace Verdandi
             {
                 H_entry = observation_manager.
                     GetTangentLinearOperator(r, j + global_state_number);
-                for (c = 0; c < Nobservation; c++)
-                    HBHR_inv(r, c) += H_entry * row(c);
+                for (c = r; c < Nobservation; c++)
+                    HBHR(r, c) += H_entry * row(c);
             }
         }
 
 #if defined(VERDANDI_WITH_MPI)
-        Matrix<T> HBHR_recv(Nobservation, Nobservation);
-        MPI_Allreduce(HBHR_inv.GetData(), HBHR_recv.GetData(), Nobservation *
-                      Nobservation, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-        HBHR_inv = HBHR_recv;
+        Matrix<T, Symmetric, RowSymPacked> HBHR_recv(Nobservation,
+                                                     Nobservation);
+        MPI_Allreduce(HBHR.GetData(), HBHR_recv.GetData(),
+                      HBHR.GetDataSize(), MPI_DOUBLE, MPI_SUM,
+                      MPI_COMM_WORLD);
+        HBHR = HBHR_recv;
 #endif
 
         // Computes (HBH' + R).
         for (r = 0; r < Nobservation; r++)
-            for (c = 0; c < Nobservation; c++)
-                HBHR_inv(r, c) += observation_manager.GetErrorVariance(r, c);
+            for (c = r; c < Nobservation; c++)
+                HBHR(r, c) += observation_manager.GetErrorVariance(r, c);
 
-        // Computes (HBH' + R)^{-1}.
-        GetInverse(HBHR_inv);
+        // Computes the Cholesky factorization (HBH' + R) = U'U.
+        SymmetricFactorization<T> HBHR_factorization;
+        HBHR_factorization.Factorize(HBHR);
 
-        // Computes HBHR_inv * innovation.
+        // Computes (HBH' + R)^{-1} * innovation.
         Vector<T> HBHR_inv_innovation(Nobservation);
-        MltAdd(T(1), HBHR_inv, innovation, T(0), HBHR_inv_innovation);
+        for (r = 0; r < Nobservation; r++)
+            HBHR_inv_innovation(r) = innovation(r);
+        HBHR_factorization.Solve(HBHR_inv_innovation);
 
         // Computes new state.
         Vector<T> BHt_row(Nobservation);
@@ -213,10 +219,11 @@ namespace Verdandi
                 + (rank - div) * Nlocal_state;
 #endif
 
-        // Temporary matrix and vector.
-        // 'HBHR_inv' will eventually contain the matrix (HBH' + R)^(-1).
-        Matrix<T> HBHR_inv(Nobservation, Nobservation);
-        HBHR_inv.Fill(T(0));
+        // Temporary matrix and vector. Only the upper part of the symmetric
+        // matrix (HBH' + R) is stored; it is overwritten with its Cholesky
+        // factor.
+        Matrix<T, Symmetric, RowSymPacked> HBHR(Nobservation, Nobservation);
+        HBHR.Fill(T(0));
 
         Vector<T> row(Nobservation);
 
@@ -240,32 +247,39 @@ namespace Verdandi
             {
                 H_entry = observation_manager.
                     GetTangentLinearOperator(r, j + global_state_number);
-                for (c = 0; c < Nobservation; c++)
-                    HBHR_inv(r, c) += H_entry * row(c);
+                for (c = r; c < Nobservation; c++)
+                    HBHR(r, c) += H_entry * row(c);
             }
         }
 
 #if defined(VERDANDI_WITH_MPI)
-        Matrix<T> HBHR_recv(Nobservation, Nobservation);
-        MPI_Allreduce(HBHR_inv.GetData(), HBHR_recv.GetData(), Nobservation *
-                      Nobservation, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-        HBHR_inv = HBHR_recv;
+        Matrix<T, Symmetric, RowSymPacked> HBHR_recv(Nobservation,
+                                                     Nobservation);
+        MPI_Allreduce(HBHR.GetData(), HBHR_recv.GetData(),
+                      HBHR.GetDataSize(), MPI_DOUBLE, MPI_SUM,
+                      MPI_COMM_WORLD);
+        HBHR = HBHR_recv;
 #endif
 
         // Computes (HBH' + R).
         for (r = 0; r < Nobservation; r++)
-            for (c = 0; c < Nobservation; c++)
-                HBHR_inv(r, c) += observation_manager.GetErrorVariance(r, c);
+            for (c = r; c < Nobservation; c++)
+                HBHR(r, c) += observation_manager.GetErrorVariance(r, c);
 
-        // Computes (HBH' + R)^{-1}.
-        GetInverse(HBHR_inv);
+        // Computes the Cholesky factorization (HBH' + R) = U'U.
+        SymmetricFactorization<T> HBHR_factorization;
+        HBHR_factorization.Factorize(HBHR);
 
-        // Computes HBHR_inv * innovation.
+        // Computes (HBH' + R)^{-1} * innovation.
         Vector<T> HBHR_inv_innovation(Nobservation);
-        MltAdd(T(1), HBHR_inv, innovation, T(0), HBHR_inv_innovation);
+        for (r = 0; r < Nobservation; r++)
+            HBHR_inv_innovation(r) = innovation(r);
+        HBHR_factorization.Solve(HBHR_inv_innovation);
 
-        // Intermediate variable to compute the variance diagonal.
-        Vector<T> HBHR_inv_BHt_row(Nobservation);
+        // Intermediate variable to compute the variance diagonal:
+        // U'^{-1} HB(r, :)', whose squared norm is the r-th diagonal element
+        // of BH' (HBH' + R)^{-1} HB.
+        Vector<T> U_inv_BHt_row(Nobservation);
 
         // Computes new state.
         Vector<T> BHt_row(Nobservation);
@@ -295,9 +309,10 @@ namespace Verdandi
 #else
             state(r) += DotProd(BHt_row, HBHR_inv_innovation);
 #endif
-            MltAdd(T(1), HBHR_inv, BHt_row, T(0), HBHR_inv_BHt_row);
+            Copy(BHt_row, U_inv_BHt_row);
+            HBHR_factorization.SolveSquareRoot(U_inv_BHt_row);
             variance(r + global_state_number)
-                -= DotProd(BHt_row, HBHR_inv_BHt_row);
+                -= DotProd(U_inv_BHt_row, U_inv_BHt_row);
         }
 
 #if defined(VERDANDI_WITH_MPI)
@@ -447,13 +462,13 @@ namespace Verdandi
         }
         else
         {
-            // Kalman Gain.
-            MatrixStateObservation K(Nx, Ny);
-            K.Fill(T(0));
+            // Kalman Gain K = BH' (HBH' + R)^{-1}, computed with a Cholesky
+            // factorization of (HBH' + R).
+            SymmetricFactorization<T> HBHR_factorization;
+            HBHR_factorization.Factorize(working_matrix_yy);
 
-            GetInverse(working_matrix_yy);
-
-            MltAdd(T(1), working_matrix_xy, working_matrix_yy, T(0), K);
+            MatrixStateObservation K(working_matrix_xy);
+            HBHR_factorization.SolveRow(K);
 
             MltAdd(T(1), K, innovation, T(1), x);
 
@@ -465,6 +480,370 @@ namespace Verdandi
             innovation.Nullify();
     }
 
+
+    //! Computes BLUE with a dense state error variance.
+    /*! The state error variance is symmetric: only the upper part of \f$HBH^T
+      + R\f$ is computed and the gain is applied through its Cholesky
+      factorization. The variance is updated with a symmetric rank-k
+      update. See ComputeBLUE_symmetric.
+      \param[in,out] B error variance associated with \a state.
+      \param[in] H observation operator.
+      \param[in] cm not used: BH' is always stored in a dense matrix.
+      \param[in] y the vector of observations or innovations.
+      \param[in] R error variance associated with \a observation.
+      \param[in,out] x on entry, the background vector; on exit, the analysis.
+      \param[in] is_y_innovation Boolean to indicate if the parameter \a y is
+      a vector of observations or innovations.
+      \param[in] compute_variance Boolean to indicate if the covariance matrix
+      has to be updated.
+    */
+    template <class T, class Allocator,
+              class ObservationOperator, class MatrixStateObservation,
+              class Observation, class ObservationErrorVariance,
+              class State>
+    void ComputeBLUE_matrix(Matrix<T, General, RowMajor, Allocator>& B,
+                            const ObservationOperator& H,
+                            const MatrixStateObservation& cm,
+                            const Observation& y,
+                            const ObservationErrorVariance& R,
+                            State& x,
+                            bool is_y_innovation,
+                            bool compute_variance)
+    {
+        ComputeBLUE_symmetric(B, H, y, R, x, is_y_innovation,
+                              compute_variance);
+    }
+
+
+    //! Computes BLUE with a state error variance in symmetric packed form.
+    /*! See ComputeBLUE_symmetric.
+      \param[in,out] B error variance associated with \a state.
+      \param[in] H observation operator.
+      \param[in] cm not used: BH' is always stored in a dense matrix.
+      \param[in] y the vector of observations or innovations.
+      \param[in] R error variance associated with \a observation.
+      \param[in,out] x on entry, the background vector; on exit, the analysis.
+      \param[in] is_y_innovation Boolean to indicate if the parameter \a y is
+      a vector of observations or innovations.
+      \param[in] compute_variance Boolean to indicate if the covariance matrix
+      has to be updated.
+    */
+    template <class T, class Allocator,
+              class ObservationOperator, class MatrixStateObservation,
+              class Observation, class ObservationErrorVariance,
+              class State>
+    void ComputeBLUE_matrix(Matrix<T, Symmetric, RowSymPacked, Allocator>& B,
+                            const ObservationOperator& H,
+                            const MatrixStateObservation& cm,
+                            const Observation& y,
+                            const ObservationErrorVariance& R,
+                            State& x,
+                            bool is_y_innovation,
+                            bool compute_variance)
+    {
+        ComputeBLUE_symmetric(B, H, y, R, x, is_y_innovation,
+                              compute_variance);
+    }
+
+
+    //! Computes BLUE with a dense symmetric state error variance.
+    /*! \f$BH^T\f$ and \f$HBH^T\f$ are computed with matrix-matrix
+      products, see ComputeBLUE_product, and \a B may be stored in packed
+      form. Only the upper part of \f$HBH^T + R\f$ is computed.
+      \param[in,out] B error variance associated with \a state.
+      \param[in] H observation operator.
+      \param[in] y the vector of observations or innovations.
+      \param[in] R error variance associated with \a observation.
+      \param[in,out] x on entry, the background vector; on exit, the analysis.
+      \param[in] is_y_innovation Boolean to indicate if the parameter \a y is
+      a vector of observations or innovations.
+      \param[in] compute_variance Boolean to indicate if the covariance matrix
+      has to be updated.
+    */
+    template <class StateErrorVariance, class ObservationOperator,
+              class Observation, class ObservationErrorVariance,
+              class State>
+    void ComputeBLUE_symmetric(StateErrorVariance& B,
+                               const ObservationOperator& H,
+                               const Observation& y,
+                               const ObservationErrorVariance& R,
+                               State& x,
+                               bool is_y_innovation,
+                               bool compute_variance)
+    {
+        typedef typename State::value_type T;
+
+        int Ny = y.GetLength();
+        int Nx = x.GetLength();
+
+        if (B.GetM() != Nx || B.GetN() != Nx)
+            throw ErrorArgument("ComputeBLUE_symmetric",
+                                "The state error variance has "
+                                "dimensions " + to_str(B.GetM())
+                                + " x " + to_str(B.GetN())
+                                + " while the state vector has "
+                                + to_str(Nx) + " elements.");
+
+        if (H.GetN() != Nx)
+            throw ErrorArgument("ComputeBLUE_symmetric",
+                                "The observation operator has "
+                                + to_str(H.GetN()) + " columns "
+                                "while the state vector has "
+                                + to_str(Nx) + " elements.");
+
+        if (H.GetM() != Ny)
+            throw ErrorArgument("ComputeBLUE_symmetric",
+                                "The observation operator has "
+                                + to_str(H.GetM()) + " rows "
+                                "while the observation vector has "
+                                + to_str(Ny) + " elements.");
+
+        if (R.GetM() != Ny || R.GetN() != Ny)
+            throw ErrorArgument("ComputeBLUE_symmetric",
+                                "The observation error variance has "
+                                "dimensions " + to_str(R.GetM())
+                                + " x " + to_str(R.GetN())
+                                + " while the observation vector has "
+                                + to_str(Ny) + " elements.");
+
+        if (Ny == 0) // No observations.
+            return;
+
+        // Innovation.
+        Observation innovation;
+        if (is_y_innovation)
+            innovation.SetData(y);
+        else
+        {
+            innovation = y;
+            MltAdd(T(-1), H, x, T(1), innovation);
+        }
+
+        // Computes BH' and the upper part of (HBH' + R).
+        Matrix<T> BHt(Nx, Ny);
+        Matrix<T, Symmetric, RowSymPacked> HBHR(Ny, Ny);
+        ComputeBLUE_product(B, H, BHt, HBHR);
+        AddUpperPart(T(1), R, HBHR);
+
+        ComputeBLUE_Cholesky(BHt, HBHR, innovation, x, B, compute_variance);
+
+        if (is_y_innovation)
+            innovation.Nullify();
+    }
+
+
+    //! Computes \f$BH^T\f$ and \f$HBH^T\f$ for any observation operator.
+    /*! The observation operator is copied into a dense matrix, since its
+      storage is unknown.
+      \param[in] B a symmetric matrix.
+      \param[in] H observation operator.
+      \param[out] BHt the matrix \f$BH^T\f$.
+      \param[out] HBHt the upper part of \f$HBH^T\f$.
+    */
+    template <class StateErrorVariance, class ObservationOperator,
+              class T, class Allocator0, class Allocator1>
+    void ComputeBLUE_product(StateErrorVariance& B,
+                             const ObservationOperator& H,
+                             Matrix<T, General, RowMajor, Allocator0>& BHt,
+                             Matrix<T, Symmetric, RowSymPacked, Allocator1>&
+                             HBHt)
+    {
+        int Ny = H.GetM();
+        Matrix<T> H_dense(Ny, H.GetN());
+        Vector<T> H_row;
+        for (int i = 0; i < Ny; i++)
+        {
+            GetRow(H, i, H_row);
+            SetRow(H_row, i, H_dense);
+        }
+
+        ComputeBLUE_product(B, H_dense, BHt, HBHt);
+    }
+
+
+    //! Computes \f$BH^T\f$ and \f$HBH^T\f$ for a dense observation operator.
+    /*!
+      \param[in] B a symmetric matrix.
+      \param[in] H observation operator.
+      \param[out] BHt the matrix \f$BH^T\f$.
+      \param[out] HBHt the upper part of \f$HBH^T\f$.
+    */
+    template <class StateErrorVariance, class T0, class Allocator0,
+              class T, class Allocator1, class Allocator2>
+    void ComputeBLUE_product(StateErrorVariance& B,
+                             const Matrix<T0, General, RowMajor, Allocator0>&
+                             H,
+                             Matrix<T, General, RowMajor, Allocator1>& BHt,
+                             Matrix<T, Symmetric, RowSymPacked, Allocator2>&
+                             HBHt)
+    {
+        int Ny = H.GetM();
+
+        MltTransposeObservationOperator(B, H, BHt);
+
+        Matrix<T, General, RowMajor, Allocator1> HBHt_dense(Ny, Ny);
+        MltAdd(T(1), H, BHt, T(0), HBHt_dense);
+        for (int i = 0; i < Ny; i++)
+            for (int j = i; j < Ny; j++)
+                HBHt(i, j) = HBHt_dense(i, j);
+    }
+
+
+    //! Computes \f$BH^T\f$ and \f$HBH^T\f$ for a sparse observation operator.
+    /*! Only the non-zero entries of \a H are read.
+      \param[in] B a symmetric matrix.
+      \param[in] H observation operator.
+      \param[out] BHt the matrix \f$BH^T\f$.
+      \param[out] HBHt the upper part of \f$HBH^T\f$.
+    */
+    template <class StateErrorVariance, class T0, class Allocator0,
+              class T, class Allocator1, class Allocator2>
+    void ComputeBLUE_product(StateErrorVariance& B,
+                             const Matrix<T0, General, RowSparse, Allocator0>&
+                             H,
+                             Matrix<T, General, RowMajor, Allocator1>& BHt,
+                             Matrix<T, Symmetric, RowSymPacked, Allocator2>&
+                             HBHt)
+    {
+        int Nx = H.GetN();
+        int Ny = H.GetM();
+        const int* ptr = H.GetPtr();
+        const int* ind = H.GetInd();
+        const T0* data = H.GetData();
+
+        // BH'(:, i) is the combination of the columns of B, that is, of its
+        // rows, with the coefficients of the row i of H.
+        BHt.Zero();
+        for (int i = 0; i < Ny; i++)
+            for (int l = ptr[i]; l < ptr[i + 1]; l++)
+                for (int k = 0; k < Nx; k++)
+                    BHt(k, i) += data[l] * B(ind[l], k);
+
+        for (int i = 0; i < Ny; i++)
+            for (int j = i; j < Ny; j++)
+            {
+                T sum = T(0);
+                for (int l = ptr[i]; l < ptr[i + 1]; l++)
+                    sum += data[l] * BHt(ind[l], j);
+                HBHt(i, j) = sum;
+            }
+    }
+
+
+    //! Computes \f$BH^T\f$ for a dense state error variance.
+    /*! It is a single matrix-matrix product.
+      \param[in] B a symmetric matrix.
+      \param[in] H a dense observation operator.
+      \param[out] BHt the matrix \f$BH^T\f$.
+    */
+    template <class T0, class Allocator0, class T1, class Allocator1,
+              class T, class Allocator2>
+    void MltTransposeObservationOperator(const Matrix<T0, General, RowMajor,
+                                         Allocator0>& B,
+                                         const Matrix<T1, General, RowMajor,
+                                         Allocator1>& H,
+                                         Matrix<T, General, RowMajor,
+                                         Allocator2>& BHt)
+    {
+        MltAdd(T(1), SeldonNoTrans, B, SeldonTrans, H, T(0), BHt);
+    }
+
+
+    //! Computes \f$BH^T\f$ for a state error variance in any storage.
+    /*! The rows of \a B are copied by blocks into a dense matrix, and each
+      block of rows of \f$BH^T\f$ is computed with a matrix-matrix product.
+      \param[in] B a symmetric matrix.
+      \param[in] H a dense observation operator.
+      \param[out] BHt the matrix \f$BH^T\f$.
+    */
+    template <class StateErrorVariance, class T1, class Allocator1,
+              class T, class Allocator2>
+    void MltTransposeObservationOperator(const StateErrorVariance& B,
+                                         const Matrix<T1, General, RowMajor,
+                                         Allocator1>& H,
+                                         Matrix<T, General, RowMajor,
+                                         Allocator2>& BHt)
+    {
+        int Nx = B.GetM();
+        int Ny = H.GetM();
+
+        // Number of rows of B copied at once.
+        const int Nblock = 64;
+
+        Matrix<T, General, RowMajor, Allocator2> B_block, BHt_block;
+        for (int first = 0; first < Nx; first += Nblock)
+        {
+            int Nrow = min(Nblock, Nx - first);
+            B_block.Reallocate(Nrow, Nx);
+            for (int i = 0; i < Nrow; i++)
+                for (int j = 0; j < Nx; j++)
+                    B_block(i, j) = B(first + i, j);
+
+            BHt_block.SetData(Nrow, Ny, BHt.GetData() + first * Ny);
+            MltAdd(T(1), SeldonNoTrans, B_block, SeldonTrans, H, T(0),
+                   BHt_block);
+            BHt_block.Nullify();
+        }
+    }
+
+
+    //! Applies the Kalman gain through a Cholesky factorization.
+    /*! With \f$S = U^T U\f$, the analysis is \f$x^a = x^f + BH^T U^{-1}
+      U^{-T} d\f$ and the variance update is \f$B^a = B - W W^T\f$ where
+      \f$W = BH^T U^{-1}\f$. \a B is updated with a symmetric rank-k
+      update, which only computes its upper part.
+      \param[in,out] BHt on entry, the matrix \f$BH^T\f$; on exit, \f$W\f$
+      if \a compute_variance is true.
+      \param[in] S the matrix \f$HBH^T + R\f$.
+      \param[in] innovation the innovation vector \f$d\f$.
+      \param[in,out] x on entry, the background vector; on exit, the analysis.
+      \param[in,out] B the state error variance, updated if \a
+      compute_variance is true.
+      \param[in] compute_variance Boolean to indicate if the covariance matrix
+      has to be updated.
+    */
+    template <class T, class Allocator0, class Allocator1,
+              class Innovation, class State, class StateErrorVariance>
+    void ComputeBLUE_Cholesky(Matrix<T, General, RowMajor, Allocator0>& BHt,
+                              const Matrix<T, Symmetric, RowSymPacked,
+                              Allocator1>& S,
+                              const Innovation& innovation, State& x,
+                              StateErrorVariance& B, bool compute_variance)
+    {
+        int Nx = BHt.GetM();
+        int Ny = BHt.GetN();
+
+        SymmetricFactorization<T> S_factorization;
+        S_factorization.Factorize(S);
+
+        Vector<T> z(Ny);
+        for (int i = 0; i < Ny; i++)
+            z(i) = innovation(i);
+
+        if (!compute_variance)
+        {
+            S_factorization.Solve(z);
+            MltAdd(T(1), BHt, z, T(1), x);
+            return;
+        }
+
+        // Computes U'^{-1} * innovation.
+        S_factorization.SolveSquareRoot(z);
+
+        // Computes W = BH' U^{-1}, row by row: U' W(i, :)' = BH'(i, :)'.
+        Vector<T, VectFull, Allocator0> row;
+        for (int i = 0; i < Nx; i++)
+        {
+            row.SetData(Ny, BHt.GetData() + i * Ny);
+            S_factorization.SolveSquareRoot(row);
+            row.Nullify();
+        }
+
+        MltAdd(T(1), BHt, z, T(1), x);
+
+        RankKUpdate(T(-1), BHt, B);
+    }
+
 } // namespace Verdandi.
 
 
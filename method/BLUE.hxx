@@ -68,6 +68,103 @@ namespace Verdandi
                             bool compute_variance = false);
 
 
+
+    template <class T, class Allocator,
+              class ObservationOperator, class MatrixStateObservation,
+              class Observation, class ObservationErrorVariance,
+              class State>
+    void ComputeBLUE_matrix(Matrix<T, General, RowMajor, Allocator>& B,
+                            const ObservationOperator& H,
+                            const MatrixStateObservation& cm,
+                            const Observation& y,
+                            const ObservationErrorVariance& R,
+                            State& x,
+                            bool is_y_innovation = false,
+                            bool compute_variance = false);
+
+
+    template <class T, class Allocator,
+              class ObservationOperator, class MatrixStateObservation,
+              class Observation, class ObservationErrorVariance,
+              class State>
+    void ComputeBLUE_matrix(Matrix<T, Symmetric, RowSymPacked, Allocator>& B,
+                            const ObservationOperator& H,
+                            const MatrixStateObservation& cm,
+                            const Observation& y,
+                            const ObservationErrorVariance& R,
+                            State& x,
+                            bool is_y_innovation = false,
+                            bool compute_variance = false);
+
+
+    template <class StateErrorVariance, class ObservationOperator,
+              class Observation, class ObservationErrorVariance,
+              class State>
+    void ComputeBLUE_symmetric(StateErrorVariance& B,
+                               const ObservationOperator& H,
+                               const Observation& y,
+                               const ObservationErrorVariance& R,
+                               State& x,
+                               bool is_y_innovation = false,
+                               bool compute_variance = false);
+
+
+    template <class StateErrorVariance, class ObservationOperator,
+              class T, class Allocator0, class Allocator1>
+    void ComputeBLUE_product(StateErrorVariance& B,
+                             const ObservationOperator& H,
+                             Matrix<T, General, RowMajor, Allocator0>& BHt,
+                             Matrix<T, Symmetric, RowSymPacked, Allocator1>&
+                             HBHt);
+
+
+    template <class StateErrorVariance, class T0, class Allocator0,
+              class T, class Allocator1, class Allocator2>
+    void ComputeBLUE_product(StateErrorVariance& B,
+                             const Matrix<T0, General, RowMajor, Allocator0>&
+                             H,
+                             Matrix<T, General, RowMajor, Allocator1>& BHt,
+                             Matrix<T, Symmetric, RowSymPacked, Allocator2>&
+                             HBHt);
+
+
+    template <class StateErrorVariance, class T0, class Allocator0,
+              class T, class Allocator1, class Allocator2>
+    void ComputeBLUE_product(StateErrorVariance& B,
+                             const Matrix<T0, General, RowSparse, Allocator0>&
+                             H,
+                             Matrix<T, General, RowMajor, Allocator1>& BHt,
+                             Matrix<T, Symmetric, RowSymPacked, Allocator2>&
+                             HBHt);
+
+
+    template <class T0, class Allocator0, class T1, class Allocator1,
+              class T, class Allocator2>
+    void MltTransposeObservationOperator(const Matrix<T0, General, RowMajor,
+                                         Allocator0>& B,
+                                         const Matrix<T1, General, RowMajor,
+                                         Allocator1>& H,
+                                         Matrix<T, General, RowMajor,
+                                         Allocator2>& BHt);
+
+
+    template <class StateErrorVariance, class T1, class Allocator1,
+              class T, class Allocator2>
+    void MltTransposeObservationOperator(const StateErrorVariance& B,
+                                         const Matrix<T1, General, RowMajor,
+                                         Allocator1>& H,
+                                         Matrix<T, General, RowMajor,
+                                         Allocator2>& BHt);
+
+
+    template <class T, class Allocator0, class Allocator1,
+              class Innovation, class State, class StateErrorVariance>
+    void ComputeBLUE_Cholesky(Matrix<T, General, RowMajor, Allocator0>& BHt,
+                              const Matrix<T, Symmetric, RowSymPacked,
+                              Allocator1>& S,
+                              const Innovation& innovation, State& x,
+                              StateErrorVariance& B, bool compute_variance);
+
 } // namespace Verdandi.
 
 
@@ -657,6 +657,58 @@ namespace Verdandi
         }
     }
 
+
+    //! Writes the state of a random number generator in a binary stream.
+    /*! The generator is written in its text representation, preceded by the
+      length of this representation.
+      \param[in] generator the random number generator, or any object with
+      the stream operator '<<'.
+      \param[in,out] stream the output stream.
+    */
+    template <class Derived>
+    template <class Generator>
+    void BasePerturbationManager<Derived>
+    ::WriteGeneratorState(const Generator& generator, ostream& stream) const
+    {
+        ostringstream output;
+        output << generator;
+        string state = output.str();
+        int length = int(state.size());
+        stream.write(reinterpret_cast<char*>(&length), sizeof(int));
+        stream.write(state.c_str(), length);
+    }
+
+
+    //! Reads the state of a random number generator from a binary stream.
+    /*!
+      \param[in,out] stream the input stream, as written by
+      'WriteGeneratorState'.
+      \param[out] generator the random number generator, or any object with
+      the stream operator '>>'.
+    */
+    template <class Derived>
+    template <class Generator>
+    void BasePerturbationManager<Derived>
+    ::ReadGeneratorState(istream& stream, Generator& generator) const
+    {
+        int length;
+        stream.read(reinterpret_cast<char*>(&length), sizeof(int));
+        if (!stream || length < 0)
+            throw ErrorIO("BasePerturbationManager::ReadGeneratorState",
+                          "Unable to read the state of the random number "
+                          "generator.");
+        string state(length, ' ');
+        if (length > 0)
+            stream.read(&state[0], length);
+        istringstream input(state);
+        input >> generator;
+        if (!stream || input.fail())
+            throw ErrorIO("BasePerturbationManager::ReadGeneratorState",
+                          "Unable to read the state of the random number "
+                          "generator.");
+    }
+
+
 } // namespace Verdandi.
 
 
@@ -79,6 +79,14 @@ namespace Verdandi
                     Vector<double, VectFull>& correlation,
                     Vector<T1, Collection, Allocator1>& output);
 
+    protected:
+
+        template <class Generator>
+        void WriteGeneratorState(const Generator& generator,
+                                 ostream& stream) const;
+        template <class Generator>
+        void ReadGeneratorState(istream& stream, Generator& generator) const;
+
     };
 
 
@@ -39,7 +39,9 @@ namespace Verdandi
     template <class Model, class ObservationManager,
               class PerturbationManager>
     EnsembleKalmanFilter<Model, ObservationManager, PerturbationManager>
-    ::EnsembleKalmanFilter(): iteration_(-1)
+    ::EnsembleKalmanFilter(): iteration_(-1), Nthread_(1),
+                              configuration_prefix_("ensemble_kalman_filter."),
+                              adaptive_inflation_(1.), checkpoint_period_(1)
     {
 
         /*** Initializations ***/
@@ -68,6 +70,8 @@ namespace Verdandi
     EnsembleKalmanFilter<Model, ObservationManager, PerturbationManager>
     ::~EnsembleKalmanFilter()
     {
+        for (size_t t = 0; t < model_clone_.size(); t++)
+            delete model_clone_[t];
 #if defined(VERDANDI_WITH_MPI)
         int finalized;
         MPI_Finalized(&finalized);
@@ -140,7 +144,7 @@ namespace Verdandi
         MessageHandler::Send(*this, "all", "::Initialize begin");
 
         configuration_file_ = configuration.GetFilePath();
-        configuration.SetPrefix("ensemble_kalman_filter.");
+        configuration.SetPrefix(configuration_prefix_);
 
         iteration_ = 0;
 
@@ -181,6 +185,9 @@ namespace Verdandi
         // Should the state minimum and maximum be displayed on screen?
         configuration.Set("display.state_minimum_maximum",
                           option_display_["state_minimum_maximum"]);
+        // Should the inflation factors be displayed on screen?
+        configuration.Set("display.inflation", "", false,
+                          option_display_["inflation"]);
 
         /*** Assimilation options ***/
 
@@ -204,9 +211,19 @@ namespace Verdandi
                 + (rank_ - div) * Nlocal_member_;
 #endif
 
+        // Number of threads that share the forecast of the local members.
+        configuration.Set("Nthread", "v >= 1", 1, Nthread_);
+#ifndef _OPENMP
+        if (Nthread_ > 1)
+            throw ErrorConfiguration("EnsembleKalmanFilter::Initialize",
+                                     "The forecast is requested on "
+                                     + to_str(Nthread_) + " threads, but "
+                                     "Verdandi was compiled without OpenMP.");
+#endif
+
         /*** Logger and read configuration ***/
 
-        configuration.SetPrefix("ensemble_kalman_filter.");
+        configuration.SetPrefix(configuration_prefix_);
 
         if (configuration.Exists("output.log"))
             Logger::SetFileName(configuration.Get<string>("output.log"));
@@ -225,6 +242,26 @@ namespace Verdandi
         if (initialize_model)
             model_.Initialize(model_configuration_file_);
 
+        // The additional threads forecast their members with their own
+        // instances of the model, which can only be initialized like
+        // 'model_' if the driver initializes it.
+        for (size_t t = 0; t < model_clone_.size(); t++)
+            delete model_clone_[t];
+        model_clone_.clear();
+        if (min(Nthread_, Nlocal_member_) > 1 && !initialize_model)
+            throw ErrorConfiguration("EnsembleKalmanFilter::Initialize",
+                                     "The model copies used by the "
+                                     "additional threads are initialized "
+                                     "with \"model.configuration_file\", so "
+                                     "that the model should also be "
+                                     "initialized by the driver when "
+                                     "\"Nthread\" is greater than 1.");
+        for (int t = 1; t < min(Nthread_, Nlocal_member_); t++)
+        {
+            model_clone_.push_back(new Model);
+            model_clone_.back()->Initialize(model_configuration_file_);
+        }
+
         MessageHandler::Send(*this, "model", "initial condition");
         MessageHandler::Send(*this, "driver", "initial condition");
 
@@ -236,11 +273,19 @@ namespace Verdandi
             observation_manager_.Initialize(model_,
                                             observation_configuration_file_);
 
-        configuration.SetPrefix("ensemble_kalman_filter.");
+        configuration.SetPrefix(configuration_prefix_);
 
-        configuration.Set("observation_tangent_linear_operator_access",
-                          "ops_in(v, {'element', 'matrix'})",
-                          observation_tangent_linear_operator_access_);
+        InitializeAnalysis(configuration);
+
+        /*** Checkpoint ***/
+
+        configuration.Set("checkpoint.file", "", string(""),
+                          checkpoint_file_);
+        if (!checkpoint_file_.empty())
+            configuration.Set("checkpoint.period", "v >= 1", 1,
+                              checkpoint_period_);
+        configuration.Set("checkpoint.restart_file", "", string(""),
+                          restart_file_);
 
 #ifdef VERDANDI_WITH_MPI
         if (rank_ == 0)
@@ -263,25 +308,29 @@ namespace Verdandi
 
         /*** Ouput saver ***/
 
-        configuration.SetPrefix("ensemble_kalman_filter.output_saver.");
+        configuration.SetPrefix(configuration_prefix_ + "output_saver.");
         output_saver_.Initialize(configuration);
 
-        output_saver_.Empty("forecast_time");
-        output_saver_.Empty("forecast_state");
-        output_saver_.Empty("analysis_time");
-        output_saver_.Empty("analysis_state");
-        for (int k = 0; k < Nlocal_member_; k++)
-            for (int p = 0; p < model_.GetNparameter(); p++)
-                output_saver_.Empty("perturbation-"
-                                    + to_str(k + first_member_index_)
-                                    + "-" + to_str(p));
-
-        for (int k = 0; k < Nlocal_member_; k++)
+        // After a restart, the outputs of the former run are completed.
+        if (restart_file_.empty())
         {
-            output_saver_.Empty("forecast_state-"
-                                + to_str(k + first_member_index_));
-            output_saver_.Empty("analysis_state-"
-                                + to_str(k + first_member_index_));
+            output_saver_.Empty("forecast_time");
+            output_saver_.Empty("forecast_state");
+            output_saver_.Empty("analysis_time");
+            output_saver_.Empty("analysis_state");
+            for (int k = 0; k < Nlocal_member_; k++)
+                for (int p = 0; p < model_.GetNparameter(); p++)
+                    output_saver_.Empty("perturbation-"
+                                        + to_str(k + first_member_index_)
+                                        + "-" + to_str(p));
+
+            for (int k = 0; k < Nlocal_member_; k++)
+            {
+                output_saver_.Empty("forecast_state-"
+                                    + to_str(k + first_member_index_));
+                output_saver_.Empty("analysis_state-"
+                                    + to_str(k + first_member_index_));
+            }
         }
 
         /*** Ensemble initialization ***/
@@ -290,8 +339,8 @@ namespace Verdandi
         Nstate_ = model_.GetNstate();
         Nfull_state_ = model_.GetNfull_state();
         Nparameter_ = model_.GetNparameter();
-        ensemble_full_.resize(Nlocal_member_);
-        ensemble_.resize(Nlocal_member_);
+        ensemble_full_.Reallocate(Nlocal_member_, Nfull_state_);
+        ensemble_.Reallocate(Nlocal_member_, Nstate_);
         parameter_.resize(Nparameter_);
         for (int p = 0; p < Nparameter_; p++)
             parameter_[p].resize(Nmember_);
@@ -302,16 +351,21 @@ namespace Verdandi
 
         for (int m = 0; m < Nlocal_member_; m++)
         {
-            ensemble_full_[m] = model_.GetFullState();
-            ensemble_[m] = model_.GetState();
+            SetRow(model_.GetFullState(), m, ensemble_full_);
+            SetRow(model_.GetState(), m, ensemble_);
         }
 
-        InitializeEnsemble();
-
         /*** Assimilation ***/
 
-        if (analyze_first_step_)
-            Analyze();
+        if (restart_file_.empty())
+        {
+            InitializeEnsemble();
+            if (analyze_first_step_)
+                Analyze();
+        }
+        else
+            // The checkpoint already holds an analyzed ensemble.
+            ReadCheckpoint(restart_file_);
 
         perturbation_manager_.Finalize();
 
@@ -319,6 +373,122 @@ namespace Verdandi
     }
 
 
+    //! Reads the configuration of the analysis.
+    /*! It is called by Initialize, once the model and the observation manager
+      are initialized, with the prefix of the method set in \a
+      configuration.
+      \param[in] configuration configuration for the method.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    void EnsembleKalmanFilter<Model, ObservationManager, PerturbationManager>
+    ::InitializeAnalysis(VerdandiOps& configuration)
+    {
+        configuration.Set("observation_tangent_linear_operator_access",
+                          "ops_in(v, {'element', 'matrix'})",
+                          observation_tangent_linear_operator_access_);
+        configuration.Set("analysis_space",
+                          "ops_in(v, {'observation', 'ensemble'})",
+                          string("observation"), analysis_space_);
+        configuration.Set("square_root", "ops_in(v, {'none', 'ETKF', 'EAKF'})",
+                          string("none"), square_root_);
+
+        /*** Localization ***/
+
+        configuration.Set("localization.type",
+                          "ops_in(v, {'none', 'Gaspari-Cohn'})",
+                          string("none"), localization_type_);
+        if (localization_type_ != "none")
+        {
+            configuration.Set("localization.radius", "v > 0",
+                              localization_radius_);
+            state_coordinate_
+                .Read(configuration
+                      .Get<string>("localization.state_coordinate_file"));
+            if (state_coordinate_.GetM() != model_.GetNstate())
+                throw ErrorConfiguration("EnsembleKalmanFilter::Initialize",
+                                         "The localization requires the "
+                                         "coordinates of "
+                                         + to_str(model_.GetNstate())
+                                         + " state components, but "
+                                         + to_str(state_coordinate_.GetM())
+                                         + " were provided.");
+            configuration.Set("localization.observation_coordinate_file", "",
+                              string(""), observation_coordinate_file_);
+            if (!observation_coordinate_file_.empty())
+                observation_coordinate_.Read(observation_coordinate_file_);
+            if (analysis_space_ == "ensemble")
+                throw ErrorConfiguration("EnsembleKalmanFilter::Initialize",
+                                         "The localization cannot be "
+                                         "applied with an analysis in the "
+                                         "ensemble space.");
+            if (square_root_ != "none")
+                throw ErrorConfiguration("EnsembleKalmanFilter::Initialize",
+                                         "The localization cannot be "
+                                         "applied with a square root "
+                                         "analysis.");
+        }
+
+        /*** Inflation ***/
+
+        configuration.Set("inflation.type",
+                          "ops_in(v, {'none', 'multiplicative', 'RTPS', "
+                          "'adaptive'})", string("none"), inflation_type_);
+        if (inflation_type_ != "none")
+        {
+            string factor_file;
+            configuration.Set("inflation.factor_file", "", string(""),
+                              factor_file);
+            if (factor_file.empty())
+            {
+                double factor;
+                if (inflation_type_ == "multiplicative")
+                    configuration.Set("inflation.factor", "v >= 1", factor);
+                else if (inflation_type_ == "RTPS")
+                    configuration.Set("inflation.factor", "v >= 0", factor);
+                else // "adaptive".
+                    configuration.Set("inflation.factor", "v >= 0", 1.,
+                                      factor);
+                inflation_factor_.Reallocate(model_.GetNstate());
+                inflation_factor_.Fill(factor);
+            }
+            else
+            {
+                inflation_factor_.Read(factor_file);
+                if (inflation_factor_.GetM() != int(model_.GetNstate()))
+                    throw ErrorConfiguration("EnsembleKalmanFilter"
+                                             "::Initialize", "The inflation "
+                                             "requires the coefficients of "
+                                             + to_str(model_.GetNstate())
+                                             + " state components, but "
+                                             + to_str(inflation_factor_
+                                                      .GetM())
+                                             + " were provided.");
+                for (int k = 0; k < inflation_factor_.GetM(); k++)
+                    if (inflation_factor_(k) < 0.
+                        || (inflation_type_ == "multiplicative"
+                            && inflation_factor_(k) < 1.))
+                        throw ErrorConfiguration("EnsembleKalmanFilter"
+                                                 "::Initialize",
+                                                 "The inflation coefficient "
+                                                 "of state component "
+                                                 + to_str(k) + " is "
+                                                 + to_str(inflation_factor_
+                                                          (k)) + ".");
+            }
+            if (inflation_type_ == "adaptive")
+            {
+                configuration.Set("inflation.minimum", "v > 0", 1.,
+                                  inflation_minimum_);
+                configuration.Set("inflation.maximum",
+                                  "v >= " + to_str(inflation_minimum_), 2.,
+                                  inflation_maximum_);
+                adaptive_inflation_ = inflation_minimum_;
+            }
+        }
+    }
+
+
     //! Initialization of the perturbations.
     /*! \brief The perturbations of the parameters are generated independently
       for each member.
@@ -574,26 +744,41 @@ namespace Verdandi
         for (int i = 0; i < Nparameter_; i++)
             reference_parameter.push_back(model_.GetParameter(i));
 
-        for (int m = 0; m < Nlocal_member_; m++)
+        int Nworker = int(model_clone_.size()) + 1;
+        if (Nworker == 1)
+            PropagateMember(model_, 0, Nlocal_member_);
+        else
         {
-            for (int i = 0; i < Nparameter_; i++)
+            // The local members are split into contiguous slices, one per
+            // thread. The master thread keeps the first slice so that
+            // 'model_' ends at the forecast time, as in the sequential case.
+            exception_ptr error;
+#pragma omp parallel for num_threads(Nworker) schedule(static, 1)
+            for (int t = 0; t < Nworker; t++)
             {
-                model_.GetParameter(i)
-                    .Copy(parameter_[i][m + first_member_index_]);
-                model_.ParameterUpdated(i);
-            }
-            model_.GetFullState() = ensemble_full_[m];
-            model_.FullStateUpdated();
-
-            model_.Forward();
-
-            ensemble_full_[m] = model_.GetFullState();
-
-            if (m < Nlocal_member_ - 1)
-            {
-                model_.SetTime(time_);
-                model_.InitializeStep();
+                try
+                {
+                    int first = t * Nlocal_member_ / Nworker;
+                    int last = (t + 1) * Nlocal_member_ / Nworker;
+                    if (t == 0)
+                        PropagateMember(model_, first, last);
+                    else
+                    {
+                        Model& model = *model_clone_[t - 1];
+                        model.SetTime(time_);
+                        model.InitializeStep();
+                        PropagateMember(model, first, last);
+                    }
+                }
+                catch (...)
+                {
+#pragma omp critical(verdandi_enkf_prediction)
+                    if (!error)
+                        error = current_exception();
+                }
             }
+            if (error)
+                rethrow_exception(error);
         }
 
         model_state mean_state_vector(model_.GetNstate());
@@ -601,7 +786,7 @@ namespace Verdandi
         mean_state_vector = 0.;
         for (int m = 0; m < Nlocal_member_; m++)
         {
-            model_.GetFullState() = ensemble_full_[m];
+            GetRow(ensemble_full_, m, model_.GetFullState());
             model_.FullStateUpdated();
             Add(Ts(1), model_.GetState(), mean_state_vector);
         }
@@ -704,145 +889,368 @@ namespace Verdandi
             }
 #endif
 
-            observation& obs = observation_manager_.GetObservation();
-            Nobservation_ = obs.GetLength();
+            AnalyzeEnsemble();
+            ComputeAnalysisMean();
 
-            model_state mean_state_vector(model_.GetNstate());
-            // Sets state to ensemble mean.
-            mean_state_vector = model_.GetState();
+            MessageHandler::Send(*this, "model", "analysis");
+            MessageHandler::Send(*this, "observation_manager", "analysis");
+            MessageHandler::Send(*this, "driver", "analysis");
+        }
 
-            // Computes the innovation vectors d = y - Hx where H is the
-            // observation operator.
-            Matrix<To> innovation_matrix(Nobservation_, Nlocal_member_);
-            observation Hx(Nobservation_);
-            model_state state(Nstate_);
-            for (int m = 0; m < Nlocal_member_; m++)
-            {
-                model_.GetFullState() = ensemble_full_[m];
-                model_.FullStateUpdated();
-                ensemble_[m] = model_.GetState();
-                observation_manager_.ApplyOperator(model_.GetState(), Hx);
-                Mlt(To(-1), Hx);
-                Add(To(1), obs, Hx);
-                SetCol(Hx, m, innovation_matrix);
-            }
+        MessageHandler::Send(*this, "all", "::Analyze end");
+    }
 
-            // Constructs the square root of the empirical variance.
-            Matrix<Ts> L(Nstate_, Nlocal_member_);
-            for (int l = 0; l < Nlocal_member_; l++)
-                for (size_t k = 0; k < Nstate_; k++)
-                    L(k, l) = Ts(1) / sqrt(Ts(Nmember_ - 1))
-                        * (ensemble_[l](k) - mean_state_vector(k));
 
-            // Computes H times L.
-            Matrix<To> HL(Nobservation_, Nlocal_member_);
+    //! Updates the local members with the observations.
+    /*! The observation manager is set at the current time, where some
+      observations are available. On entry, the model state is the forecast
+      ensemble mean. On exit, 'ensemble_' contains the analyzed local
+      members.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    void EnsembleKalmanFilter<Model, ObservationManager,
+                              PerturbationManager>::AnalyzeEnsemble()
+    {
+        observation& obs = observation_manager_.GetObservation();
+        Nobservation_ = obs.GetLength();
+
+        model_state mean_state_vector(model_.GetNstate());
+        // Sets state to ensemble mean.
+        mean_state_vector = model_.GetState();
 
-            if (observation_tangent_linear_operator_access_ == "matrix")
-                MltAdd(To(1), observation_manager_.GetTangentLinearOperator(),
-                       L, To(0), HL);
-            else // "element".
+        // Computes the innovation vectors d = y - Hx where H is the
+        // observation operator.
+        Matrix<To> innovation_matrix(Nobservation_, Nlocal_member_);
+        observation Hx(Nobservation_);
+        model_state state(Nstate_);
+        for (int m = 0; m < Nlocal_member_; m++)
+        {
+            GetRow(ensemble_full_, m, model_.GetFullState());
+            model_.FullStateUpdated();
+            SetRow(model_.GetState(), m, ensemble_);
+            observation_manager_.ApplyOperator(model_.GetState(), Hx);
+            Mlt(To(-1), Hx);
+            Add(To(1), obs, Hx);
+            SetCol(Hx, m, innovation_matrix);
+        }
+
+        if (inflation_type_ == "multiplicative"
+            || inflation_type_ == "adaptive")
+        {
+            // Covariance inflation factor of every state component.
+            Vector<double> factor(inflation_factor_);
+            if (inflation_type_ == "adaptive")
             {
-                HL.Fill(To(0));
-                for (size_t i = 0; i < Nobservation_; i++)
-                    for (int j = 0; j < Nmember_; j++)
-                        for (size_t k = 0; k < Nstate_; k++)
-                            HL(i, j) +=
-                                observation_manager_.
-                                GetTangentLinearOperator(i, k) *
-                                L(k, j);
+                adaptive_inflation_
+                    = ComputeAdaptiveInflation(innovation_matrix);
+                LogInflation("Adaptive inflation factor: "
+                             + to_str(adaptive_inflation_));
+                for (size_t k = 0; k < Nstate_; k++)
+                    factor(k) = 1. + inflation_factor_(k)
+                        * (adaptive_inflation_ - 1.);
+            }
+            else
+            {
+                double average = 0.;
+                for (size_t k = 0; k < Nstate_; k++)
+                    average += factor(k);
+                LogInflation("Multiplicative inflation factor "
+                             "(average): "
+                             + to_str(average / double(Nstate_)));
             }
 
-            // Reads R.
-            Matrix<To> working_matrix(Nobservation_,Nobservation_);
-            working_matrix = observation_manager_.GetErrorVariance();
+            // Inflates the deviations from the mean, and updates the
+            // innovations accordingly.
+            Vector<Ts> member;
+            for (int m = 0; m < Nlocal_member_; m++)
+            {
+                for (size_t k = 0; k < Nstate_; k++)
+                    ensemble_(m, k) = mean_state_vector(k)
+                        + Ts(sqrt(factor(k)))
+                        * (ensemble_(m, k) - mean_state_vector(k));
+                GetRowPointer(ensemble_, m, member);
+                observation_manager_.ApplyOperator(member, Hx);
+                member.Nullify();
+                Mlt(To(-1), Hx);
+                Add(To(1), obs, Hx);
+                SetCol(Hx, m, innovation_matrix);
+            }
+        }
 
-            // 'working_matrix' stores HLL'H' + R.
-            MltAdd(To(1), SeldonNoTrans, HL, SeldonTrans, HL,
-                   To(1), working_matrix);
+        // Constructs the square root of the empirical variance.
+        Matrix<Ts> L(Nstate_, Nlocal_member_);
+        for (int l = 0; l < Nlocal_member_; l++)
+            for (size_t k = 0; k < Nstate_; k++)
+                L(k, l) = Ts(1) / sqrt(Ts(Nmember_ - 1))
+                    * (ensemble_(l, k) - mean_state_vector(k));
+
+        // Forecast standard deviation of every state component, for the
+        // relaxation to the prior spread.
+        Vector<Ts> forecast_spread;
+        if (inflation_type_ == "RTPS")
+        {
+            forecast_spread.Reallocate(Nstate_);
+            forecast_spread.Fill(Ts(0));
+            for (size_t k = 0; k < Nstate_; k++)
+                for (int l = 0; l < Nlocal_member_; l++)
+                    forecast_spread(k) += L(k, l) * L(k, l);
+#if defined(VERDANDI_WITH_MPI)
+            Vector<Ts> forecast_spread_global(Nstate_);
+            MPI_Allreduce(forecast_spread.GetData(),
+                          forecast_spread_global.GetData(), Nstate_,
+                          MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+            forecast_spread = forecast_spread_global;
+#endif
+            for (size_t k = 0; k < Nstate_; k++)
+                forecast_spread(k) = sqrt(forecast_spread(k));
+        }
 
-            // Computes (HLL'H' + R)^{-1} d.
-            Matrix<To> correction(Nobservation_, Nlocal_member_);
-            GetInverse(working_matrix);
-            MltAdd(To(1), working_matrix, innovation_matrix,
-                   To(0), correction);
+        // Computes H times L.
+        Matrix<To> HL(Nobservation_, Nlocal_member_);
 
+        if (observation_tangent_linear_operator_access_ == "matrix")
+            MltAdd(To(1), observation_manager_.GetTangentLinearOperator(),
+                   L, To(0), HL);
+        else // "element".
+            // The observation manager applies the operator to all
+            // columns of L at once.
+            observation_manager_.ApplyTangentLinearOperator(L, HL);
 
-            // Computes LL'H'
-            Matrix<Ts> LLH(Nstate_, Nobservation_);
-            MltAdd(Ts(1), SeldonNoTrans, L, SeldonTrans, HL, Ts(0), LLH);
+#if defined(VERDANDI_WITH_MPI)
+        // So far, L and HL only have the columns of the local members.
+        // The analysis of the local members involves the columns of all
+        // members, which are exchanged with non-blocking collectives. The
+        // products that only involve local columns are computed in the
+        // meantime.
+        Matrix<Ts> L_row;
+        Matrix<To> HL_row;
+        Vector<int> L_count, L_offset, HL_count, HL_offset;
+        MPI_Request L_request, HL_request;
+        StartGatherColumn(HL, HL_row, HL_count, HL_offset, HL_request);
+        StartGatherColumn(L, L_row, L_count, L_offset, L_request);
+#endif
 
-            // Computes LL'H' (HLL'H' + R)^{-1} d.
-            Matrix<Ts> Kd(Nstate_, Nlocal_member_);
-            MltAdd(Ts(1), LLH, correction, Ts(0), Kd);
+        // In the observation space, HLL'H' is the sum of the products of
+        // the local columns.
+        Matrix<To> HLLH;
+        bool observation_space = square_root_ == "none"
+            && analysis_space_ == "observation";
+        if (observation_space)
+        {
+            HLLH.Reallocate(Nobservation_, Nobservation_);
+            MltAdd(To(1), SeldonNoTrans, HL, SeldonTrans, HL, To(0),
+                   HLLH);
+        }
+#if defined(VERDANDI_WITH_MPI)
+        MPI_Request HLLH_request = MPI_REQUEST_NULL;
+        if (observation_space)
+            MPI_Iallreduce(MPI_IN_PLACE, HLLH.GetData(),
+                           int(Nobservation_ * Nobservation_),
+                           MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD,
+                           &HLLH_request);
+        FinishGatherColumn(HL_request, HL_row, HL);
+#endif
 
-            // Updates the ensemble A += K * d.
-            for (int m = 0; m < Nlocal_member_; m++)
-                for (size_t l = 0; l < Nstate_; l++)
-                    ensemble_[m](l) += Kd(l, m);
+        if (square_root_ != "none")
+        {
+            // The deviations from the mean are transformed, without
+            // gain.
+#if defined(VERDANDI_WITH_MPI)
+            if (square_root_ == "EAKF")
+                FinishGatherColumn(L_request, L_row, L);
+#endif
+            Matrix<Ts> W;
+            ComputeSquareRootWeight(L, HL, innovation_matrix, W);
+#if defined(VERDANDI_WITH_MPI)
+            if (square_root_ == "ETKF")
+                FinishGatherColumn(L_request, L_row, L);
+#endif
 
-            // Sets state to ensemble mean.
-            mean_state_vector = 0.;
+            // Updates the ensemble in place: x^a_m = mean + L W_m for
+            // the local members, that is, the ensemble block is set to
+            // 1 mean' + W_local' L'.
+            Matrix<Ts> W_local(Nmember_, Nlocal_member_);
+            for (int q = 0; q < Nmember_; q++)
+                for (int m = 0; m < Nlocal_member_; m++)
+                    W_local(q, m) = W(q, m + first_member_index_);
             for (int m = 0; m < Nlocal_member_; m++)
+                SetRow(mean_state_vector, m, ensemble_);
+            MltAdd(Ts(1), SeldonTrans, W_local, SeldonTrans, L, Ts(1),
+                   ensemble_);
+        }
+        else
+        {
+            // The corrections K d of the local members are added to the
+            // ensemble block, with one member per row.
+            if (analysis_space_ == "ensemble")
             {
-                model_.GetState() = ensemble_[m];
-                model_.StateUpdated();
-                ensemble_full_[m] = model_.GetFullState();
-                Add(Ts(1), model_.GetState(), mean_state_vector);
+                // With the Sherman-Morrison-Woodbury identity,
+                // (HL)'(HLL'H' + R)^{-1}
+                //     = (I + (HL)'R^{-1}HL)^{-1} (HL)'R^{-1},
+                // so that only a matrix of the size of the ensemble is
+                // inverted.
+
+                // Computes R^{-1} HL, one column at a time, which costs
+                // O(pN) with a diagonal R.
+                Matrix<To> R_inv_HL(HL);
+                ApplyErrorVarianceInverse(R_inv_HL);
+
+                // 'working_matrix' stores I + (HL)'R^{-1}HL.
+                Matrix<To> working_matrix(Nmember_, Nmember_);
+                working_matrix.SetIdentity();
+                MltAdd(To(1), SeldonTrans, HL, SeldonNoTrans, R_inv_HL,
+                       To(1), working_matrix);
+
+                // Computes (HL)'R^{-1} d.
+                Matrix<To> ensemble_innovation(Nmember_, Nlocal_member_);
+                MltAdd(To(1), SeldonTrans, R_inv_HL, SeldonNoTrans,
+                       innovation_matrix, To(0), ensemble_innovation);
+
+                // Computes (I + (HL)'R^{-1}HL)^{-1} (HL)'R^{-1} d. The
+                // matrix is symmetric positive definite, so that it is
+                // factorized instead of inverted.
+                SymmetricFactorization<To> factorization;
+                factorization.Factorize(working_matrix);
+                Matrix<To>& correction = ensemble_innovation;
+                factorization.SolveColumn(correction);
+
+                // Computes L (I + (HL)'R^{-1}HL)^{-1} (HL)'R^{-1} d.
+#if defined(VERDANDI_WITH_MPI)
+                FinishGatherColumn(L_request, L_row, L);
+#endif
+                MltAdd(Ts(1), SeldonTrans, correction, SeldonTrans, L,
+                       Ts(1), ensemble_);
             }
+            else // "observation".
+            {
+                // Reads R.
+                Matrix<To> working_matrix(Nobservation_, Nobservation_);
+                working_matrix = observation_manager_.GetErrorVariance();
+
+                if (localization_type_ != "none")
+                    ComputeObservationCoordinate();
 
 #if defined(VERDANDI_WITH_MPI)
-            model_state mean_state_global_vector(model_.GetNstate());
-            MPI_Allreduce(mean_state_vector.GetData(),
-                          mean_state_global_vector.GetData(),
-                          model_.GetNstate(), MPI_DOUBLE, MPI_SUM,
-                          MPI_COMM_WORLD);
-            mean_state_vector = mean_state_global_vector;
+                MPI_Wait(&HLLH_request, MPI_STATUS_IGNORE);
 #endif
 
-            Mlt(Ts(1) / Ts(Nmember_), mean_state_vector);
-            model_.GetState() = mean_state_vector;
-            model_.StateUpdated();
+                // 'working_matrix' stores HLL'H' + R.
+                if (localization_type_ != "none")
+                    schur_localize(observation_coordinate_,
+                                   observation_coordinate_,
+                                   localization_radius_, HLLH);
+                Add(To(1), HLLH, working_matrix);
+
+                // Computes (HLL'H' + R)^{-1} d. The matrix is symmetric
+                // positive definite, so that it is factorized instead of
+                // inverted.
+                SymmetricFactorization<To> factorization;
+                factorization.Factorize(working_matrix);
+                Matrix<To> correction(innovation_matrix);
+                factorization.SolveColumn(correction);
 
-#ifdef VERDANDI_WITH_MPI
-            if (rank_ == 0)
-            {
+#if defined(VERDANDI_WITH_MPI)
+                FinishGatherColumn(L_request, L_row, L);
 #endif
-                // Computes the average of the mean analysis.
-                Ts sum = 0.;
-                for (size_t i = 0; i < model_.GetNstate(); i++)
-                    sum += mean_state_vector(i);
-                if (option_display_["state_average"])
-                    Logger::StdOut(*this, "Analysis state average: "
-                                   + to_str(sum / Ts(model_.GetNstate())));
-                else
-                    Logger::Log<-3>(*this, "Analysis state average: "
-                                    + to_str(sum / Ts(model_.GetNstate())));
-                // Computes the minimum and maximum of the mean forecast.
-                Ts minimum = mean_state_vector(0);
-                Ts maximum = mean_state_vector(0);
-                for (size_t i = 1; i < model_.GetNstate(); i++)
+                if (localization_type_ == "none")
                 {
-                    minimum = min(minimum, mean_state_vector(i));
-                    maximum = max(maximum, mean_state_vector(i));
+                    // Computes L (HL)' (HLL'H' + R)^{-1} d, without
+                    // forming LL'H'.
+                    Matrix<To> ensemble_correction(Nmember_,
+                                                   Nlocal_member_);
+                    MltAdd(To(1), SeldonTrans, HL, SeldonNoTrans,
+                           correction, To(0), ensemble_correction);
+                    MltAdd(Ts(1), SeldonTrans, ensemble_correction,
+                           SeldonTrans, L, Ts(1), ensemble_);
                 }
-                if (option_display_["state_average"])
-                    Logger::StdOut(*this, "Analysis state minimum and "
-                                   "maximum: (" + to_str(minimum) + ", "
-                                   + to_str(maximum) + ")");
                 else
-                    Logger::Log<-3>(*this, "Analysis state minimum and "
-                                   "maximum: (" + to_str(minimum) + ", "
-                                   + to_str(maximum) + ")");
-#ifdef VERDANDI_WITH_MPI
+                {
+                    // Computes LL'H'
+                    Matrix<Ts> LLH(Nstate_, Nobservation_);
+                    MltAdd(Ts(1), SeldonNoTrans, L, SeldonTrans, HL,
+                           Ts(0), LLH);
+                    schur_localize(state_coordinate_,
+                                   observation_coordinate_,
+                                   localization_radius_, LLH);
+
+                    // Computes LL'H' (HLL'H' + R)^{-1} d.
+                    MltAdd(Ts(1), SeldonTrans, correction, SeldonTrans,
+                           LLH, Ts(1), ensemble_);
+                }
             }
-#endif
+        }
 
-            MessageHandler::Send(*this, "model", "analysis");
-            MessageHandler::Send(*this, "observation_manager", "analysis");
-            MessageHandler::Send(*this, "driver", "analysis");
+        if (inflation_type_ == "RTPS")
+            RelaxToPriorSpread(forecast_spread);
+    }
+
+
+    //! Sets the model state to the mean of the analyzed ensemble.
+    /*! The full states of the local members are updated from 'ensemble_'.
+     */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    void EnsembleKalmanFilter<Model, ObservationManager,
+                              PerturbationManager>::ComputeAnalysisMean()
+    {
+        model_state mean_state_vector(model_.GetNstate());
+        // Sets state to ensemble mean.
+        mean_state_vector = 0.;
+        for (int m = 0; m < Nlocal_member_; m++)
+        {
+            GetRow(ensemble_, m, model_.GetState());
+            model_.StateUpdated();
+            SetRow(model_.GetFullState(), m, ensemble_full_);
+            Add(Ts(1), model_.GetState(), mean_state_vector);
         }
 
-        MessageHandler::Send(*this, "all", "::Analyze end");
+#if defined(VERDANDI_WITH_MPI)
+        model_state mean_state_global_vector(model_.GetNstate());
+        MPI_Allreduce(mean_state_vector.GetData(),
+                      mean_state_global_vector.GetData(),
+                      model_.GetNstate(), MPI_DOUBLE, MPI_SUM,
+                      MPI_COMM_WORLD);
+        mean_state_vector = mean_state_global_vector;
+#endif
+
+        Mlt(Ts(1) / Ts(Nmember_), mean_state_vector);
+        model_.GetState() = mean_state_vector;
+        model_.StateUpdated();
+
+#ifdef VERDANDI_WITH_MPI
+        if (rank_ == 0)
+        {
+#endif
+            // Computes the average of the mean analysis.
+            Ts sum = 0.;
+            for (size_t i = 0; i < model_.GetNstate(); i++)
+                sum += mean_state_vector(i);
+            if (option_display_["state_average"])
+                Logger::StdOut(*this, "Analysis state average: "
+                               + to_str(sum / Ts(model_.GetNstate())));
+            else
+                Logger::Log<-3>(*this, "Analysis state average: "
+                                + to_str(sum / Ts(model_.GetNstate())));
+            // Computes the minimum and maximum of the mean forecast.
+            Ts minimum = mean_state_vector(0);
+            Ts maximum = mean_state_vector(0);
+            for (size_t i = 1; i < model_.GetNstate(); i++)
+            {
+                minimum = min(minimum, mean_state_vector(i));
+                maximum = max(maximum, mean_state_vector(i));
+            }
+            if (option_display_["state_average"])
+                Logger::StdOut(*this, "Analysis state minimum and "
+                               "maximum: (" + to_str(minimum) + ", "
+                               + to_str(maximum) + ")");
+            else
+                Logger::Log<-3>(*this, "Analysis state minimum and "
+                               "maximum: (" + to_str(minimum) + ", "
+                               + to_str(maximum) + ")");
+#ifdef VERDANDI_WITH_MPI
+        }
+#endif
     }
 
 
@@ -856,6 +1264,9 @@ namespace Verdandi
 
         model_.FinalizeStep();
 
+        if (!checkpoint_file_.empty() && iteration_ % checkpoint_period_ == 0)
+            WriteCheckpoint(checkpoint_file_);
+
         MessageHandler::Send(*this, "all", "::FinalizeStep end");
     }
 
@@ -870,6 +1281,8 @@ namespace Verdandi
 
         model_.Finalize();
 
+        output_saver_.Flush();
+
         MessageHandler::Send(*this, "all", "::Finalize end");
     }
 
@@ -888,6 +1301,123 @@ namespace Verdandi
     }
 
 
+    //! Writes a checkpoint from which the filter can restart.
+    /*! The checkpoint is a binary file that contains the iteration, the
+      current time, the local members, their parameters, the perturbations,
+      the adaptive inflation factor and the state of the random number
+      generator. Every process writes its own file, so that \a file_name
+      should contain the markup "%{rank}" when several processes are
+      involved. The file is first written under a temporary name, so that a
+      former checkpoint is not lost if the writing fails.
+      \param[in] file_name path to the checkpoint.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    void EnsembleKalmanFilter<Model, ObservationManager,
+                              PerturbationManager>
+    ::WriteCheckpoint(string file_name)
+    {
+        file_name = GetCheckpointFileName(file_name);
+        string temporary_file_name = file_name + ".tmp";
+        ofstream stream(temporary_file_name.c_str(), ofstream::binary);
+        if (!stream.good())
+            throw ErrorIO("EnsembleKalmanFilter::WriteCheckpoint",
+                          "Unable to open file \"" + temporary_file_name
+                          + "\".");
+
+        int header[7] = {Nmember_, Nlocal_member_, first_member_index_,
+                         int(Nstate_), int(Nfull_state_), Nparameter_,
+                         iteration_};
+        stream.write(reinterpret_cast<char*>(header), 7 * sizeof(int));
+        double time = model_.GetTime();
+        stream.write(reinterpret_cast<char*>(&time), sizeof(double));
+        stream.write(reinterpret_cast<char*>(&adaptive_inflation_),
+                     sizeof(double));
+
+        ensemble_.Write(stream);
+        ensemble_full_.Write(stream);
+        for (int p = 0; p < Nparameter_; p++)
+        {
+            for (int m = 0; m < Nlocal_member_; m++)
+                parameter_[p][m + first_member_index_].Write(stream, true);
+            for (int m = 0; m < Nmember_; m++)
+                perturbation_[p][m].Write(stream, true);
+        }
+
+        perturbation_manager_.WriteState(stream);
+
+        stream.close();
+        if (!stream.good())
+            throw ErrorIO("EnsembleKalmanFilter::WriteCheckpoint",
+                          "Unable to write file \"" + temporary_file_name
+                          + "\".");
+        if (rename(temporary_file_name.c_str(), file_name.c_str()) != 0)
+            throw ErrorIO("EnsembleKalmanFilter::WriteCheckpoint",
+                          "Unable to rename \"" + temporary_file_name
+                          + "\" to \"" + file_name + "\".");
+    }
+
+
+    //! Restores the filter from a checkpoint.
+    /*! The checkpoint must have been written by 'WriteCheckpoint' with the
+      same ensemble, the same model dimensions and the same number of
+      processes. The time of the model is set to the time of the checkpoint.
+      \param[in] file_name path to the checkpoint.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    void EnsembleKalmanFilter<Model, ObservationManager,
+                              PerturbationManager>
+    ::ReadCheckpoint(string file_name)
+    {
+        file_name = GetCheckpointFileName(file_name);
+        ifstream stream(file_name.c_str(), ifstream::binary);
+        if (!stream.good())
+            throw ErrorIO("EnsembleKalmanFilter::ReadCheckpoint",
+                          "Unable to open file \"" + file_name + "\".");
+
+        int header[7];
+        stream.read(reinterpret_cast<char*>(header), 7 * sizeof(int));
+        if (!stream.good())
+            throw ErrorIO("EnsembleKalmanFilter::ReadCheckpoint",
+                          "Unable to read file \"" + file_name + "\".");
+        if (header[0] != Nmember_ || header[1] != Nlocal_member_
+            || header[2] != first_member_index_ || header[3] != int(Nstate_)
+            || header[4] != int(Nfull_state_) || header[5] != Nparameter_)
+            throw ErrorConfiguration("EnsembleKalmanFilter::ReadCheckpoint",
+                                     "The checkpoint \"" + file_name
+                                     + "\" was written for another "
+                                     "ensemble, another model or another "
+                                     "number of processes.");
+        iteration_ = header[6];
+        double time;
+        stream.read(reinterpret_cast<char*>(&time), sizeof(double));
+        stream.read(reinterpret_cast<char*>(&adaptive_inflation_),
+                    sizeof(double));
+
+        ensemble_.Read(stream);
+        ensemble_full_.Read(stream);
+        for (int p = 0; p < Nparameter_; p++)
+        {
+            for (int m = 0; m < Nlocal_member_; m++)
+                parameter_[p][m + first_member_index_].Read(stream, true);
+            for (int m = 0; m < Nmember_; m++)
+                perturbation_[p][m].Read(stream, true);
+        }
+
+        perturbation_manager_.ReadState(stream);
+
+        if (!stream.good())
+            throw ErrorIO("EnsembleKalmanFilter::ReadCheckpoint",
+                          "Unable to read file \"" + file_name + "\".");
+
+        model_.SetTime(time);
+        for (size_t t = 0; t < model_clone_.size(); t++)
+            model_clone_[t]->SetTime(time);
+        time_ = time;
+    }
+
+
     //! Returns the model.
     /*!
       \return The model.
@@ -997,7 +1527,7 @@ namespace Verdandi
                     .IsVariable("forecast_state-"
                                 + to_str(m + first_member_index_)))
                 {
-                    model_.GetFullState() = ensemble_full_[m];
+                    GetRow(ensemble_full_, m, model_.GetFullState());
                     model_.FullStateUpdated();
                     output_saver_.Save(model_.GetState(),
                                        model_.GetTime(),
@@ -1030,7 +1560,7 @@ namespace Verdandi
                     .IsVariable("analysis_state-"
                                 + to_str(m + first_member_index_)))
                 {
-                    model_.GetFullState() = ensemble_full_[m];
+                    GetRow(ensemble_full_, m, model_.GetFullState());
                     model_.FullStateUpdated();
                     output_saver_.Save(model_.GetState(),
                                        model_.GetTime(),
@@ -1048,6 +1578,493 @@ namespace Verdandi
     ///////////////////////
 
 
+    //! Performs a forecast step for a range of local members.
+    /*! The members are propagated one after the other with \a model, which
+      must be at the beginning of the time step. After the last member, the
+      model is left at the forecast time.
+      \param[in,out] model the model used to propagate the members.
+      \param[in] first local index of the first member to be propagated.
+      \param[in] last local index of the member after the last member to be
+      propagated.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    void EnsembleKalmanFilter<Model, ObservationManager,
+                              PerturbationManager>
+    ::PropagateMember(Model& model, int first, int last)
+    {
+        for (int m = first; m < last; m++)
+        {
+            for (int i = 0; i < Nparameter_; i++)
+            {
+                model.GetParameter(i)
+                    .Copy(parameter_[i][m + first_member_index_]);
+                model.ParameterUpdated(i);
+            }
+            GetRow(ensemble_full_, m, model.GetFullState());
+            model.FullStateUpdated();
+
+            model.Forward();
+
+            SetRow(model.GetFullState(), m, ensemble_full_);
+
+            if (m < last - 1)
+            {
+                model.SetTime(time_);
+                model.InitializeStep();
+            }
+        }
+    }
+
+
+    //! Returns the path to the checkpoint of the current process.
+    /*!
+      \param[in] file_name path to the checkpoint, possibly with the markup
+      "%{rank}".
+      \return The path \a file_name where "%{rank}" is replaced with the
+      process rank, or removed without MPI.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    string EnsembleKalmanFilter<Model, ObservationManager,
+                                PerturbationManager>
+    ::GetCheckpointFileName(string file_name) const
+    {
+#ifdef VERDANDI_WITH_MPI
+        if (Nprocess_ > 1 && file_name.find("%{rank}") == string::npos)
+            throw ErrorConfiguration("EnsembleKalmanFilter"
+                                     "::GetCheckpointFileName",
+                                     "With several processes, the path to "
+                                     "the checkpoint \"" + file_name
+                                     + "\" should contain \"%{rank}\".");
+        return find_replace(file_name, "%{rank}", to_str(rank_));
+#else
+        return find_replace(file_name, "%{rank}", "");
+#endif
+    }
+
+
+    //! Sets the coordinates of the current observations.
+    /*! If no observation coordinate file was provided, the coordinates of
+      every observation are the weighted average of the coordinates of the
+      state components, the weights being given by the corresponding row of
+      the tangent linear observation operator. This is exact for observations
+      interpolated from the state. An exception is thrown if a row of the
+      operator sums to zero.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    void EnsembleKalmanFilter<Model, ObservationManager,
+                              PerturbationManager>
+    ::ComputeObservationCoordinate()
+    {
+        if (!observation_coordinate_file_.empty())
+        {
+            if (observation_coordinate_.GetM() != Nobservation_)
+                throw ErrorProcessing("EnsembleKalmanFilter"
+                                      "::ComputeObservationCoordinate()",
+                                      "The localization requires the "
+                                      "coordinates of "
+                                      + to_str(Nobservation_)
+                                      + " observations, but "
+                                      + to_str(observation_coordinate_.GetM())
+                                      + " were provided.");
+            return;
+        }
+
+        int Ndimension = state_coordinate_.GetN();
+        observation_coordinate_.Reallocate(Nobservation_, Ndimension);
+
+        model_state x(Nstate_);
+        observation weight(Nobservation_), y(Nobservation_);
+        x.Fill(Ts(1));
+        observation_manager_.ApplyTangentLinearOperator(x, weight);
+        for (size_t i = 0; i < Nobservation_; i++)
+            if (weight(i) == To(0))
+                throw ErrorProcessing("EnsembleKalmanFilter"
+                                      "::ComputeObservationCoordinate()",
+                                      "The row of the observation operator "
+                                      "associated with observation "
+                                      + to_str(i) + " sums to zero, so that "
+                                      "the coordinates of this observation "
+                                      "cannot be derived from the operator. "
+                                      "They should be provided in "
+                                      "\"localization.observation_coordinate"
+                                      "_file\".");
+        for (int d = 0; d < Ndimension; d++)
+        {
+            for (size_t k = 0; k < Nstate_; k++)
+                x(k) = Ts(state_coordinate_(k, d));
+            observation_manager_.ApplyTangentLinearOperator(x, y);
+            for (size_t i = 0; i < Nobservation_; i++)
+                observation_coordinate_(i, d) = double(y(i) / weight(i));
+        }
+    }
+
+
+    //! Estimates the adaptive inflation factor from the innovations.
+    /*! The factor \f$\lambda\f$ is such that the statistics of the
+      innovation \f$d = y - H\bar x\f$ of the ensemble mean are consistent
+      with the inflated covariances:
+      \f$d^T d = \lambda\, \textrm{tr}(H P^f H^T) + \textrm{tr}(R)\f$. It is
+      then bounded by the minimum and maximum inflation factors.
+      \param[in] innovation_matrix the innovations of the local members, one
+      per column.
+      \return The adaptive inflation factor.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    double EnsembleKalmanFilter<Model, ObservationManager,
+                                PerturbationManager>
+    ::ComputeAdaptiveInflation(const Matrix<To>& innovation_matrix)
+    {
+        // Innovation of the ensemble mean.
+        Vector<To> mean_innovation(Nobservation_);
+        mean_innovation.Fill(To(0));
+        for (size_t i = 0; i < Nobservation_; i++)
+            for (int m = 0; m < Nlocal_member_; m++)
+                mean_innovation(i) += innovation_matrix(i, m);
+#if defined(VERDANDI_WITH_MPI)
+        Vector<To> mean_innovation_global(Nobservation_);
+        MPI_Allreduce(mean_innovation.GetData(),
+                      mean_innovation_global.GetData(), Nobservation_,
+                      MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        mean_innovation = mean_innovation_global;
+#endif
+        Mlt(To(1) / To(Nmember_), mean_innovation);
+
+        // Trace of H P^f H^T, estimated with the ensemble.
+        double spread = 0.;
+        for (size_t i = 0; i < Nobservation_; i++)
+            for (int m = 0; m < Nlocal_member_; m++)
+                spread += (innovation_matrix(i, m) - mean_innovation(i))
+                    * (innovation_matrix(i, m) - mean_innovation(i));
+#if defined(VERDANDI_WITH_MPI)
+        double spread_global;
+        MPI_Allreduce(&spread, &spread_global, 1, MPI_DOUBLE, MPI_SUM,
+                      MPI_COMM_WORLD);
+        spread = spread_global;
+#endif
+        spread /= double(Nmember_ - 1);
+
+        double innovation_norm = 0., error_variance_trace = 0.;
+        for (size_t i = 0; i < Nobservation_; i++)
+        {
+            innovation_norm += mean_innovation(i) * mean_innovation(i);
+            error_variance_trace += observation_manager_
+                .GetErrorVariance(i, i);
+        }
+
+        if (spread <= 0.)
+            return inflation_maximum_;
+        double factor = (innovation_norm - error_variance_trace) / spread;
+        return max(inflation_minimum_, min(inflation_maximum_, factor));
+    }
+
+
+    //! Relaxes the analysis spread to the forecast spread (RTPS).
+    /*! The deviations of the members from the analysis mean are multiplied,
+      for every state component \f$k\f$, by \f$1 + \alpha_k (\sigma^f_k -
+      \sigma^a_k) / \sigma^a_k\f$, where \f$\sigma^f_k\f$ and
+      \f$\sigma^a_k\f$ are the forecast and analysis standard deviations, and
+      \f$\alpha_k\f$ is the inflation coefficient of the component.
+      \param[in] forecast_spread the forecast standard deviation of every
+      state component.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    void EnsembleKalmanFilter<Model, ObservationManager,
+                              PerturbationManager>
+    ::RelaxToPriorSpread(const Vector<Ts>& forecast_spread)
+    {
+        // Analysis mean and standard deviation.
+        Vector<Ts> mean(Nstate_), spread(Nstate_);
+        mean.Fill(Ts(0));
+        for (int m = 0; m < Nlocal_member_; m++)
+            for (size_t k = 0; k < Nstate_; k++)
+                mean(k) += ensemble_(m, k);
+#if defined(VERDANDI_WITH_MPI)
+        Vector<Ts> global(Nstate_);
+        MPI_Allreduce(mean.GetData(), global.GetData(), Nstate_,
+                      MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        mean = global;
+#endif
+        Mlt(Ts(1) / Ts(Nmember_), mean);
+
+        spread.Fill(Ts(0));
+        for (int m = 0; m < Nlocal_member_; m++)
+            for (size_t k = 0; k < Nstate_; k++)
+                spread(k) += (ensemble_(m, k) - mean(k))
+                    * (ensemble_(m, k) - mean(k));
+#if defined(VERDANDI_WITH_MPI)
+        MPI_Allreduce(spread.GetData(), global.GetData(), Nstate_,
+                      MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        spread = global;
+#endif
+
+        double average = 0.;
+        for (size_t k = 0; k < Nstate_; k++)
+        {
+            spread(k) = sqrt(spread(k) / Ts(Nmember_ - 1));
+            Ts factor = Ts(1);
+            if (spread(k) > Ts(0))
+                factor += Ts(inflation_factor_(k))
+                    * (forecast_spread(k) - spread(k)) / spread(k);
+            for (int m = 0; m < Nlocal_member_; m++)
+                ensemble_(m, k) = mean(k) + factor * (ensemble_(m, k)
+                                                      - mean(k));
+            average += factor;
+        }
+
+        LogInflation("RTPS inflation factor (average): "
+                     + to_str(average / double(Nstate_)));
+    }
+
+
+    //! Applies the inverse of the observation error covariance matrix.
+    /*! The observation manager applies \f$R^{-1}\f$ to every column, so that
+      no matrix of the size of the observations is built.
+      \param[in,out] A on entry, a matrix with \f$N_{obs}\f$ rows; on exit,
+      \f$R^{-1} A\f$.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    void EnsembleKalmanFilter<Model, ObservationManager,
+                              PerturbationManager>
+    ::ApplyErrorVarianceInverse(Matrix<To>& A) const
+    {
+        observation column(A.GetM());
+        for (int j = 0; j < A.GetN(); j++)
+        {
+            GetCol(A, j, column);
+            observation_manager_.ApplyErrorVarianceInverse(column);
+            SetCol(column, j, A);
+        }
+    }
+
+
+    //! Computes the weights of a square root analysis.
+    /*! The analyzed members are \f$x^a_m = \bar x + L W_m\f$, where \f$W_m\f$
+      is the \a m-th column of \f$W = w 1^T + \sqrt{N - 1}\, T\f$. The mean
+      is updated with \f$w = (I + S)^{-1} (HL)^T R^{-1} \bar d\f$, where
+      \f$S = (HL)^T R^{-1} HL\f$, and \f$T\f$ transforms the deviations. With
+      the ensemble transform Kalman filter (ETKF), \f$T = (I + S)^{-1/2}\f$
+      (symmetric square root). With the ensemble adjustment Kalman filter
+      (EAKF), \f$T = V C (I + \Gamma)^{-1/2} V^T\f$, where the columns of
+      \f$V\f$ are the right singular vectors of \f$L\f$ and \f$V^T S V = C
+      \Gamma C^T\f$.
+      \param[in] L the normalized deviations of all members from the mean.
+      It is only used by the EAKF.
+      \param[in] HL the tangent linear observation operator times \a L.
+      \param[in] innovation_matrix the innovations of the local members, one
+      per column.
+      \param[out] W the weights of the analyzed members, one member per
+      column.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    void EnsembleKalmanFilter<Model, ObservationManager,
+                              PerturbationManager>
+    ::ComputeSquareRootWeight(const Matrix<Ts>& L, const Matrix<To>& HL,
+                              const Matrix<To>& innovation_matrix,
+                              Matrix<Ts>& W)
+    {
+        int N = Nmember_;
+
+        // Innovation of the mean, that is, the average of the innovations.
+        Vector<To> innovation(Nobservation_);
+        innovation.Fill(To(0));
+        for (size_t i = 0; i < Nobservation_; i++)
+            for (int m = 0; m < Nlocal_member_; m++)
+                innovation(i) += innovation_matrix(i, m);
+#if defined(VERDANDI_WITH_MPI)
+        MPI_Allreduce(MPI_IN_PLACE, innovation.GetData(), Nobservation_,
+                      MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+#endif
+        Mlt(To(1) / To(N), innovation);
+
+        // Computes S = (HL)'R^{-1}HL and (HL)'R^{-1} d.
+        Matrix<To> R_inv_HL(HL);
+        ApplyErrorVarianceInverse(R_inv_HL);
+        Matrix<To> S(N, N);
+        MltAdd(To(1), SeldonTrans, HL, SeldonNoTrans, R_inv_HL, To(0), S);
+        Vector<To> ensemble_innovation(N);
+        MltAdd(To(1), SeldonTrans, R_inv_HL, innovation, To(0),
+               ensemble_innovation);
+
+        // I + S is symmetric positive definite.
+        Matrix<To> working_matrix(S);
+        for (int q = 0; q < N; q++)
+            working_matrix(q, q) += To(1);
+
+        // Computes the mean weights w = (I + S)^{-1} (HL)'R^{-1} d, and the
+        // transform T of the deviations, in 'W'.
+        Vector<To> w(ensemble_innovation);
+        W.Reallocate(N, N);
+        if (square_root_ == "ETKF")
+        {
+            // The singular value decomposition of I + S is also its
+            // eigendecomposition: I + S = U D U'. It provides both w = U
+            // D^{-1} U' (HL)'R^{-1} d and T = U D^{-1/2} U'.
+            Vector<To> lambda;
+            Matrix<To> U, U_trans;
+            GetSVD(working_matrix, lambda, U, U_trans);
+            Vector<To> U_innovation(N);
+            MltAdd(To(1), SeldonTrans, U, ensemble_innovation, To(0),
+                   U_innovation);
+            for (int q = 0; q < N; q++)
+                U_innovation(q) /= lambda(q);
+            MltAdd(To(1), U, U_innovation, To(0), w);
+
+            Matrix<To> U_scaled(U);
+            for (int m = 0; m < N; m++)
+                for (int q = 0; q < N; q++)
+                    U_scaled(m, q) /= sqrt(lambda(q));
+            MltAdd(Ts(1), SeldonNoTrans, U_scaled, SeldonTrans, U, Ts(0), W);
+        }
+        else // "EAKF".
+        {
+            SymmetricFactorization<To> factorization;
+            factorization.Factorize(working_matrix);
+            factorization.Solve(w);
+
+            // The right singular vectors of L are the eigenvectors of L'L.
+            Matrix<Ts> LL(N, N);
+            MltAdd(Ts(1), SeldonTrans, L, SeldonNoTrans, L, Ts(0), LL);
+            Vector<Ts> sigma;
+            Matrix<Ts> V_full, V_trans;
+            GetSVD(LL, sigma, V_full, V_trans);
+
+            // Rank of L, at most N - 1. The singular values are sorted in
+            // decreasing order.
+            int rank = 0;
+            while (rank < N && sigma(rank) > Ts(1.e-12) * sigma(0))
+                rank++;
+
+            W.Fill(Ts(0));
+            if (rank > 0)
+            {
+                Matrix<Ts> V(N, rank);
+                for (int m = 0; m < N; m++)
+                    for (int q = 0; q < rank; q++)
+                        V(m, q) = V_full(m, q);
+
+                // V'SV = C Gamma C'.
+                Matrix<To> SV(N, rank), M(rank, rank);
+                MltAdd(To(1), S, V, To(0), SV);
+                MltAdd(To(1), SeldonTrans, V, SeldonNoTrans, SV, To(0), M);
+                Vector<To> gamma;
+                Matrix<To> C, C_trans;
+                GetSVD(M, gamma, C, C_trans);
+
+                // T = V C (I + Gamma)^{-1/2} V'.
+                Matrix<Ts> VC(N, rank);
+                MltAdd(Ts(1), V, C, Ts(0), VC);
+                for (int m = 0; m < N; m++)
+                    for (int q = 0; q < rank; q++)
+                        VC(m, q) /= sqrt(Ts(1) + gamma(q));
+                MltAdd(Ts(1), SeldonNoTrans, VC, SeldonTrans, V, Ts(0), W);
+            }
+        }
+
+        // W = w 1' + sqrt(N - 1) T.
+        Mlt(sqrt(Ts(N - 1)), W);
+        for (int q = 0; q < N; q++)
+            for (int m = 0; m < N; m++)
+                W(q, m) += w(q);
+    }
+
+
+#if defined(VERDANDI_WITH_MPI)
+    //! Starts gathering the columns of a matrix distributed over processes.
+    /*! Every process holds the columns of its local members. The columns of
+      all members are gathered, one member per row of \a row, with a
+      non-blocking collective operation.
+      \param[in] local the columns of the local members.
+      \param[out] row the columns of all members, one per row, once the
+      request is completed.
+      \param[out] count the number of elements received from every process.
+      It must not be modified before the request is completed.
+      \param[out] offset the position of the elements received from every
+      process. It must not be modified before the request is completed.
+      \param[out] request the request of the non-blocking operation.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    template <class T>
+    void EnsembleKalmanFilter<Model, ObservationManager,
+                              PerturbationManager>
+    ::StartGatherColumn(const Matrix<T>& local, Matrix<T>& row,
+                        Vector<int>& count, Vector<int>& offset,
+                        MPI_Request& request)
+    {
+        int Nrow = local.GetM();
+        row.Reallocate(Nmember_, Nrow);
+        for (int m = 0; m < Nlocal_member_; m++)
+            for (int k = 0; k < Nrow; k++)
+                row(m + first_member_index_, k) = local(k, m);
+
+        count.Reallocate(Nprocess_);
+        offset.Reallocate(Nprocess_);
+        int position = 0;
+        for (int r = 0; r < Nprocess_; r++)
+        {
+            int Nrank_member = Nmember_ / Nprocess_
+                + (r < Nmember_ % Nprocess_ ? 1 : 0);
+            count(r) = Nrank_member * Nrow;
+            offset(r) = position * Nrow;
+            position += Nrank_member;
+        }
+        MPI_Iallgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, row.GetData(),
+                        count.GetData(), offset.GetData(), MPI_DOUBLE,
+                        MPI_COMM_WORLD, &request);
+    }
+
+
+    //! Completes the gathering of the columns of a distributed matrix.
+    /*!
+      \param[in,out] request the request of the non-blocking operation.
+      \param[in] row the columns of all members, one per row.
+      \param[out] global the matrix with the columns of all members.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    template <class T>
+    void EnsembleKalmanFilter<Model, ObservationManager,
+                              PerturbationManager>
+    ::FinishGatherColumn(MPI_Request& request, const Matrix<T>& row,
+                         Matrix<T>& global)
+    {
+        MPI_Wait(&request, MPI_STATUS_IGNORE);
+        global.Reallocate(row.GetN(), row.GetM());
+        for (int k = 0; k < row.GetN(); k++)
+            for (int m = 0; m < row.GetM(); m++)
+                global(k, m) = row(m, k);
+    }
+#endif
+
+
+    //! Logs a message about the inflation.
+    /*!
+      \param[in] message the message.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    void EnsembleKalmanFilter<Model, ObservationManager,
+                              PerturbationManager>
+    ::LogInflation(string message)
+    {
+#ifdef VERDANDI_WITH_MPI
+        if (rank_ != 0)
+            return;
+#endif
+        if (option_display_["inflation"])
+            Logger::StdOut(*this, message);
+        else
+            Logger::Log<-3>(*this, message);
+    }
+
+
     /*! \brief Fills an input vector collection according to its probability
       distribution. */
     /*!
@@ -22,6 +22,10 @@
 #ifndef VERDANDI_FILE_METHOD_ENSEMBLEKALMANFILTER_HXX
 
 
+#include <exception>
+#include <cstdio>
+
+
 namespace Verdandi
 {
 
@@ -50,8 +54,9 @@ namespace Verdandi
         typedef typename Model::uncertain_parameter uncertain_parameter;
         //! Value type of an uncertain parameter.
         typedef typename Model::uncertain_parameter::value_type Tp;
-        //! Type of the ensemble of state vectors.
-        typedef vector<model_state> ensemble;
+        /*! \brief Type of the ensemble of state vectors: one member per row,
+          so that every member is contiguous in memory. */
+        typedef Matrix<Ts> ensemble;
 
     protected:
 
@@ -75,9 +80,15 @@ namespace Verdandi
         //! Local number of ensemble members (for parallel computing).
         int Nlocal_member_;
 
-        //! The ensemble state vectors.
+        //! Number of threads sharing the forecast of the local members.
+        int Nthread_;
+        /*! \brief Copies of the model used by the threads other than the
+          master thread, which uses 'model_'. */
+        vector<Model*> model_clone_;
+
+        //! The ensemble state vectors, one local member per row.
         ensemble ensemble_;
-        //! The ensemble full state vectors.
+        //! The ensemble full state vectors, one local member per row.
         ensemble ensemble_full_;
 
         //! Ensemble for the parameters.
@@ -95,6 +106,8 @@ namespace Verdandi
 
         //! Path to the configuration file.
         string configuration_file_;
+        //! Prefix of the entries of the method in the configuration.
+        string configuration_prefix_;
         //! Path to the model configuration file.
         string model_configuration_file_;
         //! Path to the configuration file for the perturbation manager.
@@ -117,8 +130,59 @@ namespace Verdandi
         double time_;
 
         /*! \brief Method of access to the tangent linear operator: "element"
-          or "matrix". */
+          (the observation manager applies the operator to a block of
+          vectors) or "matrix" (the operator matrix is retrieved). */
         string observation_tangent_linear_operator_access_;
+        /*! \brief Space in which the analysis is computed: "observation"
+          (inversion of a matrix of the size of the observations) or
+          "ensemble" (inversion of a matrix of the size of the ensemble). */
+        string analysis_space_;
+        /*! \brief Square root analysis: "none" (the gain is applied to the
+          innovation of every member), "ETKF" (ensemble transform) or "EAKF"
+          (ensemble adjustment). */
+        string square_root_;
+
+        /*** Localization ***/
+
+        //! Localization of the covariance: "none" or "Gaspari-Cohn".
+        string localization_type_;
+        //! Half-width of the support of the localization function.
+        double localization_radius_;
+        /*! \brief Coordinates of the state components: row \a i contains the
+          coordinates of the \a i-th component. */
+        Matrix<double> state_coordinate_;
+        /*! \brief File storing the coordinates of the observations. If empty,
+          the coordinates are derived from the observation operator. */
+        string observation_coordinate_file_;
+        //! Coordinates of the observations.
+        Matrix<double> observation_coordinate_;
+
+        /*** Inflation ***/
+
+        //! Inflation: "none", "multiplicative", "RTPS" or "adaptive".
+        string inflation_type_;
+        /*! \brief Inflation coefficient of each state component: the
+          covariance inflation factor ("multiplicative"), the relaxation
+          coefficient ("RTPS") or the weight of the estimated inflation
+          ("adaptive"). */
+        Vector<double> inflation_factor_;
+        //! Lower bound of the adaptive inflation factor.
+        double inflation_minimum_;
+        //! Upper bound of the adaptive inflation factor.
+        double inflation_maximum_;
+        //! Last adaptive inflation factor.
+        double adaptive_inflation_;
+
+        /*** Checkpoint ***/
+
+        /*! \brief File in which the checkpoints are written (no checkpoint if
+          empty). The markup "%{rank}" is replaced with the process rank. */
+        string checkpoint_file_;
+        //! Number of iterations between two checkpoints.
+        int checkpoint_period_;
+        /*! \brief Checkpoint from which the filter restarts (the ensemble is
+          generated if empty). */
+        string restart_file_;
 
 #if defined(VERDANDI_WITH_MPI)
 
@@ -169,6 +233,9 @@ namespace Verdandi
 
         bool HasFinished() const;
 
+        void WriteCheckpoint(string file_name);
+        void ReadCheckpoint(string file_name);
+
         // Access methods.
         Model& GetModel();
         ObservationManager& GetObservationManager();
@@ -180,6 +247,30 @@ namespace Verdandi
 
     protected:
 
+        virtual void InitializeAnalysis(VerdandiOps& configuration);
+        virtual void AnalyzeEnsemble();
+        void ComputeAnalysisMean();
+        void PropagateMember(Model& model, int first, int last);
+        void ComputeObservationCoordinate();
+        void ApplyErrorVarianceInverse(Matrix<To>& A) const;
+        void ComputeSquareRootWeight(const Matrix<Ts>& L,
+                                     const Matrix<To>& HL,
+                                     const Matrix<To>& innovation_matrix,
+                                     Matrix<Ts>& W);
+#if defined(VERDANDI_WITH_MPI)
+        template <class T>
+        void StartGatherColumn(const Matrix<T>& local, Matrix<T>& row,
+                               Vector<int>& count, Vector<int>& offset,
+                               MPI_Request& request);
+        template <class T>
+        void FinishGatherColumn(MPI_Request& request, const Matrix<T>& row,
+                                Matrix<T>& global);
+#endif
+        double ComputeAdaptiveInflation(const Matrix<To>& innovation_matrix);
+        void RelaxToPriorSpread(const Vector<Ts>& forecast_spread);
+        void LogInflation(string message);
+        string GetCheckpointFileName(string file_name) const;
+
         template <class T0, class Allocator0>
         void Fill(Vector<T0, Collection, Allocator0>& in, string pdf);
         template <class T0, class Storage0, class Allocator0>
@@ -190,6 +281,13 @@ namespace Verdandi
         template <class T0, class Allocator0>
         void SetDimension(Vector<T0, Collection, Allocator0>& in,
                           Vector<T0, Collection, Allocator0>& out);
+
+    private:
+
+        // The model copies are owned by the driver, so that it cannot be
+        // copied.
+        EnsembleKalmanFilter(const EnsembleKalmanFilter&);
+        EnsembleKalmanFilter& operator=(const EnsembleKalmanFilter&);
     };
 
 
@@ -41,7 +41,8 @@ namespace Verdandi
      */
     template <class Model, class ObservationManager>
     ExtendedKalmanFilter<Model, ObservationManager>
-    ::ExtendedKalmanFilter(): iteration_(-1)
+    ::ExtendedKalmanFilter(): iteration_(-1), Nthread_(1),
+                              covariance_rank_(0)
     {
 
         /*** Initializations ***/
@@ -60,6 +61,8 @@ namespace Verdandi
     ExtendedKalmanFilter<Model, ObservationManager>
     ::~ExtendedKalmanFilter()
     {
+        for (size_t t = 0; t < model_clone_.size(); t++)
+            delete model_clone_[t];
     }
 
 
@@ -119,12 +122,6 @@ namespace Verdandi
 
         Nobservation_  = observation_manager_.GetNobservation();
 
-        Copy(model_.GetStateErrorVariance(), state_error_variance_);
-
-
-        // Pre-allocations and temporary matrixes
-        temp_.Reallocate(Nstate_, Nstate_);
-
 
         /***************************
          * Reads the configuration *
@@ -150,9 +147,76 @@ namespace Verdandi
                           "ops_in(v, {'vector', 'matrix'})",
                           blue_computation_);
         configuration.Set("covariance_computation",
-                          "ops_in(v, {'vector', 'matrix'})",
+                          "ops_in(v, {'vector', 'matrix', 'packed', "
+                          "'low_rank'})",
                           covariance_computation_);
 
+        // Number of threads that share the applications of the tangent
+        // linear model, with "vector", "packed" or "low_rank" covariance
+        // computation.
+        configuration.Set("Nthread", "v >= 1", 1, Nthread_);
+#ifndef _OPENMP
+        if (Nthread_ > 1)
+            throw ErrorConfiguration("ExtendedKalmanFilter::Initialize",
+                                     "The covariance propagation is "
+                                     "requested on " + to_str(Nthread_)
+                                     + " threads, but Verdandi was compiled "
+                                     "without OpenMP.");
+#endif
+        for (size_t t = 0; t < model_clone_.size(); t++)
+            delete model_clone_[t];
+        model_clone_.clear();
+        // The model copies can only be initialized like 'model_' if the
+        // driver initializes it.
+        if (covariance_computation_ != "matrix" && Nthread_ > 1
+            && !initialize_model)
+            throw ErrorConfiguration("ExtendedKalmanFilter::Initialize",
+                                     "The model copies used by the "
+                                     "additional threads are initialized "
+                                     "with \"model.configuration_file\", so "
+                                     "that the model should also be "
+                                     "initialized by the driver when "
+                                     "\"Nthread\" is greater than 1.");
+        if (covariance_computation_ != "matrix")
+            for (int t = 1; t < Nthread_; t++)
+            {
+                model_clone_.push_back(new Model);
+                model_clone_.back()->Initialize(model_configuration_file_);
+            }
+
+        if (covariance_computation_ == "low_rank")
+        {
+            configuration.Set("covariance_rank",
+                              "v >= 1 and v <= " + to_str(Nstate_),
+                              covariance_rank_);
+
+            // Only the factors are kept: no matrix of size Nstate x Nstate
+            // is copied or decomposed.
+            ComputeLowRankFactor(model_.GetStateErrorVariance(),
+                                 covariance_rank_, covariance_factor_);
+            if (model_.GetErrorVariance().GetM() != 0
+                && model_.GetErrorVariance().GetN() != 0)
+                ComputeLowRankFactor(model_.GetErrorVariance(),
+                                     covariance_rank_, model_error_factor_);
+        }
+        else if (covariance_computation_ == "packed")
+        {
+            // Only the upper part of the covariance is stored.
+            packed_state_error_variance_.Reallocate(Nstate_, Nstate_);
+            packed_state_error_variance_.Zero();
+            AddUpperPart(Ts(1), model_.GetStateErrorVariance(),
+                         packed_state_error_variance_);
+
+            packed_lower_part_.Reallocate(Nstate_ - 1, Nstate_ - 1);
+        }
+        else
+        {
+            Copy(model_.GetStateErrorVariance(), state_error_variance_);
+
+            // Pre-allocations and temporary matrixes
+            temp_.Reallocate(Nstate_, Nstate_);
+        }
+
         /*** Ouput saver ***/
 
         configuration.SetPrefix("extended_kalman_filter.output_saver.");
@@ -329,25 +393,15 @@ namespace Verdandi
         double saved_time = model_.GetTime();
         model_.SetTime(time_);
 
-        // One column of covariance matrix P.
-        model_state_error_variance_row error_covariance_column(Nstate_);
-
-        for (int j = 0; j < Nstate_; j++)
-        {
-            GetCol(state_error_variance_, j,
-                   error_covariance_column);
-            model_.ApplyTangentLinearOperator(error_covariance_column);
-            SetCol(error_covariance_column, j, state_error_variance_);
-        }
-
-        Transpose(state_error_variance_);
+        // P being symmetric, its rows are its columns. The columns of M P
+        // are stored in 'temp_'.
+        ApplyTangentLinearOperatorBlock(state_error_variance_, false,
+                                        temp_, true);
 
-        for (int j = 0; j < Nstate_; j++)
-        {
-            GetCol(state_error_variance_, j, error_covariance_column);
-            model_.ApplyTangentLinearOperator(error_covariance_column);
-            SetCol(error_covariance_column, j, state_error_variance_);
-        }
+        // The rows of M P are the columns of P M'. Their images are the
+        // columns, and the rows, of M P M'.
+        ApplyTangentLinearOperatorBlock(temp_, false,
+                                        state_error_variance_, false);
 
         if (model_.GetErrorVariance().GetM() != 0
             && model_.GetErrorVariance().GetN() != 0)
@@ -380,6 +434,292 @@ namespace Verdandi
     }
 
 
+    //! Computes covariance in symmetric packed storage.
+    /*! The tangent linear model is applied as in "vector" mode, but only the
+      upper part of the covariance matrix is stored, and no matrix of size
+      Nstate x Nstate is allocated. \f$X = P M^T\f$ is computed row by row,
+      from the last row, and its upper part overwrites the rows of \f$P\f$
+      that are no longer needed; its strictly lower part is stored in
+      'packed_lower_part_'. \f$M X\f$ is then computed column by column,
+      from the last column, and the upper part of its column \f$j\f$
+      overwrites the row \f$j\f$ of \f$X\f$, which is no longer needed.
+      The vectors are processed by chunks, all read before any is written.
+    */
+    template <class Model, class ObservationManager>
+    void ExtendedKalmanFilter<Model, ObservationManager>
+    ::PropagateCovarianceMatrix_packed()
+    {
+        double saved_time = model_.GetTime();
+        model_.SetTime(time_);
+
+        Matrix<Ts, Symmetric, RowSymPacked>& P = packed_state_error_variance_;
+        Matrix<Ts, Symmetric, RowSymPacked>& X_lower = packed_lower_part_;
+
+        // Number of vectors processed at once.
+        int Nchunk = min(Nstate_, 32 * Nthread_);
+        Matrix<Ts> chunk;
+
+        // The row k of X is M P(:, k). P(:, k) is stored in the rows 0 to k
+        // of P, and the rows k to Nstate_ - 1 are free once it is read.
+        for (int last = Nstate_; last > 0; last -= Nchunk)
+        {
+            int first = max(0, last - Nchunk);
+            chunk.Reallocate(last - first, Nstate_);
+            for (int k = first; k < last; k++)
+                for (int i = 0; i < Nstate_; i++)
+                    chunk(k - first, i) = P(i, k);
+
+            ApplyTangentLinearOperatorBlock(chunk, false, chunk, false);
+
+            for (int k = first; k < last; k++)
+            {
+                for (int j = 0; j < k; j++)
+                    X_lower(j, k - 1) = chunk(k - first, j);
+                for (int j = k; j < Nstate_; j++)
+                    P(k, j) = chunk(k - first, j);
+            }
+        }
+
+        // The column j of M X is the row j of M P M'. X(:, j) is stored in
+        // the rows 0 to j of P and in 'X_lower', and the row j of P is free
+        // once it is read.
+        for (int last = Nstate_; last > 0; last -= Nchunk)
+        {
+            int first = max(0, last - Nchunk);
+            chunk.Reallocate(last - first, Nstate_);
+            for (int j = first; j < last; j++)
+            {
+                for (int k = 0; k <= j; k++)
+                    chunk(j - first, k) = P(k, j);
+                for (int k = j + 1; k < Nstate_; k++)
+                    chunk(j - first, k) = X_lower(j, k - 1);
+            }
+
+            ApplyTangentLinearOperatorBlock(chunk, false, chunk, false);
+
+            for (int j = first; j < last; j++)
+                for (int k = j; k < Nstate_; k++)
+                    P(j, k) = chunk(j - first, k);
+        }
+
+        if (model_.GetErrorVariance().GetM() != 0
+            && model_.GetErrorVariance().GetN() != 0)
+            AddUpperPart(Ts(1.), model_.GetErrorVariance(),
+                         packed_state_error_variance_);
+
+        model_.SetTime(saved_time);
+    }
+
+
+    //! Propagates the factor of the state error covariance.
+    /*! The tangent linear model is applied to the \f$r\f$ columns of the
+      factor \f$S\f$ only, so that \f$M P M^T = (M S) (M S)^T\f$ costs
+      \f$r\f$ applications of the tangent linear model instead of
+      \f$2n\f$. With model error, the factor \f$[M S, S_Q]\f$ is
+      truncated back to rank \f$r\f$.
+    */
+    template <class Model, class ObservationManager>
+    void ExtendedKalmanFilter<Model, ObservationManager>
+    ::PropagateCovarianceMatrix_low_rank()
+    {
+        double saved_time = model_.GetTime();
+        model_.SetTime(time_);
+
+        ApplyTangentLinearOperatorBlock(covariance_factor_, true,
+                                        covariance_factor_, true);
+
+        int Nmode = covariance_factor_.GetN();
+
+        if (model_error_factor_.GetN() != 0)
+        {
+            int Nerror_mode = model_error_factor_.GetN();
+            Matrix<Ts> augmented_factor(Nstate_, Nmode + Nerror_mode);
+            for (int i = 0; i < Nstate_; i++)
+            {
+                for (int j = 0; j < Nmode; j++)
+                    augmented_factor(i, j) = covariance_factor_(i, j);
+                for (int j = 0; j < Nerror_mode; j++)
+                    augmented_factor(i, Nmode + j) = model_error_factor_(i, j);
+            }
+            TruncateCovarianceFactor(augmented_factor, covariance_rank_,
+                                     covariance_factor_);
+        }
+
+        model_.SetTime(saved_time);
+    }
+
+
+    //! Applies the tangent linear model to the rows or columns of a matrix.
+    /*! The vectors are shared among the master thread, which uses 'model_',
+      and the model copies, which are first set to the state and the time of
+      'model_'. Every vector is read and written once, so that \a target may
+      be \a source if both are accessed the same way.
+      \param[in] source the matrix whose rows or columns are the vectors.
+      \param[in] source_column are the vectors the columns of \a source?
+      Otherwise, they are its rows.
+      \param[out] target the images of the vectors, as rows or columns.
+      \param[in] target_column should the images be written in the columns
+      of \a target? Otherwise, they are written in its rows.
+    */
+    template <class Model, class ObservationManager>
+    template <class source_matrix, class target_matrix>
+    void ExtendedKalmanFilter<Model, ObservationManager>
+    ::ApplyTangentLinearOperatorBlock(const source_matrix& source,
+                                      bool source_column,
+                                      target_matrix& target,
+                                      bool target_column)
+    {
+        int Nvector = source_column ? source.GetN() : source.GetM();
+        int Nworker = min(int(model_clone_.size()) + 1, max(Nvector, 1));
+        if (Nworker == 1)
+        {
+            ApplyTangentLinearOperatorBlock(model_, source, source_column,
+                                            0, Nvector, target,
+                                            target_column);
+            return;
+        }
+
+        for (int t = 0; t < Nworker - 1; t++)
+        {
+            Model& model = *model_clone_[t];
+            model.GetFullState().Copy(model_.GetFullState());
+            model.FullStateUpdated();
+            model.SetTime(model_.GetTime());
+        }
+
+        exception_ptr error;
+#pragma omp parallel for num_threads(Nworker) schedule(static, 1)
+        for (int t = 0; t < Nworker; t++)
+        {
+            try
+            {
+                int first = t * Nvector / Nworker;
+                int last = (t + 1) * Nvector / Nworker;
+                Model& model = t == 0 ? model_ : *model_clone_[t - 1];
+                ApplyTangentLinearOperatorBlock(model, source, source_column,
+                                                first, last, target,
+                                                target_column);
+            }
+            catch (...)
+            {
+#pragma omp critical(verdandi_ekf_tangent_linear)
+                if (!error)
+                    error = current_exception();
+            }
+        }
+        if (error)
+            rethrow_exception(error);
+    }
+
+
+    //! Applies the tangent linear model to a slice of rows or columns.
+    /*!
+      \param[in] model the model instance to be used.
+      \param[in] source the matrix whose rows or columns are the vectors.
+      \param[in] source_column are the vectors the columns of \a source?
+      \param[in] first index of the first vector.
+      \param[in] last index after the last vector.
+      \param[out] target the images of the vectors, as rows or columns.
+      \param[in] target_column should the images be written in the columns
+      of \a target?
+    */
+    template <class Model, class ObservationManager>
+    template <class source_matrix, class target_matrix>
+    void ExtendedKalmanFilter<Model, ObservationManager>
+    ::ApplyTangentLinearOperatorBlock(Model& model,
+                                      const source_matrix& source,
+                                      bool source_column,
+                                      int first, int last,
+                                      target_matrix& target,
+                                      bool target_column)
+    {
+        model_state_error_variance_row column;
+        for (int j = first; j < last; j++)
+        {
+            if (source_column)
+                GetCol(source, j, column);
+            else
+                GetRow(source, j, column);
+            model.ApplyTangentLinearOperator(column);
+            SetTangentLinearImage(column, j, target, target_column);
+        }
+    }
+
+
+    //! Writes the image of a vector in a row or a column of a matrix.
+    /*! The writes are serialized, since inserting a row or a column in a
+      sparse matrix may reallocate it.
+      \param[in] image the image of the vector.
+      \param[in] j index of the row or column to be written.
+      \param[in,out] target the matrix.
+      \param[in] target_column should \a image be written in the column \a
+      j? Otherwise, it is written in the row \a j.
+    */
+    template <class Model, class ObservationManager>
+    template <class target_matrix>
+    void ExtendedKalmanFilter<Model, ObservationManager>
+    ::SetTangentLinearImage(const model_state_error_variance_row& image,
+                            int j, target_matrix& target, bool target_column)
+    {
+#pragma omp critical(verdandi_ekf_tangent_linear_write)
+        {
+            if (target_column)
+                SetCol(image, j, target);
+            else
+                SetRow(image, j, target);
+        }
+    }
+
+
+    //! Writes the image of a vector in a row or a column of a dense matrix.
+    /*! The threads write distinct rows or columns, which are not
+      reallocated, so that no lock is needed.
+      \param[in] image the image of the vector.
+      \param[in] j index of the row or column to be written.
+      \param[in,out] target the matrix.
+      \param[in] target_column should \a image be written in the column \a
+      j? Otherwise, it is written in the row \a j.
+    */
+    template <class Model, class ObservationManager>
+    template <class T0, class Prop0, class Allocator0>
+    void ExtendedKalmanFilter<Model, ObservationManager>
+    ::SetTangentLinearImage(const model_state_error_variance_row& image,
+                            int j,
+                            Matrix<T0, Prop0, RowMajor, Allocator0>& target,
+                            bool target_column)
+    {
+        if (target_column)
+            SetCol(image, j, target);
+        else
+            SetRow(image, j, target);
+    }
+
+
+    //! Writes the image of a vector in a row of a symmetric matrix.
+    /*! Only the upper part of the row, that is, the elements \f$(j, k)\f$
+      with \f$k \ge j\f$, is written, so that every element is written by a
+      single row and the threads need no lock. The lower part of the row is
+      written, as the upper part of the previous rows, by the threads that
+      handle these rows.
+      \param[in] image the image of the vector.
+      \param[in] j index of the row to be written.
+      \param[in,out] target the matrix.
+      \param[in] target_column ignored, since the row \a j of a symmetric
+      matrix is also its column \a j.
+    */
+    template <class Model, class ObservationManager>
+    template <class T0, class Prop0, class Allocator0>
+    void ExtendedKalmanFilter<Model, ObservationManager>
+    ::SetTangentLinearImage(const model_state_error_variance_row& image,
+                            int j,
+                            Matrix<T0, Prop0, RowSymPacked, Allocator0>&
+                            target, bool target_column)
+    {
+        for (int k = j; k < target.GetN(); k++)
+            target(j, k) = image(k);
+    }
+
+
     //! Computes BLUE for Extended Kalman Filter.
     /*! The state is updated by the combination of background state and
       innovation. It computes the BLUE (best linear unbiased estimator).
@@ -389,7 +729,16 @@ namespace Verdandi
     void ExtendedKalmanFilter<Model, ObservationManager>
     ::ComputeBLUE(const observation& innovation, model_state& state)
     {
-        if (blue_computation_ == "vector")
+        if (covariance_computation_ == "low_rank")
+            ComputeBLUE_low_rank(innovation, state);
+        else if (covariance_computation_ == "packed")
+            ComputeBLUE_matrix(packed_state_error_variance_,
+                               observation_manager_.
+                               GetTangentLinearOperator(),
+                               innovation,
+                               observation_manager_.GetErrorVariance(),
+                               state, true, true);
+        else if (blue_computation_ == "vector")
             throw ErrorUndefined("ExtendedKalmanFilter"
                                  "::ComputeBLUE()");
         else
@@ -402,6 +751,204 @@ namespace Verdandi
     }
 
 
+    //! Computes BLUE with the factored state error covariance.
+    /*! With \f$P = S S^T\f$, the analysis is carried out in the space of
+      the \f$r\f$ modes: \f$x^a = x^f + S (I + C)^{-1} (H S)^T R^{-1} d\f$
+      and \f$S^a = S (I + C)^{-1/2}\f$, where \f$C = (H S)^T R^{-1} H
+      S\f$, so that \f$S^a {S^a}^T = P - P H^T (H P H^T + R)^{-1} H P\f$.
+      Only matrices of size \f$r \times r\f$ are factorized. The factor is
+      finally orthogonalized and truncated with a singular value
+      decomposition.
+      \param[in] innovation the innovation vector.
+      \param[in,out] state the state vector to analyze.
+    */
+    template <class Model, class ObservationManager>
+    void ExtendedKalmanFilter<Model, ObservationManager>
+    ::ComputeBLUE_low_rank(const observation& innovation, model_state& state)
+    {
+        int Nmode = covariance_factor_.GetN();
+
+        // Computes HS and R^{-1} HS.
+        Matrix<Ts> HS;
+        observation_manager_.ApplyTangentLinearOperator(covariance_factor_,
+                                                        HS);
+        Matrix<Ts> R_inv_HS(HS.GetM(), Nmode);
+        Mlt(observation_manager_.GetErrorVarianceInverse(), HS, R_inv_HS);
+
+        // Computes the eigen decomposition of I + (HS)' R^{-1} HS.
+        Matrix<Ts> working_matrix(Nmode, Nmode);
+        working_matrix.SetIdentity();
+        MltAdd(Ts(1), SeldonTrans, HS, SeldonNoTrans, R_inv_HS, Ts(1),
+               working_matrix);
+        Vector<Ts> lambda;
+        Matrix<Ts> U, U_trans;
+        GetSVD(working_matrix, lambda, U, U_trans);
+
+        // Computes w = (I + C)^{-1} (HS)' R^{-1} d and x = x + S w.
+        Vector<Ts> mode_innovation(Nmode), w(Nmode), Uw(Nmode);
+        MltAdd(Ts(1), SeldonTrans, R_inv_HS, innovation, Ts(0),
+               mode_innovation);
+        MltAdd(Ts(1), SeldonTrans, U, mode_innovation, Ts(0), Uw);
+        for (int q = 0; q < Nmode; q++)
+            Uw(q) /= lambda(q);
+        MltAdd(Ts(1), U, Uw, Ts(0), w);
+        MltAdd(Ts(1), covariance_factor_, w, Ts(1), state);
+
+        // Computes S = S U (I + Gamma)^{-1/2} U'.
+        Matrix<Ts> U_scaled(U);
+        for (int m = 0; m < Nmode; m++)
+            for (int q = 0; q < Nmode; q++)
+                U_scaled(m, q) /= sqrt(lambda(q));
+        MltAdd(Ts(1), SeldonNoTrans, U_scaled, SeldonTrans, U, Ts(0),
+               working_matrix);
+        Matrix<Ts> analysis_factor(Nstate_, Nmode);
+        MltAdd(Ts(1), covariance_factor_, working_matrix, Ts(0),
+               analysis_factor);
+
+        TruncateCovarianceFactor(analysis_factor, covariance_rank_,
+                                 covariance_factor_);
+    }
+
+
+    //! Computes a low-rank factor of a covariance matrix.
+    /*! The factor \f$S\f$ is made of the \f$r\f$ leading eigenvectors of
+      \f$P\f$, scaled by the square roots of the eigenvalues, so that \f$S
+      S^T\f$ is close to the best approximation of \f$P\f$ of rank \f$r\f$.
+      The eigenvectors are computed with a randomized subspace iteration
+      (Halko, Martinsson and Tropp, 2011): \f$P\f$ is only applied to
+      \f$r + 10\f$ vectors per iteration, and only a matrix of that size is
+      decomposed. With \f$r = n\f$, the factorization is exact.
+      \param[in] P the symmetric positive semi-definite matrix.
+      \param[in] rank the rank \f$r\f$ of the factor.
+      \param[out] S the factor, with \f$r\f$ columns.
+    */
+    template <class Model, class ObservationManager>
+    template <class MatrixType>
+    void ExtendedKalmanFilter<Model, ObservationManager>
+    ::ComputeLowRankFactor(const MatrixType& P, int rank, Matrix<Ts>& S)
+    {
+        int N = P.GetM();
+        rank = min(rank, N);
+        // The oversampling improves the accuracy of the leading modes.
+        int Nmode = min(N, rank + 10);
+        // Number of subspace iterations.
+        const int Niteration = 2;
+
+        // Random starting subspace. It is drawn from a local generator, the
+        // "minimal standard" of Park and Miller, so that the factor is
+        // reproducible and the stream of rand(), which the perturbation
+        // managers share, is left untouched.
+        Matrix<Ts> Q(N, Nmode), Y(N, Nmode);
+        double seed = 1.;
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < Nmode; j++)
+            {
+                seed = fmod(16807. * seed, 2147483647.);
+                Q(i, j) = Ts(seed / 2147483647.);
+            }
+
+        Vector<Ts> q, y(N);
+        for (int iteration = 0; ; iteration++)
+        {
+            // Y = P Q.
+            for (int j = 0; j < Nmode; j++)
+            {
+                GetCol(Q, j, q);
+                MltAdd(Ts(1), P, q, Ts(0), y);
+                SetCol(y, j, Y);
+            }
+            if (iteration == Niteration)
+                break;
+
+            // Q is an orthonormal basis of the range of Y, computed with the
+            // modified Gram-Schmidt process, applied twice. A column in the
+            // span of the previous ones is set to zero.
+            Q = Y;
+            for (int j = 0; j < Nmode; j++)
+            {
+                Ts norm_initial = Ts(0);
+                for (int i = 0; i < N; i++)
+                    norm_initial += Q(i, j) * Q(i, j);
+                for (int pass = 0; pass < 2; pass++)
+                    for (int k = 0; k < j; k++)
+                    {
+                        Ts product = Ts(0);
+                        for (int i = 0; i < N; i++)
+                            product += Q(i, k) * Q(i, j);
+                        for (int i = 0; i < N; i++)
+                            Q(i, j) -= product * Q(i, k);
+                    }
+                Ts norm = Ts(0);
+                for (int i = 0; i < N; i++)
+                    norm += Q(i, j) * Q(i, j);
+                Ts scale = norm <= Ts(100) * numeric_limits<Ts>::epsilon()
+                    * norm_initial ? Ts(0) : Ts(1) / sqrt(norm);
+                for (int i = 0; i < N; i++)
+                    Q(i, j) *= scale;
+            }
+        }
+
+        // Projection of P onto the subspace, Q' P Q, whose eigenvectors
+        // give those of P.
+        Matrix<Ts> projection(Nmode, Nmode);
+        MltAdd(Ts(1), SeldonTrans, Q, SeldonNoTrans, Y, Ts(0), projection);
+        for (int i = 0; i < Nmode; i++)
+            for (int j = i + 1; j < Nmode; j++)
+            {
+                projection(i, j) = Ts(.5) * (projection(i, j)
+                                             + projection(j, i));
+                projection(j, i) = projection(i, j);
+            }
+        Vector<Ts> lambda;
+        Matrix<Ts> U, U_trans;
+        GetSVD(projection, lambda, U, U_trans);
+
+        Matrix<Ts> U_leading(Nmode, rank);
+        for (int j = 0; j < rank; j++)
+        {
+            Ts scale = sqrt(max(lambda(j), Ts(0)));
+            for (int i = 0; i < Nmode; i++)
+                U_leading(i, j) = U(i, j) * scale;
+        }
+        S.Reallocate(N, rank);
+        MltAdd(Ts(1), Q, U_leading, Ts(0), S);
+    }
+
+
+    //! Truncates the factor of a covariance matrix.
+    /*! The factor \f$S\f$ is replaced with \f$S V\f$, where the columns
+      of \f$V\f$ are the leading eigenvectors of \f$S^T S\f$. Then \f$S V
+      (S V)^T\f$ is the best approximation of \f$S S^T\f$ of the required
+      rank, and the columns of \f$S V\f$ are orthogonal and sorted by
+      decreasing variance. Only a matrix of the size of the number of
+      columns of \f$S\f$ is decomposed.
+      \param[in] S the factor to be truncated.
+      \param[in] rank the maximum number of columns of the truncated factor.
+      \param[out] S_truncated the truncated factor. It should not be \a S.
+    */
+    template <class Model, class ObservationManager>
+    void ExtendedKalmanFilter<Model, ObservationManager>
+    ::TruncateCovarianceFactor(const Matrix<Ts>& S, int rank,
+                               Matrix<Ts>& S_truncated)
+    {
+        int Nmode = S.GetN();
+        rank = min(rank, Nmode);
+
+        Matrix<Ts> gram(Nmode, Nmode);
+        MltAdd(Ts(1), SeldonTrans, S, SeldonNoTrans, S, Ts(0), gram);
+        Vector<Ts> lambda;
+        Matrix<Ts> V, V_trans;
+        GetSVD(gram, lambda, V, V_trans);
+
+        Matrix<Ts> V_leading(Nmode, rank);
+        for (int i = 0; i < Nmode; i++)
+            for (int j = 0; j < rank; j++)
+                V_leading(i, j) = V(i, j);
+        S_truncated.Reallocate(S.GetM(), rank);
+        MltAdd(Ts(1), S, V_leading, Ts(0), S_truncated);
+    }
+
+
     //! Checks whether the model has finished.
     /*!
       \return True if no more data assimilation is required, false otherwise.
@@ -420,6 +967,10 @@ namespace Verdandi
     {
         if (covariance_computation_ == "vector")
             PropagateCovarianceMatrix_vector();
+        else if (covariance_computation_ == "low_rank")
+            PropagateCovarianceMatrix_low_rank();
+        else if (covariance_computation_ == "packed")
+            PropagateCovarianceMatrix_packed();
         else
             PropagateCovarianceMatrix_matrix();
     }
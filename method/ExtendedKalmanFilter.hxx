@@ -23,6 +23,9 @@
 #ifndef VERDANDI_FILE_EXTENDEDKALMANFILTER_HXX
 
 
+#include <exception>
+
+
 namespace Verdandi
 {
 
@@ -101,13 +104,41 @@ namespace Verdandi
         //! Current time.
         double time_;
 
+        /*! \brief Number of threads sharing the applications of the tangent
+          linear model in the covariance propagation. */
+        int Nthread_;
+        /*! \brief Copies of the model used by the threads other than the
+          master thread, which uses 'model_'. */
+        vector<Model*> model_clone_;
+
 
         model_state_error_variance temp_;
         //! Computation mode for BLUE: "vector" or "matrix".
         string blue_computation_;
-        //! Computation mode for covariance: "vector" or "matrix".
+        /*! \brief Computation mode for covariance: "vector", "matrix",
+          "packed" or "low_rank". */
         string covariance_computation_;
 
+        /*** Packed covariance ***/
+
+        /*! \brief Upper part of the state error covariance, in symmetric
+          packed storage ("packed"). */
+        Matrix<Ts, Symmetric, RowSymPacked> packed_state_error_variance_;
+        /*! \brief Strictly lower part of \f$P M^T\f$ during the covariance
+          propagation, in symmetric packed storage ("packed"). */
+        Matrix<Ts, Symmetric, RowSymPacked> packed_lower_part_;
+
+        /*** Low-rank covariance ***/
+
+        //! Rank of the factor of the state error covariance ("low_rank").
+        int covariance_rank_;
+        /*! \brief Factor \f$S\f$ of the state error covariance \f$P = S
+          S^T\f$, with one column per mode ("low_rank"). */
+        Matrix<Ts> covariance_factor_;
+        /*! \brief Factor of the model error covariance, computed at
+          initialization ("low_rank"). */
+        Matrix<Ts> model_error_factor_;
+
         /*** Output saver ***/
 
         //! Output saver.
@@ -141,8 +172,12 @@ namespace Verdandi
         void PropagateCovarianceMatrix();
         void PropagateCovarianceMatrix_vector();
         void PropagateCovarianceMatrix_matrix();
+        void PropagateCovarianceMatrix_packed();
+        void PropagateCovarianceMatrix_low_rank();
 
         void ComputeBLUE(const observation& innovation, model_state& state);
+        void ComputeBLUE_low_rank(const observation& innovation,
+                                  model_state& state);
 
         bool HasFinished();
 
@@ -153,6 +188,47 @@ namespace Verdandi
 
         string GetName() const;
         void Message(string message);
+
+    protected:
+
+        template <class source_matrix, class target_matrix>
+        void ApplyTangentLinearOperatorBlock(const source_matrix& source,
+                                             bool source_column,
+                                             target_matrix& target,
+                                             bool target_column);
+        template <class source_matrix, class target_matrix>
+        void ApplyTangentLinearOperatorBlock(Model& model,
+                                             const source_matrix& source,
+                                             bool source_column,
+                                             int first, int last,
+                                             target_matrix& target,
+                                             bool target_column);
+        template <class target_matrix>
+        void SetTangentLinearImage(const model_state_error_variance_row& image,
+                                   int j, target_matrix& target,
+                                   bool target_column);
+        template <class T0, class Prop0, class Allocator0>
+        void SetTangentLinearImage(const model_state_error_variance_row& image,
+                                   int j,
+                                   Matrix<T0, Prop0, RowMajor, Allocator0>&
+                                   target, bool target_column);
+        template <class T0, class Prop0, class Allocator0>
+        void SetTangentLinearImage(const model_state_error_variance_row& image,
+                                   int j,
+                                   Matrix<T0, Prop0, RowSymPacked,
+                                   Allocator0>& target, bool target_column);
+        template <class MatrixType>
+        void ComputeLowRankFactor(const MatrixType& P, int rank,
+                                  Matrix<Ts>& S);
+        void TruncateCovarianceFactor(const Matrix<Ts>& S, int rank,
+                                      Matrix<Ts>& S_truncated);
+
+    private:
+
+        // The model copies are owned by the driver, so that it cannot be
+        // copied.
+        ExtendedKalmanFilter(const ExtendedKalmanFilter&);
+        ExtendedKalmanFilter& operator=(const ExtendedKalmanFilter&);
     };
 
 
@@ -116,9 +116,10 @@ namespace Verdandi
             observation_manager_.Initialize(model_,
                                             observation_configuration_file_);
 
-        Copy(model_.GetStateErrorVariance(), G_);
         // TODO: Add conversion from variance to gain (tolerance region).
-        GetInverse(G_);
+        SymmetricFactorization<Ts> factorization;
+        factorization.Factorize(model_.GetStateErrorVariance());
+        factorization.GetInverse(G_);
 
 
         /***************************
@@ -191,10 +192,10 @@ namespace Verdandi
             {
                 Nobservation_ = observation_manager_.GetNobservation();
 
-                R_inv_ = observation_manager_.GetErrorVariance();
                 // TODO: Add conversion from variance to gain (tolerance
                 // region).
-                GetInverse(R_inv_);
+                R_factorization_
+                    .Factorize(observation_manager_.GetErrorVariance());
             }
             UpdateGain();
             ComputeEstimator();
@@ -262,8 +263,11 @@ namespace Verdandi
     {
         MessageHandler::Send(*this, "all", "::PropagateGain begin");
 
-        // Operations are carried out on the inverse of the gain.
-        GetInverse(G_);
+        // Operations are carried out on the inverse of the gain, which is
+        // computed from its Cholesky factorization.
+        SymmetricFactorization<Ts> factorization;
+        factorization.Factorize(G_);
+        factorization.GetInverse(G_);
 
         // Tangent linear model.
         model_tangent_linear_operator& M = model_.GetTangentLinearOperator();
@@ -280,7 +284,8 @@ namespace Verdandi
             Add(Ts(1), model_.GetErrorVariance(), G_);
 
         // Back to the gain.
-        GetInverse(G_);
+        factorization.Factorize(G_);
+        factorization.GetInverse(G_);
 
         MessageHandler::Send(*this, "all", "::PropagateGain end");
     }
@@ -305,9 +310,9 @@ namespace Verdandi
 
             Nobservation_ = observation_manager_.GetNobservation();
 
-            R_inv_ = observation_manager_.GetErrorVariance();
             // TODO: Add conversion from variance to gain (tolerance region).
-            GetInverse(R_inv_);
+            R_factorization_
+                .Factorize(observation_manager_.GetErrorVariance());
 
             UpdateGain();
             ComputeEstimator();
@@ -333,9 +338,16 @@ namespace Verdandi
         const observation_tangent_linear_operator& H
             = observation_manager_.GetTangentLinearOperator();
 
-        // Adds $H^T R^{-1} H$ to the gain.
+        // Adds $H^T R^{-1} H$ to the gain. The rows of $H^T R^{-1}$ are
+        // obtained by solving with the factorization of R.
         matrix_state_observation Ht_Rinv(Nstate_, Nobservation_);
-        MltAdd(Ts(1), SeldonTrans, H, SeldonNoTrans, R_inv_, Ts(0), Ht_Rinv);
+        Vector<Ts> column;
+        for (int j = 0; j < Nstate_; j++)
+        {
+            GetCol(H, j, column);
+            R_factorization_.Solve(column);
+            SetRow(column, j, Ht_Rinv);
+        }
         MltAdd(Ts(1), Ht_Rinv, H, Ts(1), G_);
 
         MessageHandler::Send(*this, "all", "::UpdateGain end");
@@ -344,8 +356,8 @@ namespace Verdandi
 
     //! Computes the estimator for the current time step.
     /*!
-      \warning This method must be called after 'UpdateGain', so that
-      'Ht_Rinv_' has been already computed.
+      \warning This method must be called after 'UpdateGain', and after R
+      has been factorized.
     */
     template <class Model, class ObservationManager>
     void ExtendedMinimaxFilter<Model, ObservationManager>::ComputeEstimator()
@@ -362,21 +374,19 @@ namespace Verdandi
         observation innovation = observation_manager_.GetObservation();
         MltAdd(Ts(-1), H, model_.GetState(), Ts(1), innovation);
 
-        // Adds $H^T R^{-1} H$ to the gain.
-        matrix_state_observation Ht_Rinv(Nstate_, Nobservation_);
-        MltAdd(Ts(1), SeldonTrans, H, SeldonNoTrans, R_inv_, Ts(0), Ht_Rinv);
-
         // $H^T R^{-1} (y - H x)$.
-        model_state Ht_Rinv_innovation(Nstate_), correction(Nstate_);
-        Mlt(Ht_Rinv, innovation, Ht_Rinv_innovation);
-
-        // Gets $G^{-1}$.
-        model_state_error_variance Ginv = G_;
-        GetInverse(Ginv);
-
-        // Adds the correction $G^{-1} H^T R^{-1} (y - H x)$ to the state
-        // vector.
-        MltAdd(Ts(1), Ginv, Ht_Rinv_innovation, Ts(1), model_.GetState());
+        R_factorization_.Solve(innovation);
+        model_state correction(Nstate_);
+        MltAdd(Ts(1), SeldonTrans, H, innovation, Ts(0), correction);
+
+        // $G^{-1} H^T R^{-1} (y - H x)$, with a Cholesky factorization of
+        // the gain.
+        SymmetricFactorization<Ts> G_factorization;
+        G_factorization.Factorize(G_);
+        G_factorization.Solve(correction);
+
+        // Adds the correction to the state vector.
+        Add(Ts(1), correction, model_.GetState());
 
         MessageHandler::Send(*this, "all", "::ComputeEstimator end");
     }
@@ -112,8 +112,8 @@ namespace Verdandi
 
         /*** Intermediate computations ***/
 
-        //! Stores R^{-1}.
-        observation_error_variance R_inv_;
+        //! Cholesky factorization of R, so that R^{-1} is never formed.
+        SymmetricFactorization<Ts> R_factorization_;
 
     public:
 
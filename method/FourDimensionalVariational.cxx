@@ -25,6 +25,7 @@
 #include "FourDimensionalVariational.hxx"
 
 #include "TrajectoryManager.cxx"
+#include "TrajectoryArena.cxx"
 
 #include "seldon/vector/VectorCollection.cxx"
 
@@ -45,7 +46,7 @@ namespace Verdandi
     template <class Model, class ObservationManager,
               class Optimization>
     FourDimensionalVariational<Model, ObservationManager,  Optimization>
-    ::FourDimensionalVariational(): iteration_(-1)
+    ::FourDimensionalVariational(): iteration_(-1), Nthread_(1)
     {
 
         /*** Initializations ***/
@@ -67,6 +68,11 @@ namespace Verdandi
     FourDimensionalVariational<Model, ObservationManager,  Optimization>
     ::~FourDimensionalVariational()
     {
+        for (size_t t = 0; t < model_clone_.size(); t++)
+        {
+            delete observation_manager_clone_[t];
+            delete model_clone_[t];
+        }
     }
 
 
@@ -183,6 +189,76 @@ namespace Verdandi
         Nstate_ = model_.GetNstate();
         Nobservation_  = observation_manager_.GetNobservation();
 
+        /*** Model constraint ***/
+
+        configuration.SetPrefix("four_dimensional_variational.");
+        configuration.Set("constraint", "ops_in(v, {'strong', 'weak'})",
+                          "strong", constraint_);
+        int Nparameter = Nstate_;
+        if (constraint_ == "weak")
+        {
+            configuration.Set("weak_constraint.Nsub_window", "v >= 1",
+                              Nsub_window_);
+            // Number of threads that share the sub-windows.
+            configuration.Set("weak_constraint.Nthread", "v >= 1", 1,
+                              Nthread_);
+#ifndef _OPENMP
+            if (Nthread_ > 1)
+                throw ErrorConfiguration("FourDimensionalVariational"
+                                         "::Initialize", "The sub-windows "
+                                         "are requested on "
+                                         + to_str(Nthread_) + " threads, "
+                                         "but Verdandi was compiled without "
+                                         "OpenMP.");
+#endif
+            Nparameter = Nsub_window_ * Nstate_;
+
+            // The model error covariance matrix is factorized once and for
+            // all. A diagonal matrix is used if the model provides none.
+            if (model_.GetErrorVariance().GetM() != 0
+                && model_.GetErrorVariance().GetN() != 0)
+                model_error_variance_factorization_
+                    .Factorize(model_.GetErrorVariance());
+            else
+                configuration.Set("weak_constraint.model_error_variance",
+                                  "v > 0", model_error_variance_);
+
+            // The additional threads integrate their sub-windows with their
+            // own instances of the model and of the observation manager,
+            // which can only be initialized like 'model_' and
+            // 'observation_manager_' if the driver initializes them.
+            for (size_t t = 0; t < model_clone_.size(); t++)
+            {
+                delete observation_manager_clone_[t];
+                delete model_clone_[t];
+            }
+            model_clone_.clear();
+            observation_manager_clone_.clear();
+            if (min(Nthread_, Nsub_window_) > 1
+                && (!initialize_model || !initialize_observation_manager))
+                throw ErrorConfiguration("FourDimensionalVariational"
+                                         "::Initialize", "The copies of the "
+                                         "model and of the observation "
+                                         "manager used by the additional "
+                                         "threads are initialized with their "
+                                         "configuration files, so that the "
+                                         "model and the observation manager "
+                                         "should also be initialized by the "
+                                         "driver when "
+                                         "\"weak_constraint.Nthread\" is "
+                                         "greater than 1.");
+            for (int t = 1; t < min(Nthread_, Nsub_window_); t++)
+            {
+                model_clone_.push_back(new Model);
+                model_clone_.back()->Initialize(model_configuration_file_);
+                observation_manager_clone_.push_back(new ObservationManager);
+                observation_manager_clone_.back()
+                    ->Initialize(*model_clone_.back(),
+                                 observation_configuration_file_);
+                observation_manager_clone_.back()->DiscardObservation(false);
+            }
+        }
+
         /*** Optimization initialization ***/
 
         configuration.SetPrefix("four_dimensional_variational.nlopt.");
@@ -193,7 +269,7 @@ namespace Verdandi
         configuration.Set("cost_function_tolerance", cost_function_tolerance);
         int Niteration_max;
         configuration.Set("Niteration_max", Niteration_max);
-        optimization_.Initialize(Nstate_, algorithm, parameter_tolerance,
+        optimization_.Initialize(Nparameter, algorithm, parameter_tolerance,
                                  cost_function_tolerance, Niteration_max);
 
 #ifdef VERDANDI_WITH_TRAJECTORY_MANAGER
@@ -216,19 +292,69 @@ namespace Verdandi
                           trajectory_recording_file);
         int Nskip_step;
         configuration.Set("Nskip_step", Nskip_step);
+        string checkpoint_schedule;
+        configuration.Set("checkpoint_schedule",
+                          "ops_in(v, {'uniform', 'binomial'})", "uniform",
+                          checkpoint_schedule);
+        int Ncheckpoint_max = 0;
+        if (checkpoint_schedule == "binomial")
+            configuration.Set("Ncheckpoint_max", "v > 0", Ncheckpoint_max);
         trajectory_manager_.Initialize(checkpoint_recording_mode,
                                        checkpoint_recording_file,
                                        trajectory_recording_mode,
                                        trajectory_recording_file,
-                                       Nskip_step);
+                                       Nskip_step, checkpoint_schedule,
+                                       Ncheckpoint_max);
 #endif
 
-        optimization_.SetLowerBound(model_.GetStateLowerBound());
-        optimization_.SetUpperBound(model_.GetStateUpperBound());
+        configuration.SetPrefix("four_dimensional_variational.");
+        configuration.Set("trajectory_precision",
+                          "ops_in(v, {'double', 'single'})", "double",
+                          trajectory_precision_);
+#ifndef VERDANDI_WITH_TRAJECTORY_MANAGER
+        trajectory_.Initialize(Nstate_, trajectory_precision_);
+#endif
+        linearization_trajectory_.Initialize(Nstate_, trajectory_precision_);
+
+        if (constraint_ == "weak")
+        {
+            // The bounds apply to the initial state of every sub-window.
+            model_state& lower_bound = model_.GetStateLowerBound();
+            model_state& upper_bound = model_.GetStateUpperBound();
+            model_state sub_window_lower_bound, sub_window_upper_bound;
+            if (lower_bound.GetM() != 0)
+            {
+                sub_window_lower_bound.Reallocate(Nparameter);
+                for (int k = 0; k < Nsub_window_; k++)
+                    for (int i = 0; i < Nstate_; i++)
+                        sub_window_lower_bound(k * Nstate_ + i)
+                            = lower_bound(i);
+            }
+            if (upper_bound.GetM() != 0)
+            {
+                sub_window_upper_bound.Reallocate(Nparameter);
+                for (int k = 0; k < Nsub_window_; k++)
+                    for (int i = 0; i < Nstate_; i++)
+                        sub_window_upper_bound(k * Nstate_ + i)
+                            = upper_bound(i);
+            }
+            optimization_.SetLowerBound(sub_window_lower_bound);
+            optimization_.SetUpperBound(sub_window_upper_bound);
+        }
+        else
+        {
+            optimization_.SetLowerBound(model_.GetStateLowerBound());
+            optimization_.SetUpperBound(model_.GetStateUpperBound());
+        }
 
         state_first_guess_.Reallocate(model_.GetNstate());
         Copy(model_.GetState(), state_first_guess_);
 
+        // The background term of the cost function only requires solves with
+        // B, so that B is factorized once and for all.
+        background_error_variance_factorization_
+            .Factorize(model_.GetStateErrorVariance());
+
         MessageHandler::Send(*this, "model", "initial condition");
         MessageHandler::Send(*this, "driver", "initial condition");
 
@@ -238,6 +364,30 @@ namespace Verdandi
                           "ops_in(v, {'element', 'matrix'})",
                           observation_tangent_linear_operator_access_);
 
+        configuration.Set("observation_access",
+                          "ops_in(v, {'step', 'window'})", "step",
+                          observation_access_);
+        window_observation_loaded_.assign(window_observation_loaded_.size(),
+                                          false);
+
+        configuration.Set("minimization",
+                          "ops_in(v, {'nonlinear', 'incremental'})",
+                          "nonlinear", minimization_);
+        if (minimization_ == "incremental")
+        {
+            configuration.Set("incremental.Nouter_loop", "v > 0",
+                              Nouter_loop_);
+            configuration.Set("incremental.Ninner_iteration_max", "v > 0",
+                              Ninner_iteration_max_);
+            configuration.Set("incremental.inner_tolerance", "v > 0",
+                              inner_tolerance_);
+            if (constraint_ == "weak")
+                throw ErrorConfiguration("FourDimensionalVariational"
+                                         "::Initialize", "The incremental "
+                                         "minimization is only available "
+                                         "with the strong constraint.");
+        }
+
         if (option_display_["iteration"])
             Logger::StdOut(*this, "Initialization");
         else
@@ -314,14 +464,30 @@ namespace Verdandi
             Logger::Log<-3>(*this,"Computing an analysis at time "
                             + to_str(model_.GetTime()));
 
-        model_state& x = model_.GetState();
-        optimization_.SetParameter(x);
-        Ncall_cost_ = 0;
-        optimization_.Optimize(StaticCost,
-                               reinterpret_cast<void*>(this));
-        optimization_.GetParameter(x);
-        model_.StateUpdated();
-        model_.SetTime(initial_time_);
+        // The observations loaded for the previous window are obsolete.
+        window_observation_loaded_.assign(window_observation_loaded_.size(),
+                                          false);
+
+        if (minimization_ == "incremental")
+            AnalyzeIncremental();
+        else if (constraint_ == "weak")
+            AnalyzeWeakConstraint();
+        else
+        {
+            model_state& x = model_.GetState();
+            optimization_.SetParameter(x);
+            Ncall_cost_ = 0;
+            optimization_.Optimize(StaticCost,
+                                   reinterpret_cast<void*>(this));
+            // Discards the linearization trajectory built by the Hessian
+            // products, if any. Its storage is kept for the next analysis.
+            linearization_trajectory_.Clear();
+            linearization_innovation_.clear();
+            linearization_state_.Clear();
+            optimization_.GetParameter(x);
+            model_.StateUpdated();
+            model_.SetTime(initial_time_);
+        }
 
         MessageHandler::Send(*this, "model", "analysis");
         MessageHandler::Send(*this, "observation_manager", "analysis");
@@ -475,7 +641,6 @@ namespace Verdandi
     FourDimensionalVariational<Model, ObservationManager,  Optimization>
     ::Cost(const model_state& x, model_state& gradient)
     {
-        Vector<double> time;
         if (option_display_["optimization_iteration"])
             Logger::StdOut(*this,
                            "Optimization iteration: " + to_str(Ncall_cost_));
@@ -489,47 +654,47 @@ namespace Verdandi
 
         /*** Background contribution ***/
 
-        model_state x_b(state_first_guess_);
-        Add(Ts(-1), x_b, delta);
+        Add(Ts(-1), state_first_guess_, delta);
 
-        model_state_error_variance B_inv(model_.GetStateErrorVariance());
-        GetInverse(B_inv);
-        MltAdd(Ts(1), B_inv, delta, Ts(0), x_b);
+        // Computes $B^{-1} (x - x_b)$.
+        model_state Binv_delta(delta);
+        background_error_variance_factorization_.Solve(Binv_delta);
 
         Ts cost_background;
-        cost_background = DotProd(delta, x_b);
+        cost_background = DotProd(delta, Binv_delta);
 
         /*** Observation contribution ***/
 
 #ifndef VERDANDI_WITH_TRAJECTORY_MANAGER
 
-        vector<model_state> trajectory;
+        // The trajectory storage is reused from the previous evaluation.
+        trajectory_.Clear();
 
         Ts cost_observation(0);
         Copy(x, model_.GetState());
         model_.StateUpdated();
         model_.SetTime(initial_time_);
+        int step = 0;
         while (!model_.HasFinished())
         {
             model_state& state = model_.GetState();
-            observation y, Rinv_y;
-            observation_manager_.SetTime(model_, model_.GetTime());
-            if (observation_manager_.HasObservation())
+            SetObservationStep(step);
+            if (HasStepObservation(step))
             {
-                observation& y = observation_manager_.GetInnovation(state);
+                observation& y = GetStepInnovation(step, state);
                 Nobservation_ = y.GetSize();
-                Rinv_y.Reallocate(Nobservation_);
-                observation_error_variance
-                    Rinv = observation_manager_.GetErrorVarianceInverse();
-                MltAdd(Ts(1), Rinv, y, Ts(0), Rinv_y);
-                cost_observation += DotProd(y, Rinv_y);
+                // Computes $y^T R^{-1} y$ in one pass, without copy.
+                cost_observation += QuadraticForm(
+                    observation_manager_.GetErrorVarianceInverse(), y);
             }
 
-            time.PushBack(model_.GetTime());
-            trajectory.push_back(state);
+            // The trajectory is only needed for the gradient.
+            if (with_gradient)
+                trajectory_.Save(model_.GetTime(), state);
 
             model_.InitializeStep();
             model_.Forward();
+            step++;
         }
 
         if (!with_gradient)
@@ -538,25 +703,21 @@ namespace Verdandi
 
         /*** Backward loop ***/
 
-        model_state adjoint_source(Nstate_);
+        model_state adjoint_source(Nstate_), trajectory_state(Nstate_);
         adjoint_source.Fill(Ts(0));
         model_.GetAdjointState().Fill(Ts(0));
         model_.AdjointStateUpdated();
-        for (int t = time.GetM() - 1; t >= 0; t--)
+        for (int t = trajectory_.GetNstep() - 1; t >= 0; t--)
         {
-            model_.SetTime(time(t));
-            observation Rinv_y;
-            observation_manager_.SetTime(model_, model_.GetTime());
-            if (observation_manager_.HasObservation())
+            model_.SetTime(trajectory_.GetTime(t));
+            trajectory_.Load(t, trajectory_state);
+            SetObservationStep(t);
+            if (HasStepObservation(t))
             {
-                observation& y =
-                    observation_manager_.GetInnovation(trajectory[t]);
-                Nobservation_ = y.GetSize();
-                Rinv_y.Reallocate(Nobservation_);
-                observation_error_variance
-                    Rinv(observation_manager_.GetErrorVarianceInverse());
-
-                MltAdd(Ts(1), Rinv, y, Ts(0), Rinv_y);
+                // The innovation is overwritten with $R^{-1} (y - H x)$.
+                observation& Rinv_y = GetStepInnovation(t, trajectory_state);
+                Nobservation_ = Rinv_y.GetSize();
+                observation_manager_.ApplyErrorVarianceInverse(Rinv_y);
 
                 if (observation_tangent_linear_operator_access_ == "matrix")
                     MltAdd(Ts(1), SeldonTrans, observation_manager_.
@@ -575,7 +736,7 @@ namespace Verdandi
             else
                 adjoint_source.Fill(Ts(0));
 
-            Copy(trajectory[t], model_.GetState());
+            Copy(trajectory_state, model_.GetState());
             model_.StateUpdated();
 
             model_.InitializeStep();
@@ -585,38 +746,42 @@ namespace Verdandi
         Copy(model_.GetAdjointState(), gradient);
         Add(Ts(1), model_.GetAdditionalAdjointTerm(), gradient);
         Mlt(Ts(-1), gradient);
-        Add(Ts(1), x_b, gradient);
+        Add(Ts(1), Binv_delta, gradient);
 
         return Ts(0.5) * (cost_background + cost_observation +
                           model_.GetAdditionalCostTerm());
 
 #else
 
+        Vector<double> time;
         Ts cost_observation(0);
         Copy(x, model_.GetState());
         model_.StateUpdated();
         model_.SetTime(initial_time_);
+        int step = 0;
         while (!model_.HasFinished())
         {
             model_state& state = model_.GetState();
-            observation Rinv_y;
-            observation_manager_.SetTime(model_, model_.GetTime());
-            if (observation_manager_.HasObservation())
+            SetObservationStep(step);
+            if (HasStepObservation(step))
             {
-                observation& y = observation_manager_.GetInnovation(state);
+                observation& y = GetStepInnovation(step, state);
                 Nobservation_ = y.GetSize();
-                Rinv_y.Reallocate(Nobservation_);
-                observation_error_variance
-                    Rinv = observation_manager_.GetErrorVarianceInverse();
-                MltAdd(Ts(1), Rinv, y, Ts(0), Rinv_y);
-                cost_observation += DotProd(y, Rinv_y);
+                // Computes $y^T R^{-1} y$ in one pass, without copy.
+                cost_observation += QuadraticForm(
+                    observation_manager_.GetErrorVarianceInverse(), y);
             }
 
-            time.PushBack(model_.GetTime());
-            trajectory_manager_.Save(state, model_.GetTime());
+            // The trajectory is only needed for the gradient.
+            if (with_gradient)
+            {
+                time.PushBack(model_.GetTime());
+                trajectory_manager_.Save(state, model_.GetTime());
+            }
 
             model_.InitializeStep();
             model_.Forward();
+            step++;
         }
 
         if (!with_gradient)
@@ -633,18 +798,14 @@ namespace Verdandi
         {
             model_.SetTime(time(t));
             trajectory_manager_.SetTime(model_, model_.GetTime());
-            observation Rinv_y;
-            observation_manager_.SetTime(model_, model_.GetTime());
-            if (observation_manager_.HasObservation())
+            SetObservationStep(t);
+            if (HasStepObservation(t))
             {
-                observation& y = observation_manager_.
-                    GetInnovation(trajectory_manager_.GetState());
-                Nobservation_ = y.GetSize();
-                Rinv_y.Reallocate(Nobservation_);
-                observation_error_variance
-                    Rinv(observation_manager_.GetErrorVarianceInverse());
-
-                MltAdd(Ts(1), Rinv, y, Ts(0), Rinv_y);
+                // The innovation is overwritten with $R^{-1} (y - H x)$.
+                observation& Rinv_y = GetStepInnovation(
+                    t, trajectory_manager_.GetState());
+                Nobservation_ = Rinv_y.GetSize();
+                observation_manager_.ApplyErrorVarianceInverse(Rinv_y);
 
                 if (observation_tangent_linear_operator_access_ == "matrix")
                     MltAdd(Ts(1), SeldonTrans, observation_manager_.
@@ -673,7 +834,9 @@ namespace Verdandi
         Copy(model_.GetAdjointState(), gradient);
         Add(Ts(1), model_.GetAdditionalAdjointTerm(), gradient);
         Mlt(Ts(-1), gradient);
-        Add(Ts(1), x_b, gradient);
+        Add(Ts(1), Binv_delta, gradient);
+        Logger::Log<-3>(*this, "Number of recomputed forward steps: "
+                        + to_str(trajectory_manager_.GetNrecomputedStep()));
         trajectory_manager_.Deallocate();
 
         return Ts(0.5) * (cost_background + cost_observation +
@@ -683,6 +846,107 @@ namespace Verdandi
     }
 
 
+    //! Cost function of the weak-constraint 4D-Var.
+    /*! The control vector gathers the initial states \f$x^k\f$ of the \f$K\f$
+      sub-windows. The cost function is
+      \f[ \frac 12 (x^0 - x_b)^T B^{-1} (x^0 - x_b) + \frac 12 \sum_h (y_h
+      - \mathcal{H}_h(x_h))^T R_h^{-1} (y_h - \mathcal{H}_h(x_h)) + \frac 12
+      \sum_{k = 1}^{K - 1} (x^k - \mathcal{M}^{k - 1}(x^{k - 1}))^T Q^{-1}
+      (x^k - \mathcal{M}^{k - 1}(x^{k - 1})), \f]
+      where \f$x_h\f$ is integrated from the initial state of its
+      sub-window, and \f$\mathcal{M}^{k - 1}(x^{k - 1})\f$ is the state at
+      the end of sub-window \f$k - 1\f$. The sub-windows are integrated
+      independently, forward and then backward with the adjoint model.
+      \param[in] x the initial states of the sub-windows, one after the
+      other.
+      \param[in, out] gradient vector that stores gradient values, on final
+      exit, it returns the gradient vector for optimized parameters.
+      \return the cost value at x.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    typename FourDimensionalVariational<Model, ObservationManager,
+    Optimization>::Ts
+    FourDimensionalVariational<Model, ObservationManager,  Optimization>
+    ::CostWeakConstraint(const model_state& x, model_state& gradient)
+    {
+        if (option_display_["optimization_iteration"])
+            Logger::StdOut(*this,
+                           "Optimization iteration: " + to_str(Ncall_cost_));
+        if (option_display_["optimized_parameter"])
+            Logger::StdOut(*this,
+                           "Optimized parameter: " + to_str(x));
+        Ncall_cost_++;
+
+        bool with_gradient = gradient.GetM() != 0;
+
+        for (int k = 0; k < Nsub_window_; k++)
+            for (int i = 0; i < Nstate_; i++)
+                sub_window_state_[k](i) = x(k * Nstate_ + i);
+
+        /*** Background contribution ***/
+
+        model_state delta(sub_window_state_[0]);
+        Add(Ts(-1), state_first_guess_, delta);
+
+        // Computes $B^{-1} (x^0 - x_b)$.
+        model_state Binv_delta(delta);
+        background_error_variance_factorization_.Solve(Binv_delta);
+
+        Ts cost_background;
+        cost_background = DotProd(delta, Binv_delta);
+
+        /*** Observation contribution ***/
+
+        PropagateSubWindow(false, with_gradient);
+
+        Ts cost_observation(0);
+        for (int k = 0; k < Nsub_window_; k++)
+            cost_observation += sub_window_cost_(k);
+
+        /*** Model error contribution ***/
+
+        // The adjoint state at the end of sub-window k is $Q^{-1} (x^{k + 1}
+        // - M^k(x^k))$.
+        Ts cost_model_error(0);
+        model_state jump(Nstate_);
+        for (int k = 0; k < Nsub_window_ - 1; k++)
+        {
+            Copy(sub_window_state_[k + 1], jump);
+            Add(Ts(-1), sub_window_final_state_[k], jump);
+            Copy(jump, sub_window_final_adjoint_[k]);
+            ApplyModelErrorVarianceInverse(sub_window_final_adjoint_[k]);
+            cost_model_error += DotProd(jump, sub_window_final_adjoint_[k]);
+        }
+        sub_window_final_adjoint_[Nsub_window_ - 1].Fill(Ts(0));
+
+        Ts cost = Ts(0.5) * (cost_background + cost_observation
+                             + cost_model_error
+                             + model_.GetAdditionalCostTerm());
+
+        if (!with_gradient)
+            return cost;
+
+        /*** Backward loop ***/
+
+        PropagateSubWindow(true);
+
+        for (int k = 0; k < Nsub_window_; k++)
+        {
+            const model_state& jump_term = k == 0 ?
+                Binv_delta : sub_window_final_adjoint_[k - 1];
+            for (int i = 0; i < Nstate_; i++)
+                gradient(k * Nstate_ + i) = jump_term(i)
+                    - sub_window_adjoint_[k](i);
+        }
+        model_state& additional_term = model_.GetAdditionalAdjointTerm();
+        for (int i = 0; i < additional_term.GetM(); i++)
+            gradient(i) -= additional_term(i);
+
+        return cost;
+    }
+
+
     //! Constraint function.
     /*
       \param[in] x vector that stores constraints parameters values.
@@ -737,6 +1001,29 @@ namespace Verdandi
     }
 
 
+    //! Static cost function of the weak-constraint 4D-Var.
+    /*
+      \param[in] x vector that stores parameters values.
+      \param[in,out] gradient vector that stores gradient values, on final
+      exit, it returns the gradient vector for optimized parameters.
+      \param[in] parameter the current FourDimensionalVariational<Model,
+      ObservationManager,  Optimization> object.
+      \return the cost value at x.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    typename FourDimensionalVariational<Model, ObservationManager,
+    Optimization>::Ts
+    FourDimensionalVariational<Model, ObservationManager,  Optimization>
+    ::StaticCostWeakConstraint(const model_state& x, model_state& gradient,
+                               void* this_object)
+    {
+        return reinterpret_cast<FourDimensionalVariational<Model,
+            ObservationManager, Optimization>* >(this_object)
+            ->CostWeakConstraint(x, gradient);
+    }
+
+
     //! Constraints.
     /*
       \param[in] x vector that stores constraints parameters values.
@@ -757,6 +1044,718 @@ namespace Verdandi
     }
 
 
+    //! Static Hessian-vector product.
+    /*
+      \param[in] x the state at which the Hessian is evaluated.
+      \param[in] direction the vector to which the Hessian is applied.
+      \param[out] hessian_direction the product of the Hessian with \a
+      direction.
+      \param[in] this_object the current FourDimensionalVariational<Model,
+      ObservationManager,  Optimization> object.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    void FourDimensionalVariational<Model, ObservationManager,
+                                    Optimization>
+    ::StaticHessian(const model_state& x, const model_state& direction,
+                    model_state& hessian_direction, void* this_object)
+    {
+        reinterpret_cast<FourDimensionalVariational<Model,
+            ObservationManager, Optimization>* >(this_object)
+            ->ApplyHessian(x, direction, hessian_direction);
+    }
+
+
+    //! Applies the Hessian of the cost function.
+    /*! The Hessian is approximated by its Gauss-Newton part \f$B^{-1} +
+      \sum_h M_{0 \rightarrow h}^T H_h^T R_h^{-1} H_h M_{0 \rightarrow
+      h}\f$, where the tangent linear model is linearized around the
+      trajectory from \a x: the terms involving the second-order derivatives
+      of the model are neglected, since the model provides no second-order
+      adjoint. The linearization trajectory is only recomputed when \a x
+      changes, so that successive products at the same point, e.g., in a
+      truncated Newton method, only cost one tangent linear and one adjoint
+      integration each. On exit, the model is at the initial time with the
+      state \a x.
+      \param[in] x the state at which the Hessian is evaluated.
+      \param[in] direction the vector to which the Hessian is applied.
+      \param[out] hessian_direction the product of the Hessian with \a
+      direction.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    void FourDimensionalVariational<Model, ObservationManager,
+                                    Optimization>
+    ::ApplyHessian(const model_state& x, const model_state& direction,
+                   model_state& hessian_direction)
+    {
+        if (constraint_ == "weak")
+            throw ErrorProcessing("FourDimensionalVariational::ApplyHessian",
+                                  "The Hessian is not available with the "
+                                  "weak-constraint 4D-Var.");
+
+        bool same_state = linearization_state_.GetM() == x.GetM();
+        for (int i = 0; same_state && i < x.GetM(); i++)
+            same_state = linearization_state_(i) == x(i);
+        if (!same_state)
+            ComputeLinearizationTrajectory(x);
+
+        hessian_direction.Reallocate(Nstate_);
+        ApplyIncrementalHessian(direction, hessian_direction);
+    }
+
+
+    ////////////////////////
+    // INCREMENTAL 4D-VAR //
+    ////////////////////////
+
+
+    //! Computes an analysis with the incremental 4D-Var.
+    /*! Each outer loop integrates the nonlinear model from the current
+      estimate \f$x_k\f$, and the inner loop minimizes the quadratic cost
+      \f[ \frac 12 (x_k + \delta x - x_b)^T B^{-1} (x_k + \delta x - x_b)
+      + \frac 12 \sum_h (d_h - H_h M_{0 \rightarrow h} \delta x)^T R_h^{-1}
+      (d_h - H_h M_{0 \rightarrow h} \delta x), \f]
+      where \f$d_h\f$ is the innovation along the trajectory from \f$x_k\f$
+      and \f$M_{0 \rightarrow h}\f$ is the tangent linear model around this
+      trajectory. The minimum is searched with a conjugate gradient, which
+      only requires the tangent linear model and its adjoint. Then \f$x_{k+1}
+      = x_k + \delta x\f$.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    void FourDimensionalVariational<Model, ObservationManager,
+                                    Optimization>::AnalyzeIncremental()
+    {
+        model_state x(Nstate_);
+        Copy(model_.GetState(), x);
+
+        model_state increment(Nstate_), residual(Nstate_),
+            direction(Nstate_), hessian_direction(Nstate_);
+
+        for (int k = 0; k < Nouter_loop_; k++)
+        {
+            ComputeLinearizationTrajectory(x);
+
+            // Right-hand side: $\sum_h M_{0 \rightarrow h}^T H_h^T R_h^{-1}
+            // d_h - B^{-1} (x_k - x_b)$.
+            ApplyAdjointModel(linearization_innovation_, residual);
+            model_state background_term(x);
+            Add(Ts(-1), state_first_guess_, background_term);
+            background_error_variance_factorization_.Solve(background_term);
+            Add(Ts(-1), background_term, residual);
+
+            /*** Conjugate gradient ***/
+
+            increment.Fill(Ts(0));
+            Copy(residual, direction);
+            Ts residual_norm = DotProd(residual, residual);
+            Ts initial_residual_norm = residual_norm;
+            Ts tolerance = Ts(inner_tolerance_ * inner_tolerance_)
+                * residual_norm;
+            int iteration = 0;
+            while (iteration < Ninner_iteration_max_
+                   && residual_norm > tolerance)
+            {
+                ApplyIncrementalHessian(direction, hessian_direction);
+                Ts alpha = residual_norm
+                    / DotProd(direction, hessian_direction);
+                Add(alpha, direction, increment);
+                Add(-alpha, hessian_direction, residual);
+                Ts previous_residual_norm = residual_norm;
+                residual_norm = DotProd(residual, residual);
+                Mlt(residual_norm / previous_residual_norm, direction);
+                Add(Ts(1), residual, direction);
+                iteration++;
+            }
+
+            Add(Ts(1), increment, x);
+
+            string message = "Outer loop " + to_str(k) + ": "
+                + to_str(iteration) + " inner iterations";
+            if (initial_residual_norm != Ts(0))
+                message += ", relative residual "
+                    + to_str(sqrt(residual_norm / initial_residual_norm));
+            if (option_display_["optimization_iteration"])
+                Logger::StdOut(*this, message);
+            else
+                Logger::Log<-3>(*this, message);
+        }
+
+        linearization_trajectory_.Clear();
+        linearization_innovation_.clear();
+        linearization_state_.Clear();
+
+        model_.SetTime(initial_time_);
+        Copy(x, model_.GetState());
+        model_.StateUpdated();
+    }
+
+
+    //! Computes the trajectory around which the model is linearized.
+    /*! The nonlinear model is integrated from \a x over the assimilation
+      window. The trajectory and the innovations, multiplied by the inverse
+      of the observation error covariance matrix, are stored. On exit, the
+      model is back at the initial time.
+      \param[in] x the initial condition.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    void FourDimensionalVariational<Model, ObservationManager,
+                                    Optimization>
+    ::ComputeLinearizationTrajectory(const model_state& x)
+    {
+        linearization_trajectory_.Clear();
+        linearization_innovation_.clear();
+        linearization_state_.Reallocate(Nstate_);
+        Copy(x, linearization_state_);
+
+        Copy(x, model_.GetState());
+        model_.StateUpdated();
+        model_.SetTime(initial_time_);
+        int step = 0;
+        while (!model_.HasFinished())
+        {
+            model_state& state = model_.GetState();
+            linearization_trajectory_.Save(model_.GetTime(), state);
+            SetObservationStep(step);
+            if (HasStepObservation(step))
+            {
+                observation& Rinv_y = GetStepInnovation(step, state);
+                Nobservation_ = Rinv_y.GetSize();
+                observation_manager_.ApplyErrorVarianceInverse(Rinv_y);
+                linearization_innovation_.push_back(Rinv_y);
+            }
+            else
+                linearization_innovation_.push_back(observation());
+
+            model_.InitializeStep();
+            model_.Forward();
+            step++;
+        }
+
+        model_.SetTime(initial_time_);
+        Copy(x, model_.GetState());
+        model_.StateUpdated();
+    }
+
+
+    //! Applies the tangent linear model and observation operators.
+    /*! The increment is propagated along the linearization trajectory.
+      \param[in] increment the increment \f$\delta x\f$ at initial time.
+      \param[out] Rinv_H_increment \f$R_h^{-1} H_h M_{0 \rightarrow h}
+      \delta x\f$ at every time step (empty vectors where there is no
+      observation).
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    void FourDimensionalVariational<Model, ObservationManager,
+                                    Optimization>
+    ::ApplyTangentLinearModel(const model_state& increment,
+                              vector<observation>& Rinv_H_increment)
+    {
+        int Ntime = linearization_trajectory_.GetNstep();
+        Rinv_H_increment.resize(Ntime);
+
+        model_state dx(increment);
+        for (int t = 0; t < Ntime; t++)
+        {
+            model_.SetTime(linearization_trajectory_.GetTime(t));
+            linearization_trajectory_.Load(t, model_.GetState());
+            model_.StateUpdated();
+
+            // The linearization trajectory starts at the first step of the
+            // window, so that 't' is also the index of the step.
+            SetObservationStep(t);
+            if (HasStepObservation(t))
+            {
+                Nobservation_ = linearization_innovation_[t].GetSize();
+                observation& Rinv_H_dx = Rinv_H_increment[t];
+                Rinv_H_dx.Reallocate(Nobservation_);
+                observation_manager_.ApplyTangentLinearOperator(dx,
+                                                                Rinv_H_dx);
+                observation_manager_.ApplyErrorVarianceInverse(Rinv_H_dx);
+            }
+            else
+                Rinv_H_increment[t].Clear();
+
+            if (t < Ntime - 1)
+            {
+                model_.InitializeStep();
+                model_.ApplyTangentLinearOperator(dx);
+            }
+        }
+    }
+
+
+    //! Applies the adjoint of the tangent linear model and observations.
+    /*! The adjoint model is integrated backward along the linearization
+      trajectory.
+      \param[in] source the observation-space source term \f$w_h\f$ at every
+      time step (empty vectors where there is no observation).
+      \param[out] adjoint \f$\sum_h M_{0 \rightarrow h}^T H_h^T w_h\f$.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    void FourDimensionalVariational<Model, ObservationManager,
+                                    Optimization>
+    ::ApplyAdjointModel(const vector<observation>& source,
+                        model_state& adjoint)
+    {
+        model_state adjoint_source(Nstate_);
+        adjoint_source.Fill(Ts(0));
+        model_.GetAdjointState().Fill(Ts(0));
+        model_.AdjointStateUpdated();
+        for (int t = linearization_trajectory_.GetNstep() - 1; t >= 0; t--)
+        {
+            model_.SetTime(linearization_trajectory_.GetTime(t));
+            SetObservationStep(t);
+            if (HasStepObservation(t))
+            {
+                Nobservation_ = source[t].GetSize();
+                if (observation_tangent_linear_operator_access_ == "matrix")
+                    MltAdd(Ts(1), SeldonTrans, observation_manager_.
+                           GetTangentLinearOperator(), source[t], Ts(0),
+                           adjoint_source);
+                else // "element".
+                {
+                    adjoint_source.Fill(Ts(0));
+                    for (int i = 0; i < Nstate_; i++)
+                        for (int j = 0; j < Nobservation_; j++)
+                            adjoint_source(i) +=
+                                observation_manager_.
+                                GetTangentLinearOperator(j, i) * source[t](j);
+                }
+            }
+            else
+                adjoint_source.Fill(Ts(0));
+
+            linearization_trajectory_.Load(t, model_.GetState());
+            model_.StateUpdated();
+
+            model_.InitializeStep();
+            model_.BackwardAdjoint(adjoint_source);
+        }
+
+        adjoint.Reallocate(Nstate_);
+        Copy(model_.GetAdjointState(), adjoint);
+    }
+
+
+    //! Applies the Hessian of the quadratic cost of the inner loop.
+    /*!
+      \param[in] increment the increment \f$\delta x\f$.
+      \param[out] hessian_increment \f$(B^{-1} + \sum_h M_{0 \rightarrow
+      h}^T H_h^T R_h^{-1} H_h M_{0 \rightarrow h}) \delta x\f$.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    void FourDimensionalVariational<Model, ObservationManager,
+                                    Optimization>
+    ::ApplyIncrementalHessian(const model_state& increment,
+                              model_state& hessian_increment)
+    {
+        vector<observation> Rinv_H_increment;
+        ApplyTangentLinearModel(increment, Rinv_H_increment);
+        ApplyAdjointModel(Rinv_H_increment, hessian_increment);
+
+        model_state background_term(increment);
+        background_error_variance_factorization_.Solve(background_term);
+        Add(Ts(1), background_term, hessian_increment);
+    }
+
+
+    //////////////////
+    // OBSERVATIONS //
+    //////////////////
+
+
+    //! Sets the observation manager at a step of the assimilation window.
+    /*! With the "step" access, the observation manager is set at the current
+      time. With the "window" access, the observations of the step are only
+      read if they were not read earlier in the same assimilation window, so
+      that the observation manager is not called by the following
+      integrations.
+      \param[in] step the index of the step in the assimilation window. The
+      model must be at the time of this step.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    void FourDimensionalVariational<Model, ObservationManager,
+                                    Optimization>
+    ::SetObservationStep(int step)
+    {
+        double time = model_.GetTime();
+        if (observation_access_ == "step")
+        {
+            observation_manager_.SetTime(model_, time);
+            return;
+        }
+
+        if (step >= int(window_observation_.size()))
+        {
+            window_observation_.resize(step + 1);
+            window_observation_time_.Resize(step + 1);
+            window_observation_loaded_.resize(step + 1, false);
+        }
+        if (window_observation_loaded_[step]
+            && window_observation_time_(step) == time)
+            return;
+
+        observation& y = window_observation_[step];
+        observation_manager_.SetTime(model_, time);
+        if (observation_manager_.HasObservation())
+        {
+            const observation& observed = observation_manager_
+                .GetObservation();
+            y.Reallocate(observed.GetM());
+            Copy(observed, y);
+        }
+        else
+            y.Clear();
+        window_observation_time_(step) = time;
+        window_observation_loaded_[step] = true;
+    }
+
+
+    //! Indicates whether observations are available at a step.
+    /*!
+      \param[in] step the index of the step in the assimilation window. The
+      observation manager must have been set at this step with
+      SetObservationStep.
+      \return True if observations are available at the step, false
+      otherwise.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    bool FourDimensionalVariational<Model, ObservationManager,
+                                    Optimization>
+    ::HasStepObservation(int step)
+    {
+        if (observation_access_ == "step")
+            return observation_manager_.HasObservation();
+        return window_observation_[step].GetM() != 0;
+    }
+
+
+    //! Computes the innovation at a step.
+    /*! With the "window" access, the innovation \f$y_h - H_h x\f$ is
+      computed from the stored observations, in a buffer reused from step to
+      step. The observation operator and the observation error covariance
+      matrix are then assumed not to depend on time, since the observation
+      manager is not set at the step.
+      \param[in] step the index of the step in the assimilation window. The
+      observation manager must have been set at this step with
+      SetObservationStep.
+      \param[in] state the state at the step.
+      \return The innovation.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    typename FourDimensionalVariational<Model, ObservationManager,
+                                        Optimization>::observation&
+    FourDimensionalVariational<Model, ObservationManager, Optimization>
+    ::GetStepInnovation(int step, const model_state& state)
+    {
+        if (observation_access_ == "step")
+            return observation_manager_.GetInnovation(state);
+
+        const observation& y = window_observation_[step];
+        window_innovation_.Reallocate(y.GetM());
+        observation_manager_.ApplyOperator(state, window_innovation_);
+        Mlt(Ts(-1), window_innovation_);
+        Add(Ts(1), y, window_innovation_);
+        return window_innovation_;
+    }
+
+
+    ////////////////////////////
+    // WEAK-CONSTRAINT 4D-VAR //
+    ////////////////////////////
+
+
+    //! Computes an analysis with the weak-constraint 4D-Var.
+    /*! The window is split into sub-windows with about the same number of
+      steps. The initial states of the sub-windows are first taken along the
+      trajectory from the current state, and they are then optimized
+      together with CostWeakConstraint(). The analysis is the optimized
+      initial state of the first sub-window.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    void FourDimensionalVariational<Model, ObservationManager,
+                                    Optimization>::AnalyzeWeakConstraint()
+    {
+        model_state x(Nstate_);
+        Copy(model_.GetState(), x);
+
+        InitializeSubWindow();
+
+        model_state z(Nsub_window_ * Nstate_);
+        Copy(x, model_.GetState());
+        model_.StateUpdated();
+        model_.SetTime(initial_time_);
+        for (int k = 0, step = 0; k < Nsub_window_; k++)
+        {
+            for (; step < sub_window_first_step_[k]; step++)
+            {
+                model_.InitializeStep();
+                model_.Forward();
+            }
+            model_state& state = model_.GetState();
+            for (int i = 0; i < Nstate_; i++)
+                z(k * Nstate_ + i) = state(i);
+        }
+
+        /*** Optimization ***/
+
+        optimization_.SetParameter(z);
+        Ncall_cost_ = 0;
+        optimization_.Optimize(StaticCostWeakConstraint,
+                               reinterpret_cast<void*>(this));
+        optimization_.GetParameter(z);
+
+        for (int i = 0; i < Nstate_; i++)
+            x(i) = z(i);
+
+        sub_window_state_.clear();
+        sub_window_final_state_.clear();
+        sub_window_final_adjoint_.clear();
+        sub_window_adjoint_.clear();
+
+        model_.SetTime(initial_time_);
+        Copy(x, model_.GetState());
+        model_.StateUpdated();
+    }
+
+
+    //! Splits the assimilation window into sub-windows.
+    /*! The model is integrated over the assimilation window, from the
+      initial time, to find the times of its steps. The window is then split
+      into sub-windows with about the same number of steps, and the storage
+      of the sub-windows is allocated. On exit, the model is at the end of
+      the assimilation window.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    void FourDimensionalVariational<Model, ObservationManager,
+                                    Optimization>::InitializeSubWindow()
+    {
+        window_time_.Clear();
+        model_.SetTime(initial_time_);
+        while (!model_.HasFinished())
+        {
+            window_time_.PushBack(model_.GetTime());
+            model_.InitializeStep();
+            model_.Forward();
+        }
+        int Nstep = window_time_.GetM();
+        if (Nstep < Nsub_window_)
+            throw ErrorArgument("FourDimensionalVariational"
+                                "::InitializeSubWindow()",
+                                "The assimilation window has "
+                                + to_str(Nstep) + " steps, which cannot be "
+                                "split into " + to_str(Nsub_window_)
+                                + " sub-windows.");
+
+        sub_window_first_step_.resize(Nsub_window_ + 1);
+        for (int k = 0; k <= Nsub_window_; k++)
+            sub_window_first_step_[k] = k * Nstep / Nsub_window_;
+
+        sub_window_state_.assign(Nsub_window_, model_state(Nstate_));
+        sub_window_final_state_.assign(Nsub_window_, model_state(Nstate_));
+        sub_window_final_adjoint_.assign(Nsub_window_,
+                                         model_state(Nstate_));
+        sub_window_adjoint_.assign(Nsub_window_, model_state(Nstate_));
+        // The arenas are kept from one analysis to the next.
+        sub_window_trajectory_.resize(Nsub_window_);
+        for (int k = 0; k < Nsub_window_; k++)
+            sub_window_trajectory_[k].Initialize(Nstate_,
+                                                 trajectory_precision_);
+        sub_window_cost_.Reallocate(Nsub_window_);
+    }
+
+
+    //! Integrates all sub-windows, forward or backward.
+    /*! The sub-windows are split into contiguous slices, one per thread.
+      Every thread integrates its sub-windows with its own instances of the
+      model and of the observation manager. The master thread keeps the
+      first slice, and processes the sub-windows in reverse order, so that
+      'model_' ends with the first sub-window.
+      \param[in] backward if true, the adjoint model is integrated backward
+      with BackwardSubWindow(); otherwise, the model is integrated forward
+      with ForwardSubWindow().
+      \param[in] save_trajectory should the trajectories be stored during
+      the forward integration? They are required by the backward
+      integration.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    void FourDimensionalVariational<Model, ObservationManager,
+                                    Optimization>
+    ::PropagateSubWindow(bool backward, bool save_trajectory)
+    {
+        int Nworker = int(model_clone_.size()) + 1;
+        exception_ptr error;
+#pragma omp parallel for num_threads(Nworker) schedule(static, 1)
+        for (int t = 0; t < Nworker; t++)
+        {
+            try
+            {
+                Model& model = t == 0 ? model_ : *model_clone_[t - 1];
+                ObservationManager& observation_manager = t == 0 ?
+                    observation_manager_ : *observation_manager_clone_[t - 1];
+                int first = t * Nsub_window_ / Nworker;
+                int last = (t + 1) * Nsub_window_ / Nworker;
+                for (int k = last - 1; k >= first; k--)
+                    if (backward)
+                        BackwardSubWindow(model, observation_manager, k);
+                    else
+                        ForwardSubWindow(model, observation_manager, k,
+                                         save_trajectory);
+            }
+            catch (...)
+            {
+#pragma omp critical(verdandi_4dvar_sub_window)
+                if (!error)
+                    error = current_exception();
+            }
+        }
+        if (error)
+            rethrow_exception(error);
+    }
+
+
+    //! Integrates the model over a sub-window.
+    /*! The model is integrated from the initial state of the sub-window. The
+      observation term of the cost function, the final state of the
+      sub-window and, optionally, the trajectory are stored.
+      \param[in,out] model the model used for the integration.
+      \param[in,out] observation_manager the observation manager associated
+      with \a model.
+      \param[in] k index of the sub-window.
+      \param[in] save_trajectory should the trajectory be stored?
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    void FourDimensionalVariational<Model, ObservationManager,
+                                    Optimization>
+    ::ForwardSubWindow(Model& model, ObservationManager& observation_manager,
+                       int k, bool save_trajectory)
+    {
+        int first = sub_window_first_step_[k];
+        int last = sub_window_first_step_[k + 1];
+        TrajectoryArena<Ts>& trajectory = sub_window_trajectory_[k];
+        trajectory.Clear();
+
+        Ts cost_observation(0);
+        model.SetTime(window_time_(first));
+        Copy(sub_window_state_[k], model.GetState());
+        model.StateUpdated();
+        for (int step = first; step < last; step++)
+        {
+            model_state& state = model.GetState();
+            observation_manager.SetTime(model, model.GetTime());
+            if (observation_manager.HasObservation())
+            {
+                observation& y = observation_manager.GetInnovation(state);
+                cost_observation += QuadraticForm(
+                    observation_manager.GetErrorVarianceInverse(), y);
+            }
+
+            if (save_trajectory)
+                trajectory.Save(model.GetTime(), state);
+
+            model.InitializeStep();
+            model.Forward();
+        }
+
+        Copy(model.GetState(), sub_window_final_state_[k]);
+        sub_window_cost_(k) = cost_observation;
+    }
+
+
+    //! Integrates the adjoint model backward over a sub-window.
+    /*! The adjoint state starts from the model error term at the end of the
+      sub-window, and it is integrated backward along the trajectory stored
+      by ForwardSubWindow(), which is then released.
+      \param[in,out] model the model used for the integration.
+      \param[in,out] observation_manager the observation manager associated
+      with \a model.
+      \param[in] k index of the sub-window.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    void FourDimensionalVariational<Model, ObservationManager,
+                                    Optimization>
+    ::BackwardSubWindow(Model& model,
+                        ObservationManager& observation_manager, int k)
+    {
+        int first = sub_window_first_step_[k];
+        int last = sub_window_first_step_[k + 1];
+        TrajectoryArena<Ts>& trajectory = sub_window_trajectory_[k];
+
+        model_state adjoint_source(Nstate_), state(Nstate_);
+        Copy(sub_window_final_adjoint_[k], model.GetAdjointState());
+        model.AdjointStateUpdated();
+        for (int step = last - 1; step >= first; step--)
+        {
+            trajectory.Load(step - first, state);
+            model.SetTime(window_time_(step));
+            observation_manager.SetTime(model, model.GetTime());
+            if (observation_manager.HasObservation())
+            {
+                // The innovation is overwritten with $R^{-1} (y - H x)$.
+                observation& Rinv_y = observation_manager.GetInnovation(state);
+                int Nobservation = Rinv_y.GetSize();
+                observation_manager.ApplyErrorVarianceInverse(Rinv_y);
+
+                if (observation_tangent_linear_operator_access_ == "matrix")
+                    MltAdd(Ts(1), SeldonTrans, observation_manager.
+                           GetTangentLinearOperator(), Rinv_y, Ts(0),
+                           adjoint_source);
+                else // "element".
+                {
+                    adjoint_source.Fill(Ts(0));
+                    for (int i = 0; i < Nstate_; i++)
+                        for (int j = 0; j < Nobservation; j++)
+                            adjoint_source(i) +=
+                                observation_manager.
+                                GetTangentLinearOperator(j, i) * Rinv_y(j);
+                }
+            }
+            else
+                adjoint_source.Fill(Ts(0));
+
+            Copy(state, model.GetState());
+            model.StateUpdated();
+
+            model.InitializeStep();
+            model.BackwardAdjoint(adjoint_source);
+        }
+
+        Copy(model.GetAdjointState(), sub_window_adjoint_[k]);
+        trajectory.Clear();
+    }
+
+
+    //! Applies the inverse of the model error covariance matrix.
+    /*!
+      \param[in,out] x on entry, a state vector; on exit, \f$Q^{-1} x\f$.
+    */
+    template <class Model, class ObservationManager,
+              class Optimization>
+    void FourDimensionalVariational<Model, ObservationManager,
+                                    Optimization>
+    ::ApplyModelErrorVarianceInverse(model_state& x) const
+    {
+        if (model_error_variance_factorization_.IsFactorized())
+            model_error_variance_factorization_.Solve(x);
+        else
+            Mlt(Ts(1) / Ts(model_error_variance_), x);
+    }
+
+
 
 } // namespace Verdandi.
 
@@ -20,6 +20,9 @@
 #ifndef VERDANDI_FILE_METHOD_FOURDIMENSIONALVARIATIONAL_HXX
 
 #include "TrajectoryManager.hxx"
+#include "TrajectoryArena.hxx"
+
+#include <exception>
 
 namespace Verdandi
 {
@@ -103,18 +106,112 @@ namespace Verdandi
           or "matrix". */
         string observation_tangent_linear_operator_access_;
 
+        /*** Observations ***/
+
+        /*! \brief Access to the observations: "step" (the observation
+          manager is set and queried at every step of every integration) or
+          "window" (the observations of every step are loaded once per
+          assimilation window, and the innovations are computed from them).
+        */
+        string observation_access_;
+        /*! \brief Observations at the steps of the assimilation window
+          ("window"); empty vectors where there is no observation. */
+        vector<observation> window_observation_;
+        //! Times of the steps whose observations are stored ("window").
+        Vector<double> window_observation_time_;
+        /*! \brief Are the observations of the steps loaded for the current
+          assimilation window? ("window") */
+        vector<bool> window_observation_loaded_;
+        //! Innovation computed from the stored observations ("window").
+        observation window_innovation_;
+
         /*** Trajectory ***/
 
+        /*! \brief Precision of the trajectories stored in memory: "double"
+          (the states are stored as they are) or "single" (the states are
+          rounded to single precision, which halves the memory). */
+        string trajectory_precision_;
 #ifdef VERDANDI_WITH_TRAJECTORY_MANAGER
         //! Trajectory manager.
         TrajectoryManager<Model> trajectory_manager_;
+#else
+        /*! \brief Trajectory of the last cost evaluation. Its storage is
+          kept from one evaluation to the next. */
+        TrajectoryArena<Ts> trajectory_;
 #endif
 
         /*** Optimization ***/
 
+        /*! \brief Minimization: "nonlinear" (the optimizer minimizes the full
+          cost function) or "incremental" (outer loops relinearize the model,
+          and inner loops minimize a quadratic cost by conjugate gradient). */
+        string minimization_;
         Optimization optimization_;
 
+        /*** Incremental 4D-Var ***/
+
+        //! Number of outer loops.
+        int Nouter_loop_;
+        //! Maximum number of conjugate gradient iterations per outer loop.
+        int Ninner_iteration_max_;
+        //! Relative tolerance on the residual of the inner problem.
+        double inner_tolerance_;
+        /*! \brief Trajectory around which the model is linearized. Its
+          storage is kept from one outer loop to the next. */
+        TrajectoryArena<Ts> linearization_trajectory_;
+        /*! \brief Innovations along the linearization trajectory, multiplied
+          by the inverse of the observation error covariance matrix (empty
+          vectors where there is no observation). */
+        vector<observation> linearization_innovation_;
+        /*! \brief Initial state of the linearization trajectory (empty if
+          there is no linearization trajectory). */
+        model_state linearization_state_;
+
         model_state state_first_guess_;
+        /*! \brief Cholesky factorization of the background error covariance
+          matrix, computed once at initialization. */
+        SymmetricFactorization<Ts> background_error_variance_factorization_;
+
+        /*** Weak-constraint 4D-Var ***/
+
+        /*! \brief Model constraint: "strong" (the model is perfect, and the
+          initial state is controlled) or "weak" (multiple shooting: the
+          window is split into sub-windows whose initial states are
+          controlled, and the jumps between sub-windows are penalized with the
+          model error covariance matrix). */
+        string constraint_;
+        //! Number of sub-windows ("weak").
+        int Nsub_window_;
+        //! Number of threads sharing the sub-windows ("weak").
+        int Nthread_;
+        /*! \brief Copies of the model used by the threads other than the
+          master thread, which uses 'model_'. */
+        vector<Model*> model_clone_;
+        //! Copies of the observation manager, one per copy of the model.
+        vector<ObservationManager*> observation_manager_clone_;
+        /*! \brief Model error variance, used if the model provides no model
+          error covariance matrix. */
+        double model_error_variance_;
+        //! Cholesky factorization of the model error covariance matrix.
+        SymmetricFactorization<Ts> model_error_variance_factorization_;
+        //! Times of the steps of the assimilation window.
+        Vector<double> window_time_;
+        /*! \brief First step of every sub-window, followed by the number of
+          steps in the window. */
+        vector<int> sub_window_first_step_;
+        //! Initial states of the sub-windows.
+        vector<model_state> sub_window_state_;
+        //! States at the end of the sub-windows.
+        vector<model_state> sub_window_final_state_;
+        //! Observation terms of the cost function, for every sub-window.
+        Vector<Ts> sub_window_cost_;
+        //! Adjoint states at the end of the sub-windows.
+        vector<model_state> sub_window_final_adjoint_;
+        //! Adjoint states at the beginning of the sub-windows.
+        vector<model_state> sub_window_adjoint_;
+        /*! \brief Trajectories over the sub-windows, one arena per
+          sub-window so that the threads never share one. */
+        vector<TrajectoryArena<Ts> > sub_window_trajectory_;
 
         /*** Output saver ***/
 
@@ -156,14 +253,58 @@ namespace Verdandi
         void Message(string message);
 
         Ts Cost(const model_state& x, model_state& gradient);
+        Ts CostWeakConstraint(const model_state& x, model_state& gradient);
         Ts Constraint(const model_state& x, model_state& gradient);
+        void ApplyHessian(const model_state& x, const model_state& direction,
+                          model_state& hessian_direction);
 
         void SetInitialTime(double time);
 
         static Ts StaticCost(const model_state& x, model_state& gradient,
                             void* object);
+        static Ts StaticCostWeakConstraint(const model_state& x,
+                                          model_state& gradient,
+                                          void* object);
         static Ts StaticConstraint(const model_state& x,
                                   model_state& gradient, void* object);
+        static void StaticHessian(const model_state& x,
+                                  const model_state& direction,
+                                  model_state& hessian_direction,
+                                  void* object);
+
+    protected:
+
+        void AnalyzeIncremental();
+        void ComputeLinearizationTrajectory(const model_state& x);
+        void ApplyTangentLinearModel(const model_state& increment,
+                                     vector<observation>& Rinv_H_increment);
+        void ApplyAdjointModel(const vector<observation>& source,
+                               model_state& adjoint);
+        void ApplyIncrementalHessian(const model_state& increment,
+                                     model_state& hessian_increment);
+
+        void SetObservationStep(int step);
+        bool HasStepObservation(int step);
+        observation& GetStepInnovation(int step, const model_state& state);
+
+        void AnalyzeWeakConstraint();
+        void InitializeSubWindow();
+        void PropagateSubWindow(bool backward, bool save_trajectory = true);
+        void ForwardSubWindow(Model& model,
+                              ObservationManager& observation_manager,
+                              int k, bool save_trajectory);
+        void BackwardSubWindow(Model& model,
+                               ObservationManager& observation_manager,
+                               int k);
+        void ApplyModelErrorVarianceInverse(model_state& x) const;
+
+    private:
+
+        // The copies of the model and of the observation manager are
+        // owned by the driver, so that it cannot be copied.
+        FourDimensionalVariational(const FourDimensionalVariational&);
+        FourDimensionalVariational&
+        operator=(const FourDimensionalVariational&);
     };
 
 
@@ -0,0 +1,519 @@
+// Copyright (C) 2026
+// Author(s): agent
+//
+// This file is part of the data assimilation library Verdandi.
+//
+// Verdandi is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Verdandi is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Verdandi. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Verdandi web site:
+//      http://verdandi.gforge.inria.fr/
+
+
+#ifndef VERDANDI_FILE_METHOD_LBFGSSOLVER_CXX
+
+#include "LBFGSSolver.hxx"
+
+
+namespace Verdandi
+{
+
+
+    /////////////////
+    // CONSTRUCTOR //
+    /////////////////
+
+
+    //! Main constructor.
+    template <class T>
+    LBFGSSolver<T>::LBFGSSolver():
+        Nparameter_(0), parameter_tolerance_(1.e-6),
+        cost_function_tolerance_(1.e-6), Niteration_max_(-1), Npair_max_(10),
+        warm_start_(true), cost_(0), Npair_(0), first_pair_(0),
+        Niteration_(0), Nevaluation_(0)
+    {
+    }
+
+
+    /////////////
+    // METHODS //
+    /////////////
+
+
+    //! Initializes the solver.
+    /*!
+      \param[in] Nparameter number of parameters to be optimized.
+      \param[in] algorithm the optimization algorithm: "LBFGS" (or
+      "LD_LBFGS", as named by NLopt).
+      \param[in] parameter_tolerance relative tolerance on the parameters.
+      It is disabled if non-positive.
+      \param[in] cost_function_tolerance relative tolerance on the cost
+      function. It is disabled if non-positive.
+      \param[in] Niteration_max maximum number of cost function evaluations.
+      It is disabled if non-positive.
+    */
+    template <class T>
+    void LBFGSSolver<T>::Initialize(int Nparameter, string algorithm,
+                                    double parameter_tolerance,
+                                    double cost_function_tolerance,
+                                    int Niteration_max)
+    {
+        if (algorithm != "LBFGS" && algorithm != "LD_LBFGS")
+            throw ErrorArgument("LBFGSSolver::Initialize",
+                                "Unknown algorithm \"" + algorithm
+                                + "\": only \"LBFGS\" is available.");
+        Nparameter_ = Nparameter;
+        parameter_tolerance_ = parameter_tolerance;
+        cost_function_tolerance_ = cost_function_tolerance;
+        Niteration_max_ = Niteration_max;
+        lower_bound_.Clear();
+        upper_bound_.Clear();
+        parameter_.Reallocate(Nparameter_);
+        parameter_.Fill(T(0));
+        gradient_.Clear();
+        cost_ = T(0);
+        Niteration_ = 0;
+        Nevaluation_ = 0;
+        ClearPair();
+    }
+
+
+    //! Sets the maximum number of correction pairs.
+    /*! The stored correction pairs are discarded.
+      \param[in] Npair_max the maximum number of correction pairs.
+    */
+    template <class T>
+    void LBFGSSolver<T>::SetNpairMax(int Npair_max)
+    {
+        if (Npair_max < 1)
+            throw ErrorArgument("LBFGSSolver::SetNpairMax(int)",
+                                "At least one correction pair is required, "
+                                "but " + to_str(Npair_max)
+                                + " pairs were requested.");
+        Npair_max_ = Npair_max;
+        ClearPair();
+    }
+
+
+    //! Sets whether the correction pairs are kept between minimizations.
+    /*! With a warm start, a minimization starts with the approximation of
+      the inverse Hessian built by the previous one. This pays off when
+      successive problems are close, e.g., for successive assimilation
+      windows.
+      \param[in] warm_start true if the correction pairs should be kept.
+    */
+    template <class T>
+    void LBFGSSolver<T>::SetWarmStart(bool warm_start)
+    {
+        warm_start_ = warm_start;
+    }
+
+
+    //! Discards the stored correction pairs.
+    template <class T>
+    void LBFGSSolver<T>::ClearPair()
+    {
+        s_.Reallocate(Npair_max_, Nparameter_);
+        y_.Reallocate(Npair_max_, Nparameter_);
+        rho_.Reallocate(Npair_max_);
+        Npair_ = 0;
+        first_pair_ = 0;
+    }
+
+
+    //! Returns the number of stored correction pairs.
+    /*!
+      \return The number of stored correction pairs.
+    */
+    template <class T>
+    int LBFGSSolver<T>::GetNpair() const
+    {
+        return Npair_;
+    }
+
+
+    //! Sets the lower bounds of the parameters.
+    /*!
+      \param[in] lower_bound the lower bounds, or an empty vector for no
+      lower bound.
+    */
+    template <class T>
+    void LBFGSSolver<T>::SetLowerBound(const Vector<T>& lower_bound)
+    {
+        if (lower_bound.GetM() != 0 && lower_bound.GetM() != Nparameter_)
+            throw ErrorArgument("LBFGSSolver::SetLowerBound",
+                                "There are " + to_str(Nparameter_)
+                                + " parameters, but "
+                                + to_str(lower_bound.GetM())
+                                + " lower bounds.");
+        lower_bound_.Reallocate(lower_bound.GetM());
+        Copy(lower_bound, lower_bound_);
+    }
+
+
+    //! Sets the upper bounds of the parameters.
+    /*!
+      \param[in] upper_bound the upper bounds, or an empty vector for no
+      upper bound.
+    */
+    template <class T>
+    void LBFGSSolver<T>::SetUpperBound(const Vector<T>& upper_bound)
+    {
+        if (upper_bound.GetM() != 0 && upper_bound.GetM() != Nparameter_)
+            throw ErrorArgument("LBFGSSolver::SetUpperBound",
+                                "There are " + to_str(Nparameter_)
+                                + " parameters, but "
+                                + to_str(upper_bound.GetM())
+                                + " upper bounds.");
+        upper_bound_.Reallocate(upper_bound.GetM());
+        Copy(upper_bound, upper_bound_);
+    }
+
+
+    //! Sets the relative tolerance on the parameters.
+    /*!
+      \param[in] tolerance the relative tolerance on the parameters. It is
+      disabled if non-positive.
+    */
+    template <class T>
+    void LBFGSSolver<T>::SetParameterTolerance(double tolerance)
+    {
+        parameter_tolerance_ = tolerance;
+    }
+
+
+    //! Sets the relative tolerance on the cost function.
+    /*!
+      \param[in] tolerance the relative tolerance on the cost function. It
+      is disabled if non-positive.
+    */
+    template <class T>
+    void LBFGSSolver<T>::SetCostFunctionTolerance(double tolerance)
+    {
+        cost_function_tolerance_ = tolerance;
+    }
+
+
+    //! Sets the maximum number of cost function evaluations.
+    /*!
+      \param[in] Niteration_max the maximum number of cost function
+      evaluations. It is disabled if non-positive.
+    */
+    template <class T>
+    void LBFGSSolver<T>::SetNiterationMax(int Niteration_max)
+    {
+        Niteration_max_ = Niteration_max;
+    }
+
+
+    //! Sets the parameters, i.e., the starting point of the minimization.
+    /*!
+      \param[in] parameter the parameters.
+    */
+    template <class T>
+    void LBFGSSolver<T>::SetParameter(const Vector<T>& parameter)
+    {
+        if (parameter.GetM() != Nparameter_)
+            throw ErrorArgument("LBFGSSolver::SetParameter",
+                                "There are " + to_str(Nparameter_)
+                                + " parameters, but the vector has "
+                                + to_str(parameter.GetM()) + " elements.");
+        Copy(parameter, parameter_);
+    }
+
+
+    //! Gets the parameters.
+    /*!
+      \param[out] parameter the parameters, i.e., the minimizer after
+      Optimize() has been called.
+    */
+    template <class T>
+    void LBFGSSolver<T>::GetParameter(Vector<T>& parameter) const
+    {
+        parameter.Reallocate(Nparameter_);
+        Copy(parameter_, parameter);
+    }
+
+
+    //! Returns the cost function at the parameters.
+    /*!
+      \return The cost function at the minimizer, after Optimize() has been
+      called.
+    */
+    template <class T>
+    T LBFGSSolver<T>::GetCost() const
+    {
+        return cost_;
+    }
+
+
+    //! Returns the number of iterations of the last minimization.
+    /*!
+      \return The number of iterations of the last minimization.
+    */
+    template <class T>
+    int LBFGSSolver<T>::GetNiteration() const
+    {
+        return Niteration_;
+    }
+
+
+    //! Returns the number of evaluations of the last minimization.
+    /*!
+      \return The number of cost function evaluations of the last
+      minimization.
+    */
+    template <class T>
+    int LBFGSSolver<T>::GetNevaluation() const
+    {
+        return Nevaluation_;
+    }
+
+
+    //! Minimizes the cost function.
+    /*! The minimization starts from the current parameters. At each
+      iteration, the search direction is given by the L-BFGS approximation of
+      the inverse Hessian, and the step is found by a backtracking line
+      search that enforces the Armijo condition. Only the first trial step
+      requests the gradient: the following ones only compute the cost, and
+      the gradient is computed once the step is accepted. The minimization
+      stops when a tolerance is reached, when the maximum number of
+      evaluations is reached, or when no decrease can be found.
+      \param[in] cost the cost function. It returns the cost at its first
+      argument, and fills its second argument with the gradient unless this
+      vector is empty. Its third argument is \a argument.
+      \param[in] argument an argument passed to the cost function.
+    */
+    template <class T>
+    void LBFGSSolver<T>::Optimize(cost_function cost, void* argument)
+    {
+        Niteration_ = 0;
+        Nevaluation_ = 0;
+        if (!warm_start_ || s_.GetN() != Nparameter_)
+            ClearPair();
+
+        Vector<T> x(parameter_);
+        Project(x);
+        Vector<T> g(Nparameter_);
+        T f = Evaluate(cost, argument, x, g);
+
+        Vector<T> direction(Nparameter_), x_new(Nparameter_),
+            g_new(Nparameter_), s(Nparameter_), y(Nparameter_), no_gradient;
+        while (Niteration_max_ <= 0 || Nevaluation_ < Niteration_max_)
+        {
+            /*** Search direction ***/
+
+            Copy(g, direction);
+            Mlt(T(-1), direction);
+            ApplyInverseHessian(direction);
+            T slope = DotProd(g, direction);
+            if (!(slope < T(0)))
+            {
+                // The pairs do not provide a descent direction.
+                ClearPair();
+                Copy(g, direction);
+                Mlt(T(-1), direction);
+                slope = DotProd(g, direction);
+                if (slope == T(0))
+                    break;
+            }
+
+            // Without pairs, the scale of the problem is unknown, and the
+            // first trial step is limited to a unit length.
+            T step(1);
+            if (Npair_ == 0)
+            {
+                T norm = Norm2(direction);
+                if (norm > T(1))
+                    step = T(1) / norm;
+            }
+
+            /*** Line search ***/
+
+            bool accepted = false;
+            T f_new(0);
+            for (int trial = 0; trial < 40; trial++)
+            {
+                if (Niteration_max_ > 0 && Nevaluation_ >= Niteration_max_)
+                    break;
+                Copy(x, x_new);
+                Add(step, direction, x_new);
+                Project(x_new);
+                Copy(x_new, s);
+                Add(T(-1), x, s);
+                if (trial == 0)
+                    f_new = Evaluate(cost, argument, x_new, g_new);
+                else
+                    f_new = Evaluate(cost, argument, x_new, no_gradient);
+                if (f_new <= f + T(1.e-4) * DotProd(g, s))
+                {
+                    accepted = true;
+                    if (trial != 0)
+                        f_new = Evaluate(cost, argument, x_new, g_new);
+                    break;
+                }
+                step *= T(0.5);
+            }
+            if (!accepted)
+                break;
+
+            /*** Update ***/
+
+            Niteration_++;
+            Copy(g_new, y);
+            Add(T(-1), g, y);
+            AddPair(s, y);
+
+            T f_previous = f;
+            Copy(x_new, x);
+            Copy(g_new, g);
+            f = f_new;
+
+            if (cost_function_tolerance_ > 0.
+                && abs(f_previous - f) <= cost_function_tolerance_ * abs(f))
+                break;
+            if (parameter_tolerance_ > 0.
+                && Norm2(s) <= parameter_tolerance_ * Norm2(x))
+                break;
+        }
+
+        Copy(x, parameter_);
+        gradient_.Reallocate(Nparameter_);
+        Copy(g, gradient_);
+        cost_ = f;
+    }
+
+
+    //! Evaluates the cost function.
+    /*!
+      \param[in] cost the cost function.
+      \param[in] argument an argument passed to the cost function.
+      \param[in] parameter the parameters at which the cost is evaluated.
+      \param[out] gradient the gradient of the cost function, unless it is
+      empty.
+      \return The cost function at \a parameter.
+    */
+    template <class T>
+    T LBFGSSolver<T>::Evaluate(cost_function cost, void* argument,
+                               const Vector<T>& parameter,
+                               Vector<T>& gradient)
+    {
+        Nevaluation_++;
+        return cost(parameter, gradient, argument);
+    }
+
+
+    //! Applies the L-BFGS approximation of the inverse Hessian.
+    /*! The two-loop recursion is used, with the initial matrix \f$ \gamma I
+      \f$, where \f$ \gamma = s^T y / y^T y \f$ for the last pair.
+      \param[in,out] direction on entry, a vector; on exit, the product of
+      the approximated inverse Hessian with this vector.
+    */
+    template <class T>
+    void LBFGSSolver<T>::ApplyInverseHessian(Vector<T>& direction) const
+    {
+        if (Npair_ == 0)
+            return;
+
+        T* d = direction.GetData();
+        Vector<T> alpha(Npair_);
+        int row = 0;
+        for (int k = Npair_ - 1; k >= 0; k--)
+        {
+            row = (first_pair_ + k) % Npair_max_;
+            const T* s = s_.GetData() + size_t(row) * size_t(Nparameter_);
+            const T* y = y_.GetData() + size_t(row) * size_t(Nparameter_);
+            T product(0);
+            for (int i = 0; i < Nparameter_; i++)
+                product += s[i] * d[i];
+            alpha(k) = rho_(row) * product;
+            for (int i = 0; i < Nparameter_; i++)
+                d[i] -= alpha(k) * y[i];
+        }
+
+        // Scaling with the last pair.
+        row = (first_pair_ + Npair_ - 1) % Npair_max_;
+        const T* y_last = y_.GetData() + size_t(row) * size_t(Nparameter_);
+        T yy(0);
+        for (int i = 0; i < Nparameter_; i++)
+            yy += y_last[i] * y_last[i];
+        Mlt(T(1) / (rho_(row) * yy), direction);
+
+        for (int k = 0; k < Npair_; k++)
+        {
+            row = (first_pair_ + k) % Npair_max_;
+            const T* s = s_.GetData() + size_t(row) * size_t(Nparameter_);
+            const T* y = y_.GetData() + size_t(row) * size_t(Nparameter_);
+            T product(0);
+            for (int i = 0; i < Nparameter_; i++)
+                product += y[i] * d[i];
+            T beta = rho_(row) * product;
+            for (int i = 0; i < Nparameter_; i++)
+                d[i] += (alpha(k) - beta) * s[i];
+        }
+    }
+
+
+    //! Stores a correction pair.
+    /*! The pair is discarded if it does not satisfy the curvature condition
+      \f$ s^T y > 0 \f$, so that the approximated inverse Hessian remains
+      positive definite. If the maximum number of pairs is reached, the
+      oldest pair is replaced.
+      \param[in] s the difference of the parameters.
+      \param[in] y the difference of the gradients.
+    */
+    template <class T>
+    void LBFGSSolver<T>::AddPair(const Vector<T>& s, const Vector<T>& y)
+    {
+        T sy = DotProd(s, y);
+        if (!(sy > T(1.e-10) * Norm2(s) * Norm2(y)))
+            return;
+
+        int row;
+        if (Npair_ < Npair_max_)
+            row = (first_pair_ + Npair_++) % Npair_max_;
+        else
+        {
+            row = first_pair_;
+            first_pair_ = (first_pair_ + 1) % Npair_max_;
+        }
+        T* s_row = s_.GetData() + size_t(row) * size_t(Nparameter_);
+        T* y_row = y_.GetData() + size_t(row) * size_t(Nparameter_);
+        for (int i = 0; i < Nparameter_; i++)
+        {
+            s_row[i] = s(i);
+            y_row[i] = y(i);
+        }
+        rho_(row) = T(1) / sy;
+    }
+
+
+    //! Projects parameters onto the bounds.
+    /*!
+      \param[in,out] parameter the parameters to be projected.
+    */
+    template <class T>
+    void LBFGSSolver<T>::Project(Vector<T>& parameter) const
+    {
+        for (int i = 0; i < lower_bound_.GetM(); i++)
+            parameter(i) = max(parameter(i), lower_bound_(i));
+        for (int i = 0; i < upper_bound_.GetM(); i++)
+            parameter(i) = min(parameter(i), upper_bound_(i));
+    }
+
+
+} // namespace Verdandi.
+
+
+#define VERDANDI_FILE_METHOD_LBFGSSOLVER_CXX
+#endif
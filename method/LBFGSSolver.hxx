@@ -0,0 +1,145 @@
+// Copyright (C) 2026
+// Author(s): agent
+//
+// This file is part of the data assimilation library Verdandi.
+//
+// Verdandi is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Verdandi is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Verdandi. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Verdandi web site:
+//      http://verdandi.gforge.inria.fr/
+
+
+#ifndef VERDANDI_FILE_METHOD_LBFGSSOLVER_HXX
+
+
+namespace Verdandi
+{
+
+
+    /////////////////
+    // LBFGSSOLVER //
+    /////////////////
+
+
+    //! This class implements a limited-memory BFGS minimizer.
+    /*! It has the interface of Seldon::NLoptSolver that is used by the
+      variational methods, so that it can replace it as their 'Optimization'
+      template parameter. The inverse Hessian is approximated from the last
+      correction pairs, which may be kept from one minimization to the next
+      (warm start). The bounds, if any, are enforced by projection.
+    */
+    template <class T>
+    class LBFGSSolver
+    {
+
+    public:
+        //! Type of the cost function.
+        typedef T (*cost_function)(const Vector<T>&, Vector<T>&, void*);
+
+    protected:
+
+        //! Number of parameters.
+        int Nparameter_;
+        //! Relative tolerance on the parameters.
+        double parameter_tolerance_;
+        //! Relative tolerance on the cost function.
+        double cost_function_tolerance_;
+        /*! \brief Maximum number of cost function evaluations (no limit if
+          non-positive). */
+        int Niteration_max_;
+
+        //! Maximum number of correction pairs.
+        int Npair_max_;
+        /*! \brief Should the correction pairs be kept from one minimization to
+          the next? */
+        bool warm_start_;
+
+        //! Lower bounds of the parameters (none if empty).
+        Vector<T> lower_bound_;
+        //! Upper bounds of the parameters (none if empty).
+        Vector<T> upper_bound_;
+
+        //! Parameters.
+        Vector<T> parameter_;
+        //! Gradient of the cost function at \a parameter_.
+        Vector<T> gradient_;
+        //! Cost function at \a parameter_.
+        T cost_;
+
+        /*! \brief Parameter differences of the correction pairs, one per row,
+          in a circular buffer. */
+        Matrix<T> s_;
+        /*! \brief Gradient differences of the correction pairs, one per row,
+          in a circular buffer. */
+        Matrix<T> y_;
+        //! Inverses of the products \f$ s_i^T y_i \f$.
+        Vector<T> rho_;
+        //! Number of stored correction pairs.
+        int Npair_;
+        //! Row of the oldest correction pair.
+        int first_pair_;
+
+        //! Number of iterations of the last minimization.
+        int Niteration_;
+        //! Number of cost function evaluations of the last minimization.
+        int Nevaluation_;
+
+    public:
+
+        /*** Constructor ***/
+
+        LBFGSSolver();
+
+        /*** Methods ***/
+
+        void Initialize(int Nparameter, string algorithm = "LBFGS",
+                        double parameter_tolerance = 1.e-6,
+                        double cost_function_tolerance = 1.e-6,
+                        int Niteration_max = -1);
+
+        void SetNpairMax(int Npair_max);
+        void SetWarmStart(bool warm_start);
+        void ClearPair();
+        int GetNpair() const;
+
+        void SetLowerBound(const Vector<T>& lower_bound);
+        void SetUpperBound(const Vector<T>& upper_bound);
+        void SetParameterTolerance(double tolerance);
+        void SetCostFunctionTolerance(double tolerance);
+        void SetNiterationMax(int Niteration_max);
+
+        void SetParameter(const Vector<T>& parameter);
+        void GetParameter(Vector<T>& parameter) const;
+        T GetCost() const;
+        int GetNiteration() const;
+        int GetNevaluation() const;
+
+        void Optimize(cost_function cost, void* argument);
+
+    protected:
+
+        T Evaluate(cost_function cost, void* argument,
+                   const Vector<T>& parameter, Vector<T>& gradient);
+        void ApplyInverseHessian(Vector<T>& direction) const;
+        void AddPair(const Vector<T>& s, const Vector<T>& y);
+        void Project(Vector<T>& parameter) const;
+
+    };
+
+
+} // namespace Verdandi.
+
+
+#define VERDANDI_FILE_METHOD_LBFGSSOLVER_HXX
+#endif
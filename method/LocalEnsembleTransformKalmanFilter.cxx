@@ -0,0 +1,423 @@
+// Copyright (C) 2026
+// Author(s): agent
+//
+// This file is part of the data assimilation library Verdandi.
+//
+// Verdandi is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Verdandi is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Verdandi. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Verdandi web site:
+//      http://verdandi.gforge.inria.fr/
+
+
+#ifndef VERDANDI_FILE_METHOD_LOCALENSEMBLETRANSFORMKALMANFILTER_CXX
+
+#include "LocalEnsembleTransformKalmanFilter.hxx"
+
+namespace Verdandi
+{
+
+
+    /////////////////
+    // CONSTRUCTOR //
+    /////////////////
+
+
+    //! Main constructor.
+    /*! Builds the driver.
+     */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    LocalEnsembleTransformKalmanFilter<Model, ObservationManager,
+                                       PerturbationManager>
+    ::LocalEnsembleTransformKalmanFilter(): Nstate_batch_(1)
+    {
+        configuration_prefix_ = "local_ensemble_transform_kalman_filter.";
+    }
+
+
+    ////////////////////
+    // ACCESS METHODS //
+    ////////////////////
+
+
+    //! Returns the name of the class.
+    /*!
+      \return The name of the class.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    string LocalEnsembleTransformKalmanFilter<Model, ObservationManager,
+                                              PerturbationManager>
+    ::GetName() const
+    {
+        return "LocalEnsembleTransformKalmanFilter";
+    }
+
+
+    ///////////////////////
+    // PROTECTED METHODS //
+    ///////////////////////
+
+
+    //! Reads the configuration of the local analyses.
+    /*! The threads of the forecast, set by "Nthread", also share the local
+      analyses. Without a coordinate file, the coordinate of a state
+      component is its index.
+      \param[in] configuration configuration for the method.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    void LocalEnsembleTransformKalmanFilter<Model, ObservationManager,
+                                            PerturbationManager>
+    ::InitializeAnalysis(VerdandiOps& configuration)
+    {
+        // The analysis is always carried out in the ensemble space, with a
+        // local square root update, so that the corresponding options of the
+        // ensemble Kalman filter are not read.
+        observation_tangent_linear_operator_access_ = "element";
+        analysis_space_ = "ensemble";
+        square_root_ = "ETKF";
+        inflation_type_ = "none";
+        localization_type_ = "Gaspari-Cohn";
+
+        configuration.Set("Nstate_batch", "v >= 1", 1, Nstate_batch_);
+
+        /*** Localization ***/
+
+        configuration.Set("localization.radius", "v > 0",
+                          localization_radius_);
+        string state_coordinate_file;
+        configuration.Set("localization.state_coordinate_file", "",
+                          string(""), state_coordinate_file);
+        if (state_coordinate_file.empty())
+        {
+            state_coordinate_.Reallocate(model_.GetNstate(), 1);
+            for (size_t k = 0; k < model_.GetNstate(); k++)
+                state_coordinate_(k, 0) = double(k);
+        }
+        else
+            state_coordinate_.Read(state_coordinate_file);
+        if (state_coordinate_.GetM() != model_.GetNstate())
+            throw ErrorConfiguration("LocalEnsembleTransformKalmanFilter"
+                                     "::InitializeAnalysis",
+                                     "The localization requires the "
+                                     "coordinates of "
+                                     + to_str(model_.GetNstate())
+                                     + " state components, but "
+                                     + to_str(state_coordinate_.GetM())
+                                     + " were provided.");
+        configuration.Set("localization.observation_coordinate_file", "",
+                          string(""), observation_coordinate_file_);
+        if (!observation_coordinate_file_.empty())
+            observation_coordinate_.Read(observation_coordinate_file_);
+    }
+
+
+    //! Updates the local members with local analyses.
+    /*! The members and their observed counterparts are gathered on every
+      process. Then the batches of state components are analyzed
+      independently, shared among the processes and the threads.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    void LocalEnsembleTransformKalmanFilter<Model, ObservationManager,
+                                            PerturbationManager>
+    ::AnalyzeEnsemble()
+    {
+        observation& obs = observation_manager_.GetObservation();
+        Nobservation_ = obs.GetLength();
+
+        // Gathers the members and their observed counterparts, one member
+        // per row.
+        Matrix<Ts> member(Nmember_, Nstate_);
+        Matrix<To> observed_member(Nmember_, Nobservation_);
+        observation Hx(Nobservation_);
+        for (int m = 0; m < Nlocal_member_; m++)
+        {
+            GetRow(ensemble_full_, m, model_.GetFullState());
+            model_.FullStateUpdated();
+            SetRow(model_.GetState(), m, ensemble_);
+            observation_manager_.ApplyOperator(model_.GetState(), Hx);
+            for (size_t k = 0; k < Nstate_; k++)
+                member(m + first_member_index_, k) = ensemble_(m, k);
+            for (size_t i = 0; i < Nobservation_; i++)
+                observed_member(m + first_member_index_, i) = Hx(i);
+        }
+
+#if defined(VERDANDI_WITH_MPI)
+        Vector<int> member_count(Nprocess_), member_offset(Nprocess_);
+        Vector<int> observation_count(Nprocess_),
+            observation_offset(Nprocess_);
+        int offset = 0;
+        for (int r = 0; r < Nprocess_; r++)
+        {
+            int Nrank_member = Nmember_ / Nprocess_
+                + (r < Nmember_ % Nprocess_ ? 1 : 0);
+            member_count(r) = Nrank_member * int(Nstate_);
+            member_offset(r) = offset * int(Nstate_);
+            observation_count(r) = Nrank_member * int(Nobservation_);
+            observation_offset(r) = offset * int(Nobservation_);
+            offset += Nrank_member;
+        }
+        MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+                       member.GetData(), member_count.GetData(),
+                       member_offset.GetData(), MPI_DOUBLE,
+                       MPI_COMM_WORLD);
+        MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+                       observed_member.GetData(),
+                       observation_count.GetData(),
+                       observation_offset.GetData(), MPI_DOUBLE,
+                       MPI_COMM_WORLD);
+#endif
+
+        // Computes the ensemble means and replaces the members with
+        // their deviations from the mean.
+        Vector<Ts> mean(Nstate_);
+        Vector<To> innovation(Nobservation_);
+        mean.Fill(Ts(0));
+        innovation.Fill(To(0));
+        for (int m = 0; m < Nmember_; m++)
+        {
+            for (size_t k = 0; k < Nstate_; k++)
+                mean(k) += member(m, k);
+            for (size_t i = 0; i < Nobservation_; i++)
+                innovation(i) += observed_member(m, i);
+        }
+        Mlt(Ts(1) / Ts(Nmember_), mean);
+        Mlt(To(1) / To(Nmember_), innovation);
+        for (int m = 0; m < Nmember_; m++)
+        {
+            for (size_t k = 0; k < Nstate_; k++)
+                member(m, k) -= mean(k);
+            for (size_t i = 0; i < Nobservation_; i++)
+                observed_member(m, i) -= innovation(i);
+        }
+        // Innovation of the mean d = y - mean(Hx).
+        Mlt(To(-1), innovation);
+        for (size_t i = 0; i < Nobservation_; i++)
+            innovation(i) += obs(i);
+
+        // Only the diagonal of R is taken into account.
+        Vector<To> error_variance(Nobservation_);
+        for (size_t i = 0; i < Nobservation_; i++)
+            error_variance(i) = observation_manager_
+                .GetErrorVariance(int(i), int(i));
+
+        // Sorts the observations along their first coordinate, for a
+        // fast search of the observations close to a batch.
+        ComputeObservationCoordinate();
+        observation_order_.resize(Nobservation_);
+        for (size_t i = 0; i < Nobservation_; i++)
+            observation_order_[i]
+                = make_pair(observation_coordinate_(i, 0), int(i));
+        sort(observation_order_.begin(), observation_order_.end());
+
+        /*** Local analyses ***/
+
+        int Nbatch = (int(Nstate_) + Nstate_batch_ - 1) / Nstate_batch_;
+        int first_batch = 0;
+        int last_batch = Nbatch;
+#if defined(VERDANDI_WITH_MPI)
+        // The batches are split among the processes.
+        first_batch = rank_ * Nbatch / Nprocess_;
+        last_batch = (rank_ + 1) * Nbatch / Nprocess_;
+#endif
+
+        // Row 'k' stores the analyses of the component 'k' for all
+        // members.
+        Matrix<Ts> analysis(Nstate_, Nmember_);
+        exception_ptr error;
+#pragma omp parallel for num_threads(Nthread_) schedule(dynamic)
+        for (int b = first_batch; b < last_batch; b++)
+        {
+            try
+            {
+                AnalyzeBatch(b * Nstate_batch_,
+                             min(int(Nstate_), (b + 1) * Nstate_batch_),
+                             member, observed_member, mean, innovation,
+                             error_variance, analysis);
+            }
+            catch (...)
+            {
+#pragma omp critical(verdandi_letkf_analysis)
+                if (!error)
+                    error = current_exception();
+            }
+        }
+        if (error)
+            rethrow_exception(error);
+
+#if defined(VERDANDI_WITH_MPI)
+        Vector<int> analysis_count(Nprocess_), analysis_offset(Nprocess_);
+        for (int r = 0; r < Nprocess_; r++)
+        {
+            int first_row = min(int(Nstate_),
+                                r * Nbatch / Nprocess_ * Nstate_batch_);
+            int last_row = min(int(Nstate_), (r + 1) * Nbatch / Nprocess_
+                               * Nstate_batch_);
+            analysis_count(r) = (last_row - first_row) * Nmember_;
+            analysis_offset(r) = first_row * Nmember_;
+        }
+        MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+                       analysis.GetData(), analysis_count.GetData(),
+                       analysis_offset.GetData(), MPI_DOUBLE,
+                       MPI_COMM_WORLD);
+#endif
+
+        for (int m = 0; m < Nlocal_member_; m++)
+            for (size_t k = 0; k < Nstate_; k++)
+                ensemble_(m, k) = analysis(k, m + first_member_index_);
+    }
+
+
+    //! Computes the local analysis of a batch of state components.
+    /*! The analysis is computed in the space spanned by the ensemble, with
+      the observations whose distance to the center of the batch is less
+      than twice the localization radius. The inverse of the observation
+      error variances is weighted with the Gaspari-Cohn function of this
+      distance.
+      \param[in] first index of the first state component of the batch.
+      \param[in] last index of the component after the last component of the
+      batch.
+      \param[in] member deviations of the members from the ensemble mean, one
+      member per row.
+      \param[in] observed_member deviations of the observed members from
+      their mean, one member per row.
+      \param[in] mean ensemble mean.
+      \param[in] innovation difference between the observations and the
+      mean of the observed members.
+      \param[in] error_variance observation error variances.
+      \param[out] analysis analyzed members: the rows \a first to \a last -
+      1 are filled, with one member per column.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    void LocalEnsembleTransformKalmanFilter<Model, ObservationManager,
+                                            PerturbationManager>
+    ::AnalyzeBatch(int first, int last,
+                   const Matrix<Ts>& member,
+                   const Matrix<To>& observed_member,
+                   const Vector<Ts>& mean,
+                   const Vector<To>& innovation,
+                   const Vector<To>& error_variance,
+                   Matrix<Ts>& analysis) const
+    {
+        int Ndimension = state_coordinate_.GetN();
+
+        // Center of the batch.
+        Vector<double> center(Ndimension);
+        center.Fill(0.);
+        for (int k = first; k < last; k++)
+            for (int d = 0; d < Ndimension; d++)
+                center(d) += state_coordinate_(k, d);
+        Mlt(1. / double(last - first), center);
+
+        // Selects the observations in the support of the localization
+        // function.
+        double cutoff = 2. * localization_radius_;
+        vector<int> local;
+        vector<To> weight;
+        vector<pair<double, int> >::const_iterator it
+            = lower_bound(observation_order_.begin(),
+                          observation_order_.end(),
+                          make_pair(center(0) - cutoff, -1));
+        for (; it != observation_order_.end()
+                 && it->first <= center(0) + cutoff; ++it)
+        {
+            int i = it->second;
+            double distance = 0., delta;
+            for (int d = 0; d < Ndimension; d++)
+            {
+                delta = observation_coordinate_(i, d) - center(d);
+                distance += delta * delta;
+            }
+            double rho = gaspari_cohn(sqrt(distance), localization_radius_);
+            if (rho > 0.)
+            {
+                local.push_back(i);
+                weight.push_back(To(rho) / error_variance(i));
+            }
+        }
+
+        int Nlocal = int(local.size());
+        if (Nlocal == 0)
+        {
+            // No observation: the analysis is the forecast.
+            for (int k = first; k < last; k++)
+                for (int m = 0; m < Nmember_; m++)
+                    analysis(k, m) = mean(k) + member(m, k);
+            return;
+        }
+
+        // Local observed deviations Y and C = Y^T R^{-1}, localized.
+        Matrix<To> Y(Nlocal, Nmember_), C(Nmember_, Nlocal);
+        for (int l = 0; l < Nlocal; l++)
+            for (int m = 0; m < Nmember_; m++)
+            {
+                Y(l, m) = observed_member(m, local[l]);
+                C(m, l) = Y(l, m) * weight[l];
+            }
+
+        // A = (N - 1) I + C Y.
+        Matrix<Ts> A(Nmember_, Nmember_);
+        MltAdd(Ts(1), C, Y, Ts(0), A);
+        for (int m = 0; m < Nmember_; m++)
+            A(m, m) += Ts(Nmember_ - 1);
+
+        // A is symmetric positive definite, so that its singular value
+        // decomposition is also its eigendecomposition: A = U D U^T.
+        Vector<Ts> lambda;
+        Matrix<Ts> U, V;
+        GetSVD(A, lambda, U, V);
+
+        // Mean weights w = A^{-1} C d.
+        Vector<Ts> Cd(Nmember_), w(Nmember_), UCd(Nmember_);
+        Cd.Fill(Ts(0));
+        for (int m = 0; m < Nmember_; m++)
+            for (int l = 0; l < Nlocal; l++)
+                Cd(m) += C(m, l) * innovation(local[l]);
+        MltAdd(Ts(1), SeldonTrans, U, Cd, Ts(0), UCd);
+        for (int q = 0; q < Nmember_; q++)
+            UCd(q) /= lambda(q);
+        MltAdd(Ts(1), U, UCd, Ts(0), w);
+
+        // W = sqrt(N - 1) U D^{-1/2} U^T + w.
+        Matrix<Ts> U_scaled(U), W(Nmember_, Nmember_);
+        for (int m = 0; m < Nmember_; m++)
+            for (int q = 0; q < Nmember_; q++)
+                U_scaled(m, q) /= sqrt(lambda(q));
+        MltAdd(sqrt(Ts(Nmember_ - 1)), SeldonNoTrans, U_scaled,
+               SeldonTrans, U, Ts(0), W);
+        for (int q = 0; q < Nmember_; q++)
+            for (int m = 0; m < Nmember_; m++)
+                W(q, m) += w(q);
+
+        // Analyzed members: x^a_m = mean + X W_m.
+        Ts value;
+        for (int k = first; k < last; k++)
+            for (int m = 0; m < Nmember_; m++)
+            {
+                value = mean(k);
+                for (int q = 0; q < Nmember_; q++)
+                    value += member(q, k) * W(q, m);
+                analysis(k, m) = value;
+            }
+    }
+
+
+} // namespace Verdandi.
+
+
+#define VERDANDI_FILE_METHOD_LOCALENSEMBLETRANSFORMKALMANFILTER_CXX
+#endif
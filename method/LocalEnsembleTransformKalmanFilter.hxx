@@ -0,0 +1,128 @@
+// Copyright (C) 2026
+// Author(s): agent
+//
+// This file is part of the data assimilation library Verdandi.
+//
+// Verdandi is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Verdandi is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Verdandi. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Verdandi web site:
+//      http://verdandi.gforge.inria.fr/
+
+#ifndef VERDANDI_FILE_METHOD_LOCALENSEMBLETRANSFORMKALMANFILTER_HXX
+
+
+#include "EnsembleKalmanFilter.hxx"
+#include <algorithm>
+
+
+namespace Verdandi
+{
+
+
+    ////////////////////////////////////////
+    // LOCALENSEMBLETRANSFORMKALMANFILTER //
+    ////////////////////////////////////////
+
+
+    //! This class implements the local ensemble transform Kalman filter.
+    /*! The analysis is carried out independently for batches of state
+      components, in the space spanned by the ensemble, with the observations
+      located in the neighborhood of the batch. The forecast, the
+      perturbations, the outputs and the checkpoints are those of the
+      ensemble Kalman filter.
+    */
+    template <class Model, class ObservationManager,
+              class PerturbationManager>
+    class LocalEnsembleTransformKalmanFilter:
+        public EnsembleKalmanFilter<Model, ObservationManager,
+                                    PerturbationManager>
+    {
+    public:
+        //! Type of the ensemble Kalman filter.
+        typedef EnsembleKalmanFilter<Model, ObservationManager,
+                                     PerturbationManager> base;
+        //! Type of the model state vector.
+        typedef typename base::model_state model_state;
+        //! Type of the observation vector.
+        typedef typename base::observation observation;
+        //! Value type of the model state vector.
+        typedef typename base::Ts Ts;
+        //! Value type of the observations.
+        typedef typename base::To To;
+
+    protected:
+
+        using base::model_;
+        using base::observation_manager_;
+        using base::Nmember_;
+        using base::Nlocal_member_;
+        using base::Nthread_;
+        using base::ensemble_;
+        using base::ensemble_full_;
+        using base::configuration_prefix_;
+        using base::Nstate_;
+        using base::Nobservation_;
+        using base::observation_tangent_linear_operator_access_;
+        using base::analysis_space_;
+        using base::square_root_;
+        using base::localization_type_;
+        using base::localization_radius_;
+        using base::state_coordinate_;
+        using base::observation_coordinate_file_;
+        using base::observation_coordinate_;
+        using base::inflation_type_;
+#if defined(VERDANDI_WITH_MPI)
+        using base::rank_;
+        using base::Nprocess_;
+#endif
+        using base::first_member_index_;
+        using base::ComputeObservationCoordinate;
+
+        /*** Local analysis ***/
+
+        //! Number of consecutive state components sharing a local analysis.
+        int Nstate_batch_;
+        /*! \brief Observations sorted along their first coordinate: first
+          coordinate and index of the observation. */
+        vector<pair<double, int> > observation_order_;
+
+    public:
+
+        /*** Constructor ***/
+
+        LocalEnsembleTransformKalmanFilter();
+
+        /*** Methods ***/
+
+        string GetName() const;
+
+    protected:
+
+        void InitializeAnalysis(VerdandiOps& configuration);
+        void AnalyzeEnsemble();
+        void AnalyzeBatch(int first, int last,
+                          const Matrix<Ts>& member,
+                          const Matrix<To>& observed_member,
+                          const Vector<Ts>& mean,
+                          const Vector<To>& innovation,
+                          const Vector<To>& error_variance,
+                          Matrix<Ts>& analysis) const;
+    };
+
+
+} // namespace Verdandi.
+
+
+#define VERDANDI_FILE_METHOD_LOCALENSEMBLETRANSFORMKALMANFILTER_HXX
+#endif
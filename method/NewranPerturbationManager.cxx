@@ -158,6 +158,31 @@ namespace Verdandi
     }
 
 
+    //! Writes the state of the random number generator.
+    /*! Newran does not give access to the state of its generators. The
+      seed directory (option "seed_type") is the way to chain runs.
+      \param[in,out] stream the binary output stream.
+    */
+    void NewranPerturbationManager::WriteState(ostream& stream) const
+    {
+        throw ErrorUndefined("NewranPerturbationManager::WriteState",
+                             "The state of the Newran generator cannot be "
+                             "saved. Use the seed directory instead.");
+    }
+
+
+    //! Restores the state of the random number generator.
+    /*! Newran does not give access to the state of its generators.
+      \param[in,out] stream the binary input stream.
+    */
+    void NewranPerturbationManager::ReadState(istream& stream)
+    {
+        throw ErrorUndefined("NewranPerturbationManager::ReadState",
+                             "The state of the Newran generator cannot be "
+                             "restored. Use the seed directory instead.");
+    }
+
+
     //! Generates a random number with a normal distribution.
     /*!
       \param[in] mean mean of the normal distribution.
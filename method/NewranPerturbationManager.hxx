@@ -67,6 +67,9 @@ namespace Verdandi
         void Reinitialize();
         void Finalize();
 
+        void WriteState(ostream& stream) const;
+        void ReadState(istream& stream);
+
         double Normal(double mean, double variance,
                       Vector<double, VectFull>& parameter);
         double LogNormal(double mean, double variance,
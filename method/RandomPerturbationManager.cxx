@@ -116,6 +116,27 @@ namespace Verdandi
     }
 
 
+    //! Writes the state of the random number generator.
+    /*!
+      \param[in,out] stream the binary output stream.
+    */
+    void RandomPerturbationManager::WriteState(ostream& stream) const
+    {
+        WriteGeneratorState(generator_, stream);
+    }
+
+
+    //! Restores the state of the random number generator.
+    /*!
+      \param[in,out] stream the binary input stream, as written by
+      'WriteState'.
+    */
+    void RandomPerturbationManager::ReadState(istream& stream)
+    {
+        ReadGeneratorState(stream, generator_);
+    }
+
+
     //! Generates a random number with a normal distribution.
     /*!
       \param[in] mean mean of the normal distribution.
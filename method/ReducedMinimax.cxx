@@ -435,10 +435,11 @@ namespace Verdandi
             H.Reallocate(Nobservation_, Nprojection_);
             MltAdd(T(1), SeldonNoTrans, H_tilde, SeldonTrans, projection_,
                    T(0), H);
-            R_inv_ = observation_manager_.GetErrorVariance();
-            GetInverse(R_inv_);
-            Mlt(1. / (bound_over_standard_deviation_
-                      * bound_over_standard_deviation_), R_inv_);
+            Matrix<T, General, RowMajor> R;
+            R = observation_manager_.GetErrorVariance();
+            Mlt(bound_over_standard_deviation_
+                * bound_over_standard_deviation_, R);
+            R_factorization_.Factorize(R);
         }
         else
         {
@@ -449,8 +450,9 @@ namespace Verdandi
             Nobservation_ = 1;
             H.Reallocate(1, Nprojection_);
             H.Zero();
-            R_inv_.Reallocate(1, 1);
-            R_inv_(0, 0) = T(1);
+            Matrix<T, General, RowMajor> R(1, 1);
+            R(0, 0) = T(1);
+            R_factorization_.Factorize(R);
         }
 
         output_saver_.Save(y, model_.GetTime(), "observation");
@@ -499,23 +501,28 @@ namespace Verdandi
 
         // Computes $(I_{q\times q} + \widecheck Q^{\frac T2} \widecheck
         // Q^{\frac 12})^{-1}$.
-        Matrix<T, General, RowMajor> IQtQinv(Nmode_Q_, Nmode_Q_);
-        IQtQinv.SetIdentity();
+        // The matrix is only factorized: it is applied by solves.
+        Matrix<T, General, RowMajor> IQtQ(Nmode_Q_, Nmode_Q_);
+        IQtQ.SetIdentity();
         MltAdd(T(1), SeldonTrans, Q_sqrt_check,
-               SeldonNoTrans, Q_sqrt_check, T(1), IQtQinv);
-        // Note that IQtQinv is used for estimate's propagation too.
-        GetInverse(IQtQinv);
+               SeldonNoTrans, Q_sqrt_check, T(1), IQtQ);
+        SymmetricFactorization<T> IQtQ_factorization;
+        IQtQ_factorization.Factorize(IQtQ);
 
         // Subtracts to 'G_' this part: $\widecheck F_{0}^T\widecheck Q^{\frac
         // 12} (I_{q\times q} + \widecheck Q^{\frac T2} \widecheck Q^{\frac
         // 12})^{-1} (\widecheck F_{0}^T \widecheck Q^{\frac 12})^T$.
-        Matrix<T, General, RowMajor> FtQ_IQtQinv(Nprojection_, Nmode_Q_);
-        MltAdd(T(1), FtQ, IQtQinv, T(0), FtQ_IQtQinv);
+        // Note that 'FtQ_IQtQinv' is used for estimate's propagation too.
+        Matrix<T, General, RowMajor> FtQ_IQtQinv(FtQ);
+        IQtQ_factorization.SolveRow(FtQ_IQtQinv);
         MltAdd(T(-1), SeldonNoTrans, FtQ_IQtQinv, SeldonTrans, FtQ, T(1), G_);
 
         // Adds $H_0^T R_0^{-1} H_0$ to 'G_'.
         Matrix<T, General, RowMajor> Ht_Rinv(Nprojection_, Nobservation_);
-        MltAdd(T(1), SeldonTrans, H, SeldonNoTrans, R_inv_, T(0), Ht_Rinv);
+        for (int i = 0; i < Nprojection_; i++)
+            for (int j = 0; j < Nobservation_; j++)
+                Ht_Rinv(i, j) = H(j, i);
+        R_factorization_.SolveRow(Ht_Rinv);
         output_saver_.Save(G_, model_.GetTime(), "minimax_gain_model_part");
         MltAdd(T(1), Ht_Rinv, H, T(1), G_);
 
@@ -545,8 +552,9 @@ namespace Verdandi
         MltAdd(T(1), Ht_Rinv, y, T(1), state_);
 
         // Finally computes the minimax state, with $G_0^{-1} z_0$.
-        mtmp = G_;
-        GetAndSolveLU(mtmp, state_);
+        SymmetricFactorization<T> G_factorization("LDLt");
+        G_factorization.Factorize(G_);
+        G_factorization.Solve(state_);
 
         vtmp.Reallocate(Nstate_);
         MltAdd(T(1), SeldonTrans, projection_, state_, T(0), vtmp);
@@ -671,33 +679,32 @@ namespace Verdandi
                SeldonNoTrans, M_check, T(0), G_MtM);
         Add(T(1), G_, G_MtM);
 
-        // Computes $\widecheck U_t$.
-        Matrix<T, General, RowMajor> U_check(Nstate_, Nprevious_projection_);
-        mtmp = G_MtM;
-        GetInverse(mtmp);
-        GetCholesky(mtmp);
-        MltAdd(T(1), M_check, mtmp, T(0), U_check);
+        // Computes $\widecheck U_t = \widecheck M_t S$ where $S S^T = (G_t +
+        // \widecheck M_t^T \widecheck M_t)^{-1}$. Since $\widecheck U_t$ only
+        // appears through $\widecheck U_t \widecheck U_t^T$, any square root
+        // fits: with the Cholesky factorization $U^T U$, $S = U^{-1}$.
+        SymmetricFactorization<T> G_MtM_factorization;
+        G_MtM_factorization.Factorize(G_MtM);
+        Matrix<T, General, RowMajor> U_check(M_check);
+        G_MtM_factorization.SolveSquareRootRow(U_check);
 
         // Computes $\widecheck U_t^T \widecheck Q_t^{\frac 12}$.
         Matrix<T, General, RowMajor> UtQ(Nprevious_projection_, Nmode_Q_);
         MltAdd(T(1), SeldonTrans, U_check,
                SeldonNoTrans, Q_sqrt_check, T(0), UtQ);
 
-        // Computes $V_t$.
-        Matrix<T, General, RowMajor> IQtQinv;
+        // Computes and factorizes $V_t^{-1}$.
         Matrix<T, General, RowMajor> Vinv(Nmode_Q_, Nmode_Q_);
         Vinv.SetIdentity();
         MltAdd(T(1), SeldonTrans, Q_sqrt_check,
                SeldonNoTrans, Q_sqrt_check, T(1), Vinv);
-        IQtQinv = Vinv;
-        // Note that IQtQinv is used for estimate's propagation too.
-        GetInverse(IQtQinv);
 
         mtmp.Reallocate(Nmode_Q_, Nprevious_projection_);
         MltAdd(T(1), SeldonTrans,
                Q_sqrt_check, SeldonNoTrans, U_check, T(0), mtmp);
         MltAdd(T(-1), SeldonNoTrans, mtmp, SeldonTrans, mtmp, T(1), Vinv);
-        GetInverse(Vinv);
+        SymmetricFactorization<T> Vinv_factorization;
+        Vinv_factorization.Factorize(Vinv);
 
         /*** Observation-related variables ***/
 
@@ -718,10 +725,11 @@ namespace Verdandi
             H.Reallocate(Nobservation_, Nprojection_);
             MltAdd(T(1), SeldonNoTrans, H_tilde, SeldonTrans, projection_,
                    T(0), H);
-            R_inv_ = observation_manager_.GetErrorVariance();
-            GetInverse(R_inv_);
-            Mlt(1. / (bound_over_standard_deviation_
-                      * bound_over_standard_deviation_), R_inv_);
+            Matrix<T, General, RowMajor> R;
+            R = observation_manager_.GetErrorVariance();
+            Mlt(bound_over_standard_deviation_
+                * bound_over_standard_deviation_, R);
+            R_factorization_.Factorize(R);
         }
         else
         {
@@ -732,8 +740,9 @@ namespace Verdandi
             Nobservation_ = 1;
             H.Reallocate(1, Nprojection_);
             H.Zero();
-            R_inv_.Reallocate(1, 1);
-            R_inv_(0, 0) = T(1);
+            Matrix<T, General, RowMajor> R(1, 1);
+            R(0, 0) = T(1);
+            R_factorization_.Factorize(R);
         }
 
         output_saver_.Save(y, model_.GetTime(), "observation");
@@ -742,7 +751,10 @@ namespace Verdandi
 
         // Computes $H_{t+1}^T R_{t+1}^{-1} H_{t+1}$.
         Matrix<T, General, RowMajor> Ht_Rinv(Nprojection_, Nobservation_);
-        MltAdd(T(1), SeldonTrans, H, SeldonNoTrans, R_inv_, T(0), Ht_Rinv);
+        for (int i = 0; i < Nprojection_; i++)
+            for (int j = 0; j < Nobservation_; j++)
+                Ht_Rinv(i, j) = H(j, i);
+        R_factorization_.SolveRow(Ht_Rinv);
 
         /*** Computes the minimax gain $G_t$ ***/
 
@@ -756,8 +768,8 @@ namespace Verdandi
 
         mtmp_1 = FtQ;
         MltAdd(T(-1), FtU, UtQ, T(1), mtmp_1);
-        Matrix<T, General, RowMajor> FtQ_FtUUtQ_Vinv(Nprojection_, Nmode_Q_);
-        MltAdd(T(1), mtmp_1, Vinv, T(0), FtQ_FtUUtQ_Vinv);
+        Matrix<T, General, RowMajor> FtQ_FtUUtQ_Vinv(mtmp_1);
+        Vinv_factorization.SolveRow(FtQ_FtUUtQ_Vinv);
         MltAdd(T(-1), SeldonNoTrans, FtQ_FtUUtQ_Vinv, SeldonTrans, mtmp_1,
                T(1), G_);
 
@@ -793,8 +805,9 @@ namespace Verdandi
         MltAdd(T(1), Ht_Rinv, y, T(1), state_);
 
         // Now multiplies everything by $G_{t+1}^{-1}$.
-        mtmp = G_;
-        GetAndSolveLU(mtmp, state_);
+        SymmetricFactorization<T> G_factorization("LDLt");
+        G_factorization.Factorize(G_);
+        G_factorization.Solve(state_);
 
         vtmp.Reallocate(Nstate_);
         MltAdd(T(1), SeldonTrans, projection_, state_, T(0), vtmp);
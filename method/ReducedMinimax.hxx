@@ -169,8 +169,9 @@ namespace Verdandi
         //! Systematic error.
         Vector<T> e_;
 
-        //! Observation error.
-        Matrix<T, General, RowMajor> R_inv_;
+        /*! \brief Factorization of the observation error variance, scaled by
+          the squared bound. */
+        SymmetricFactorization<T> R_factorization_;
         //! Systematic error in the observations.
         T eta_;
 
@@ -543,8 +543,10 @@ namespace Verdandi
                            recvcount_gather_3_, displacement_gather_3_,
                            MPI_DOUBLE, MPI_COMM_WORLD);
 
-            GetInverse(U_global);
-            MltAdd(Ts(1), U_global, state_innovation, Ts(0), x_local);
+            SymmetricFactorization<Ts> U_factorization;
+            U_factorization.Factorize(U_global);
+            x_local = state_innovation;
+            U_factorization.Solve(x_local);
 
             model_state_error_variance_row x_local_local(Nlocal_reduced_);
             for (int i = 0; i < Nlocal_reduced_; i++)
@@ -603,8 +605,9 @@ namespace Verdandi
 
             /*** Updated K ***/
 
-            dense_matrix U_inv(U_),
-                working_matrix_ro2(Nreduced_, Nobservation_);
+            // U is factorized once; its inverse is never formed.
+            SymmetricFactorization<Ts> U_factorization;
+            U_factorization.Factorize(U_);
 
             Mlt(observation_manager_.GetErrorVarianceInverse(), HL,
                 working_matrix_or);
@@ -612,9 +615,8 @@ namespace Verdandi
             MltAdd(Ts(1), SeldonTrans, working_matrix_or, y, Ts(0),
                    state_innovation);
 
-            model_state_error_variance_row correction(Nreduced_);
-            GetInverse(U_inv);
-            MltAdd(Ts(1), U_inv, state_innovation, Ts(0), correction);
+            model_state_error_variance_row correction(state_innovation);
+            U_factorization.Solve(correction);
             MltAdd(Ts(1), L_, correction, Ts(1), x);
 
             model_.StateUpdated();
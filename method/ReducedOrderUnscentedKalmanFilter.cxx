@@ -46,7 +46,9 @@ namespace Verdandi
     */
     template <class Model, class ObservationManager>
     ReducedOrderUnscentedKalmanFilter<Model, ObservationManager>
-    ::ReducedOrderUnscentedKalmanFilter(): iteration_(-1)
+    ::ReducedOrderUnscentedKalmanFilter(): iteration_(-1),
+                                           R_factorization_version_(-1),
+                                           checkpoint_period_(1)
     {
 #ifndef VERDANDI_WITH_MPI
         MessageHandler::AddRecipient("model", model_, Model::StaticMessage);
@@ -160,6 +162,16 @@ namespace Verdandi
                           "ops_in(v, {'canonical', 'star', 'simplex'})",
                           sigma_point_type_);
 
+        /*** Checkpoint ***/
+
+        configuration.Set("checkpoint.file", "", string(""),
+                          checkpoint_file_);
+        if (!checkpoint_file_.empty())
+            configuration.Set("checkpoint.period", "v >= 1", 1,
+                              checkpoint_period_);
+        configuration.Set("checkpoint.restart_file", "", string(""),
+                          restart_file_);
+
 #if defined(VERDANDI_WITH_MPI)
         configuration.Set("mpi_grid.Nrow", Nrow_);
         configuration.Set("mpi_grid.Ncol", Ncol_);
@@ -188,10 +200,14 @@ namespace Verdandi
                 SetPrefix("reduced_order_unscented_kalman_filter"
                           ".output_saver.");
             output_saver_.Initialize(configuration);
-            output_saver_.Empty("forecast_time");
-            output_saver_.Empty("forecast_state");
-            output_saver_.Empty("analysis_time");
-            output_saver_.Empty("analysis_state");
+            // After a restart, the outputs of the former run are completed.
+            if (restart_file_.empty())
+            {
+                output_saver_.Empty("forecast_time");
+                output_saver_.Empty("forecast_state");
+                output_saver_.Empty("analysis_time");
+                output_saver_.Empty("analysis_state");
+            }
 
             /*** Logger and read configuration ***/
 
@@ -231,6 +247,9 @@ namespace Verdandi
         }
         Nstate_ = model_.GetNstate();
         Nobservation_ = observation_manager_.GetNobservation();
+        // The observation error covariance matrix is factorized at the first
+        // analysis.
+        R_factorization_.Clear();
 
 #ifdef VERDANDI_WITH_MPI
         if (world_rank_ == 0)
@@ -251,9 +270,9 @@ namespace Verdandi
 #endif
 
         Copy(model_.GetStateErrorVarianceReduced(), U_);
-        U_inv_.Copy(U_);
-
-        GetInverse(U_inv_);
+        SymmetricFactorization<Ts> U_factorization;
+        U_factorization.Factorize(U_);
+        U_factorization.GetInverse(U_inv_);
 
         Nreduced_ = U_.GetN();
 
@@ -371,7 +390,10 @@ namespace Verdandi
                              "initial condition");
 #endif
 
-        if (analyze_first_step_)
+        if (!restart_file_.empty())
+            // The checkpoint already holds an analyzed state.
+            ReadCheckpoint(restart_file_);
+        else if (analyze_first_step_)
             Analyze();
 
         MessageHandler::Send(*this, "all", "::Initialize end");
@@ -774,22 +796,24 @@ namespace Verdandi
                 }
                 MltAdd(Ts(alpha_), SeldonTrans, I_trans_, SeldonNoTrans,
                        Z_i_trans_, Ts(0), HL_trans_);
-                observation_error_variance R_inv;
                 if (observation_error_variance_ == "matrix_inverse")
                     Mlt(HL_trans_, observation_manager_.
                         GetErrorVarianceInverse(), HL_trans_R_);
                 else
                 {
-                    observation_error_variance R_inv;
-                    Copy(observation_manager_.GetErrorVariance(), R_inv);
-                    GetInverse(R_inv);
-                    Mlt(HL_trans_, R_inv, HL_trans_R_);
+                    FactorizeErrorVariance();
+                    Copy(HL_trans_, HL_trans_R_);
+                    R_factorization_.SolveRow(HL_trans_R_);
                 }
                 U_inv_.SetIdentity();
                 MltAdd(Ts(1), SeldonNoTrans, HL_trans_R_,
                        SeldonTrans, HL_trans_, Ts(1), U_inv_);
-                GetInverse(U_inv_);
-                MltAdd(Ts(1), U_inv_, HL_trans_R_, Ts(0), HL_trans_);
+                SymmetricFactorization<Ts> U_factorization;
+                U_factorization.Factorize(U_inv_);
+                // The inverse is needed for the next sampling.
+                U_factorization.GetInverse(U_inv_);
+                Copy(HL_trans_R_, HL_trans_);
+                U_factorization.SolveColumn(HL_trans_);
                 MltAdd(Ts(-1), HL_trans_, z, Ts(0), reduced_innovation);
             }
             MltAdd(Ts(1), model_.GetStateErrorVarianceProjector(),
@@ -841,7 +865,6 @@ namespace Verdandi
             MltAdd(Ts(alpha_), SeldonTrans, I_trans_, SeldonNoTrans, Z_i_trans,
                    Ts(0), HL_trans);
 
-            observation_error_variance R_inv;
             sigma_point_matrix working_matrix_po(Nreduced_, Nobservation_),
                 tmp;
 
@@ -850,21 +873,22 @@ namespace Verdandi
                     working_matrix_po);
             else
             {
-                Copy(observation_manager_.GetErrorVariance(), R_inv);
-                GetInverse(R_inv);
-                Mlt(HL_trans, R_inv, working_matrix_po);
+                FactorizeErrorVariance();
+                Copy(HL_trans, working_matrix_po);
+                R_factorization_.SolveRow(working_matrix_po);
             }
 
             U_inv_.SetIdentity();
             MltAdd(Ts(1), SeldonNoTrans, working_matrix_po,
                    SeldonTrans, HL_trans, Ts(1), U_inv_);
-            GetInverse(U_inv_);
-
-            tmp.Reallocate(Nreduced_, Nobservation_);
-            tmp.Fill(Ts(0));
+            SymmetricFactorization<Ts> U_factorization;
+            U_factorization.Factorize(U_inv_);
+            // The inverse is needed for the next sampling.
+            U_factorization.GetInverse(U_inv_);
 
             observation reduced_innovation(Nreduced_);
-            MltAdd(Ts(1), U_inv_, working_matrix_po, Ts(0), tmp);
+            Copy(working_matrix_po, tmp);
+            U_factorization.SolveColumn(tmp);
             MltAdd(Ts(-1), tmp, z, Ts(0), reduced_innovation);
 
             // Updates.
@@ -938,15 +962,15 @@ namespace Verdandi
                 D_m(Nsigma_point_, Nsigma_point_);
             sigma_point_matrix HL_trans;
 
-            observation_error_variance R_inv;
+            SymmetricFactorization<Ts> U_factorization;
             if (observation_error_variance_ == "matrix_inverse")
                 Mlt(Z_i_trans, observation_manager_.GetErrorVarianceInverse(),
                     working_matrix_ro);
             else
             {
-                Copy(observation_manager_.GetErrorVariance(), R_inv);
-                GetInverse(R_inv);
-                Mlt(Z_i_trans, R_inv, working_matrix_ro);
+                FactorizeErrorVariance();
+                Copy(Z_i_trans, working_matrix_ro);
+                R_factorization_.SolveRow(working_matrix_ro);
             }
 
             // Computes D_m.
@@ -970,17 +994,27 @@ namespace Verdandi
                        working_matrix_rr2);
                 for(int i = 0; i < Nsigma_point_; i++ )
                     working_matrix_rr2(i, i) += 1;
-                GetInverse(working_matrix_rr2);
-                MltAdd(Ts(1), working_matrix_rr2, D_m, Ts(0),
-                       working_matrix_rr);
+                // This matrix is not symmetric: it goes through an LU
+                // factorization.
+                Vector<int> pivot;
+                GetLU(working_matrix_rr2, pivot);
+                Copy(D_m, working_matrix_rr);
+                sigma_point working_vector_r;
+                for (int j = 0; j < Nsigma_point_; j++)
+                {
+                    GetCol(working_matrix_rr, j, working_vector_r);
+                    SolveLU(working_matrix_rr2, pivot, working_vector_r);
+                    SetCol(working_vector_r, j, working_matrix_rr);
+                }
                 MltAdd(Ts(alpha_), working_matrix_rr, I_trans_, Ts(0),
                        working_matrix_rp);
                 U_.SetIdentity();
                 MltAdd(Ts(alpha_), SeldonTrans, I_trans_, SeldonNoTrans,
                        working_matrix_rp, Ts(1), U_);
 
-                Copy(U_, U_inv_);
-                GetInverse(U_inv_);
+                U_factorization.Factorize(U_);
+                // The inverse is needed for the next sampling.
+                U_factorization.GetInverse(U_inv_);
 
                 // Computes {HL}_{n+1}.
                 HL_trans.Reallocate(Nreduced_, Nobservation_);
@@ -990,10 +1024,11 @@ namespace Verdandi
 
                 working_matrix_rr.SetIdentity();
                 Add(Ts(alpha_), D_m, working_matrix_rr);
-                GetInverse(working_matrix_rr);
+                SymmetricFactorization<Ts> rr_factorization;
+                rr_factorization.Factorize(working_matrix_rr);
 
-                Mlt(working_matrix_rr, working_matrix_rr2,
-                    working_matrix_rr3);
+                Copy(working_matrix_rr2, working_matrix_rr3);
+                rr_factorization.SolveColumn(working_matrix_rr3);
 
                 MltAdd(Ts(alpha_), working_matrix_rr3, I_trans_, Ts(0),
                        working_matrix_rp);
@@ -1015,8 +1050,12 @@ namespace Verdandi
                 Mlt(HL_trans, observation_manager_.GetErrorVarianceInverse(),
                     working_matrix_po);
             else
-                Mlt(HL_trans, R_inv, working_matrix_po);
-            Mlt(U_inv_, working_matrix_po, working_matrix_po2);
+            {
+                Copy(HL_trans, working_matrix_po);
+                R_factorization_.SolveRow(working_matrix_po);
+            }
+            Copy(working_matrix_po, working_matrix_po2);
+            U_factorization.SolveColumn(working_matrix_po2);
             Mlt(model_.GetStateErrorVarianceProjector(),
                 working_matrix_po2, K);
 
@@ -1051,6 +1090,9 @@ namespace Verdandi
 
         model_.FinalizeStep();
 
+        if (!checkpoint_file_.empty() && iteration_ % checkpoint_period_ == 0)
+            WriteCheckpoint(checkpoint_file_);
+
         MessageHandler::Send(*this, "all", "::FinalizeStep end");
     }
 
@@ -1080,6 +1122,141 @@ namespace Verdandi
     }
 
 
+    //! Writes a checkpoint from which the filter can restart.
+    /*! The checkpoint is a binary file that contains the iteration, the
+      current time, the full state of the model, the projector \f$L\f$ and
+      the reduced matrix \f$U\f$. Every process writes its own file, so that
+      \a file_name should contain the markup "%{rank}" when several processes
+      are involved. The file is first written under a temporary name, so that
+      a former checkpoint is not lost if the writing fails.
+      \param[in] file_name path to the checkpoint.
+    */
+    template <class Model, class ObservationManager>
+    void ReducedOrderUnscentedKalmanFilter<Model, ObservationManager>
+    ::WriteCheckpoint(string file_name)
+    {
+        file_name = GetCheckpointFileName(file_name);
+        string temporary_file_name = file_name + ".tmp";
+        ofstream stream(temporary_file_name.c_str(), ofstream::binary);
+        if (!stream.good())
+            throw ErrorIO("ReducedOrderUnscentedKalmanFilter"
+                          "::WriteCheckpoint", "Unable to open file \""
+                          + temporary_file_name + "\".");
+
+        int header[3] = {Nstate_, Nreduced_, iteration_};
+        stream.write(reinterpret_cast<char*>(header), 3 * sizeof(int));
+        double time = model_.GetTime();
+        stream.write(reinterpret_cast<char*>(&time), sizeof(double));
+
+        model_.GetFullState().Write(stream, true);
+        model_.GetStateErrorVarianceProjector().Write(stream);
+        U_.Write(stream);
+
+        stream.close();
+        if (!stream.good())
+            throw ErrorIO("ReducedOrderUnscentedKalmanFilter"
+                          "::WriteCheckpoint", "Unable to write file \""
+                          + temporary_file_name + "\".");
+        if (rename(temporary_file_name.c_str(), file_name.c_str()) != 0)
+            throw ErrorIO("ReducedOrderUnscentedKalmanFilter"
+                          "::WriteCheckpoint", "Unable to rename \""
+                          + temporary_file_name + "\" to \"" + file_name
+                          + "\".");
+    }
+
+
+    //! Restores the filter from a checkpoint.
+    /*! The checkpoint must have been written by 'WriteCheckpoint' with the
+      same model dimensions and the same MPI grid. The time of the model is
+      set to the time of the checkpoint.
+      \param[in] file_name path to the checkpoint.
+    */
+    template <class Model, class ObservationManager>
+    void ReducedOrderUnscentedKalmanFilter<Model, ObservationManager>
+    ::ReadCheckpoint(string file_name)
+    {
+        file_name = GetCheckpointFileName(file_name);
+        ifstream stream(file_name.c_str(), ifstream::binary);
+        if (!stream.good())
+            throw ErrorIO("ReducedOrderUnscentedKalmanFilter"
+                          "::ReadCheckpoint", "Unable to open file \""
+                          + file_name + "\".");
+
+        int header[3];
+        stream.read(reinterpret_cast<char*>(header), 3 * sizeof(int));
+        if (!stream.good())
+            throw ErrorIO("ReducedOrderUnscentedKalmanFilter"
+                          "::ReadCheckpoint", "Unable to read file \""
+                          + file_name + "\".");
+        if (header[0] != Nstate_ || header[1] != Nreduced_)
+            throw ErrorConfiguration("ReducedOrderUnscentedKalmanFilter"
+                                     "::ReadCheckpoint", "The checkpoint \""
+                                     + file_name + "\" was written for "
+                                     "another model.");
+        iteration_ = header[2];
+        double time;
+        stream.read(reinterpret_cast<char*>(&time), sizeof(double));
+
+        model_.GetFullState().Read(stream, true);
+        model_.GetStateErrorVarianceProjector().Read(stream);
+        U_.Read(stream);
+
+        if (!stream.good())
+            throw ErrorIO("ReducedOrderUnscentedKalmanFilter"
+                          "::ReadCheckpoint", "Unable to read file \""
+                          + file_name + "\".");
+
+        model_.FullStateUpdated();
+        model_.SetTime(time);
+        SymmetricFactorization<Ts> U_factorization;
+        U_factorization.Factorize(U_);
+        U_factorization.GetInverse(U_inv_);
+    }
+
+
+    //! Factorizes the observation error covariance matrix.
+    /*! The factorization is kept as long as the observation manager reports
+      the same version of the observation error covariance matrix, so that
+      it is not recomputed at every analysis.
+    */
+    template <class Model, class ObservationManager>
+    void ReducedOrderUnscentedKalmanFilter<Model, ObservationManager>
+    ::FactorizeErrorVariance()
+    {
+        int version = observation_manager_.GetErrorVarianceVersion();
+        if (R_factorization_.IsFactorized()
+            && version == R_factorization_version_)
+            return;
+        R_factorization_.Factorize(observation_manager_.GetErrorVariance());
+        R_factorization_version_ = version;
+    }
+
+
+    //! Returns the path to the checkpoint of the current process.
+    /*!
+      \param[in] file_name path to the checkpoint, possibly with the markup
+      "%{rank}".
+      \return The path \a file_name where "%{rank}" is replaced with the
+      process rank, or removed without MPI.
+    */
+    template <class Model, class ObservationManager>
+    string ReducedOrderUnscentedKalmanFilter<Model, ObservationManager>
+    ::GetCheckpointFileName(string file_name) const
+    {
+#ifdef VERDANDI_WITH_MPI
+        if (Nworld_process_ > 1 && file_name.find("%{rank}") == string::npos)
+            throw ErrorConfiguration("ReducedOrderUnscentedKalmanFilter"
+                                     "::GetCheckpointFileName",
+                                     "With several processes, the path to "
+                                     "the checkpoint \"" + file_name
+                                     + "\" should contain \"%{rank}\".");
+        return find_replace(file_name, "%{rank}", to_str(world_rank_));
+#else
+        return find_replace(file_name, "%{rank}", "");
+#endif
+    }
+
+
     //! Returns the model.
     /*!
       \return The model.
@@ -24,6 +24,7 @@
 
 
 #include "seldon/vector/VectorCollection.hxx"
+#include <cstdio>
 
 
 namespace Verdandi
@@ -127,6 +128,22 @@ namespace Verdandi
         bool with_resampling_;
         //! Indicates how R is stored (matrix, matrix_inverse, vector).
         string observation_error_variance_;
+        //! Factorization of R, used unless R^{-1} is provided.
+        SymmetricFactorization<Ts> R_factorization_;
+        /*! \brief Version of R, as given by the observation manager, when
+          'R_factorization_' was computed. */
+        int R_factorization_version_;
+
+        /*** Checkpoint ***/
+
+        /*! \brief File in which the checkpoints are written (no checkpoint if
+          empty). The markup "%{rank}" is replaced with the process rank. */
+        string checkpoint_file_;
+        //! Number of iterations between two checkpoints.
+        int checkpoint_period_;
+        /*! \brief Checkpoint from which the filter restarts (the model
+          initial condition is used if empty). */
+        string restart_file_;
 
         /*** Sigma-points ***/
 
@@ -227,6 +244,9 @@ namespace Verdandi
 
         bool HasFinished();
 
+        void WriteCheckpoint(string file_name);
+        void ReadCheckpoint(string file_name);
+
         // Access methods.
         Model& GetModel();
         ObservationManager& GetObservationManager();
@@ -234,6 +254,11 @@ namespace Verdandi
 
         string GetName() const;
         void Message(string message);
+
+    protected:
+
+        void FactorizeErrorVariance();
+        string GetCheckpointFileName(string file_name) const;
     };
 
 
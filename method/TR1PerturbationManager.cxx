@@ -137,6 +137,36 @@ namespace Verdandi
     }
 
 
+    //! Writes the state of the random number generators.
+    /*! The variate generators hold their own copies of the engine, so that
+      all engines are written, together with the normal distribution which
+      may hold a cached value.
+      \param[in,out] stream the binary output stream.
+    */
+    void TR1PerturbationManager::WriteState(ostream& stream) const
+    {
+        WriteGeneratorState(*urng_, stream);
+        WriteGeneratorState(variate_generator_uniform_->engine(), stream);
+        WriteGeneratorState(variate_generator_normal_->engine(), stream);
+        WriteGeneratorState(variate_generator_normal_->distribution(),
+                            stream);
+    }
+
+
+    //! Restores the state of the random number generators.
+    /*!
+      \param[in,out] stream the binary input stream, as written by
+      'WriteState'.
+    */
+    void TR1PerturbationManager::ReadState(istream& stream)
+    {
+        ReadGeneratorState(stream, *urng_);
+        ReadGeneratorState(stream, variate_generator_uniform_->engine());
+        ReadGeneratorState(stream, variate_generator_normal_->engine());
+        ReadGeneratorState(stream, variate_generator_normal_->distribution());
+    }
+
+
     //! Generates a random number with a normal distribution.
     /*!
       \param[in] mean mean of the distribution.
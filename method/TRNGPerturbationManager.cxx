@@ -105,6 +105,29 @@ namespace Verdandi
     }
 
 
+    //! Writes the state of the random number generator.
+    /*!
+      \param[in,out] stream the binary output stream.
+    */
+    void TRNGPerturbationManager::WriteState(ostream& stream) const
+    {
+        WriteGeneratorState(*nrng_, stream);
+    }
+
+
+    //! Restores the state of the random number generator.
+    /*!
+      \param[in,out] stream the binary input stream, as written by
+      'WriteState'.
+    */
+    void TRNGPerturbationManager::ReadState(istream& stream)
+    {
+        if (nrng_ == NULL)
+            nrng_ = new trng::yarn5;
+        ReadGeneratorState(stream, *nrng_);
+    }
+
+
     //! Generates a random number with a normal distribution.
     /*!
       \param[in] mean mean of the distribution.
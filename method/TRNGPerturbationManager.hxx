@@ -59,6 +59,9 @@ namespace Verdandi
         void Initialize(VerdandiOps& configuration_stream);
         void Finalize();
 
+        void WriteState(ostream& stream) const;
+        void ReadState(istream& stream);
+
         double Normal(double mean, double variance,
                       Vector<double, VectFull>& parameter);
         double LogNormal(double mean, double variance,
@@ -0,0 +1,184 @@
+// Copyright (C) 2026
+// Author(s): agent
+//
+// This file is part of the data assimilation library Verdandi.
+//
+// Verdandi is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Verdandi is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Verdandi. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Verdandi web site:
+//      http://verdandi.gforge.inria.fr/
+
+
+#ifndef VERDANDI_FILE_METHOD_TRAJECTORYARENA_CXX
+
+#include "TrajectoryArena.hxx"
+
+
+namespace Verdandi
+{
+
+
+    /////////////////
+    // CONSTRUCTOR //
+    /////////////////
+
+
+    //! Main constructor.
+    template <class T>
+    TrajectoryArena<T>::TrajectoryArena():
+        precision_("double"), Nstate_(0), Nstep_(0)
+    {
+    }
+
+
+    /////////////
+    // METHODS //
+    /////////////
+
+
+    //! Initializes the arena.
+    /*! The storage is released if the number of values per state or the
+      precision changes.
+      \param[in] Nstate number of values per state.
+      \param[in] precision precision of the stored states: "double" or
+      "single".
+    */
+    template <class T>
+    void TrajectoryArena<T>::Initialize(int Nstate, string precision)
+    {
+        if (precision != "double" && precision != "single")
+            throw ErrorArgument("TrajectoryArena::Initialize",
+                                "The precision should be \"double\" or "
+                                "\"single\", not \"" + precision + "\".");
+        if (Nstate != Nstate_ || precision != precision_)
+            Deallocate();
+        Nstate_ = Nstate;
+        precision_ = precision;
+        Nstep_ = 0;
+    }
+
+
+    //! Removes all steps, but keeps the storage.
+    template <class T>
+    void TrajectoryArena<T>::Clear()
+    {
+        Nstep_ = 0;
+    }
+
+
+    //! Removes all steps and releases the storage.
+    template <class T>
+    void TrajectoryArena<T>::Deallocate()
+    {
+        state_.Clear();
+        single_state_.Clear();
+        time_.Clear();
+        Nstep_ = 0;
+    }
+
+
+    //! Appends a state to the trajectory.
+    /*!
+      \param[in] time the time of the state.
+      \param[in] state the state to be stored.
+    */
+    template <class T>
+    template <class StateVector>
+    void TrajectoryArena<T>::Save(double time, const StateVector& state)
+    {
+        int capacity = time_.GetM();
+        if (Nstep_ == capacity)
+        {
+            capacity = max(2 * capacity, 16);
+            time_.Resize(capacity);
+            if (precision_ == "single")
+                single_state_.Resize(capacity, Nstate_);
+            else
+                state_.Resize(capacity, Nstate_);
+        }
+
+        size_t offset = size_t(Nstep_) * size_t(Nstate_);
+        if (precision_ == "single")
+        {
+            float* row = single_state_.GetData() + offset;
+            for (int i = 0; i < Nstate_; i++)
+                row[i] = float(state(i));
+        }
+        else
+        {
+            T* row = state_.GetData() + offset;
+            for (int i = 0; i < Nstate_; i++)
+                row[i] = state(i);
+        }
+        time_(Nstep_) = time;
+        Nstep_++;
+    }
+
+
+    //! Retrieves a state from the trajectory.
+    /*!
+      \param[in] step the index of the step in the trajectory.
+      \param[out] state the state stored at step \a step. It is only
+      reallocated if its size differs from the size of the states.
+    */
+    template <class T>
+    template <class StateVector>
+    void TrajectoryArena<T>::Load(int step, StateVector& state) const
+    {
+        if (state.GetM() != Nstate_)
+            state.Reallocate(Nstate_);
+        size_t offset = size_t(step) * size_t(Nstate_);
+        if (precision_ == "single")
+        {
+            const float* row = single_state_.GetData() + offset;
+            for (int i = 0; i < Nstate_; i++)
+                state(i) = T(row[i]);
+        }
+        else
+        {
+            const T* row = state_.GetData() + offset;
+            for (int i = 0; i < Nstate_; i++)
+                state(i) = row[i];
+        }
+    }
+
+
+    //! Returns the time of a step.
+    /*!
+      \param[in] step the index of the step in the trajectory.
+      \return The time of step \a step.
+    */
+    template <class T>
+    double TrajectoryArena<T>::GetTime(int step) const
+    {
+        return time_(step);
+    }
+
+
+    //! Returns the number of steps in the trajectory.
+    /*!
+      \return The number of steps stored since the last call to Clear().
+    */
+    template <class T>
+    int TrajectoryArena<T>::GetNstep() const
+    {
+        return Nstep_;
+    }
+
+
+} // namespace Verdandi.
+
+
+#define VERDANDI_FILE_METHOD_TRAJECTORYARENA_CXX
+#endif
@@ -0,0 +1,91 @@
+// Copyright (C) 2026
+// Author(s): agent
+//
+// This file is part of the data assimilation library Verdandi.
+//
+// Verdandi is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Verdandi is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Verdandi. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Verdandi web site:
+//      http://verdandi.gforge.inria.fr/
+
+
+#ifndef VERDANDI_FILE_METHOD_TRAJECTORYARENA_HXX
+
+
+namespace Verdandi
+{
+
+
+    /////////////////////
+    // TRAJECTORYARENA //
+    /////////////////////
+
+
+    //! This class stores a trajectory of model states in memory.
+    /*! The states are stored one step per row of a matrix, with their times.
+      The storage is only enlarged when a trajectory is longer than all
+      previous ones, by doubling its capacity, and it is kept when the
+      trajectory is cleared, so that the successive trajectories of an
+      optimization are stored without any allocation once the first one is
+      stored. With the "single" precision, the states are rounded to single
+      precision, which halves the memory.
+    */
+    template <class T>
+    class TrajectoryArena
+    {
+
+    protected:
+
+        //! Precision of the stored states: "double" or "single".
+        string precision_;
+        //! Number of values per state.
+        int Nstate_;
+        //! Number of steps in the trajectory.
+        int Nstep_;
+        //! States, one step per row ("double").
+        Matrix<T> state_;
+        //! States, one step per row ("single").
+        Matrix<float> single_state_;
+        /*! \brief Times of the steps; its size is the capacity of the
+          storage. */
+        Vector<double> time_;
+
+    public:
+
+        /*** Constructor ***/
+
+        TrajectoryArena();
+
+        /*** Methods ***/
+
+        void Initialize(int Nstate, string precision = "double");
+        void Clear();
+        void Deallocate();
+
+        template <class StateVector>
+        void Save(double time, const StateVector& state);
+        template <class StateVector>
+        void Load(int step, StateVector& state) const;
+
+        double GetTime(int step) const;
+        int GetNstep() const;
+
+    };
+
+
+} // namespace Verdandi.
+
+
+#define VERDANDI_FILE_METHOD_TRAJECTORYARENA_HXX
+#endif
@@ -0,0 +1,328 @@
+// Copyright (C) 2026
+// Author(s): agent
+//
+// This file is part of the data assimilation library Verdandi.
+//
+// Verdandi is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Verdandi is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Verdandi. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Verdandi web site:
+//      http://verdandi.gforge.inria.fr/
+
+
+#ifndef VERDANDI_FILE_METHOD_TRAJECTORYFILE_CXX
+
+#include "TrajectoryFile.hxx"
+
+#include <cerrno>
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+
+namespace Verdandi
+{
+
+
+    ////////////////////////////////
+    // CONSTRUCTOR AND DESTRUCTOR //
+    ////////////////////////////////
+
+
+    //! Main constructor.
+    template <class T>
+    TrajectoryFile<T>::TrajectoryFile():
+#ifndef WIN32
+        Nvalue_(0), Nrecord_(0), descriptor_(-1), mapping_(0),
+        mapping_size_(0), page_size_(size_t(sysconf(_SC_PAGESIZE)))
+#else
+        Nvalue_(0), Nrecord_(0), buffer_index_(-1)
+#endif
+    {
+    }
+
+
+    //! Destructor.
+    template <class T>
+    TrajectoryFile<T>::~TrajectoryFile()
+    {
+        Close();
+    }
+
+
+    /////////////
+    // METHODS //
+    /////////////
+
+
+    //! Opens the file.
+    /*! The file is created, or emptied if it already exists. It remains open
+      until Close() is called.
+      \param[in] file_name path to the file.
+    */
+    template <class T>
+    void TrajectoryFile<T>::Open(string file_name)
+    {
+        Close();
+        file_name_ = file_name;
+        Nvalue_ = 0;
+        Nrecord_ = 0;
+#ifndef WIN32
+        descriptor_ = open(file_name_.c_str(), O_RDWR | O_CREAT | O_TRUNC,
+                           0644);
+        if (descriptor_ < 0)
+            throw ErrorIO("TrajectoryFile::Open(string)",
+                          "Unable to open file \"" + file_name_ + "\".");
+#else
+        stream_.open(file_name_.c_str(), fstream::in | fstream::out
+                     | fstream::binary | fstream::trunc);
+        if (!stream_.is_open())
+            throw ErrorIO("TrajectoryFile::Open(string)",
+                          "Unable to open file \"" + file_name_ + "\".");
+#endif
+    }
+
+
+    //! Closes the file.
+    /*! The file is left on disk. */
+    template <class T>
+    void TrajectoryFile<T>::Close()
+    {
+#ifndef WIN32
+        Unmap();
+        if (descriptor_ >= 0)
+            close(descriptor_);
+        descriptor_ = -1;
+#else
+        if (stream_.is_open())
+            stream_.close();
+        buffer_.Clear();
+        buffer_index_ = -1;
+#endif
+        Nvalue_ = 0;
+        Nrecord_ = 0;
+    }
+
+
+    //! Checks whether the file is open.
+    /*!
+      \return True if the file is open, false otherwise.
+    */
+    template <class T>
+    bool TrajectoryFile<T>::IsOpen() const
+    {
+#ifndef WIN32
+        return descriptor_ >= 0;
+#else
+        return stream_.is_open();
+#endif
+    }
+
+
+    //! Removes all records from the file.
+    /*! The file remains open. */
+    template <class T>
+    void TrajectoryFile<T>::Clear()
+    {
+#ifndef WIN32
+        Unmap();
+        if (descriptor_ >= 0 && ftruncate(descriptor_, 0) != 0)
+            throw ErrorIO("TrajectoryFile::Clear()",
+                          "Unable to empty file \"" + file_name_ + "\".");
+        Nvalue_ = 0;
+        Nrecord_ = 0;
+#else
+        if (stream_.is_open())
+            Open(file_name_);
+#endif
+    }
+
+
+    //! Writes a record.
+    /*! All records have the same number of values, set by the first record
+      written after the file is opened or cleared. The records are written
+      in sequence: \a index is at most the current number of records, in
+      which case the record is appended.
+      \param[in] index index of the record.
+      \param[in] data values of the record.
+      \param[in] Nvalue number of values in \a data.
+    */
+    template <class T>
+    void TrajectoryFile<T>::Write(int index, const T* data, int Nvalue)
+    {
+        if (!IsOpen())
+            throw ErrorProcessing("TrajectoryFile::Write",
+                                  "The file is not open.");
+        if (Nrecord_ == 0)
+            Nvalue_ = Nvalue;
+        else if (Nvalue != Nvalue_)
+            throw ErrorArgument("TrajectoryFile::Write",
+                                "The record has " + to_str(Nvalue)
+                                + " values, but the records of file \""
+                                + file_name_ + "\" have "
+                                + to_str(Nvalue_) + " values.");
+        if (index < 0 || index > Nrecord_)
+            throw ErrorArgument("TrajectoryFile::Write",
+                                "Unable to write record "
+                                + to_str(index) + " in file \""
+                                + file_name_ + "\", which has "
+                                + to_str(Nrecord_) + " records.");
+
+        size_t size = size_t(Nvalue_) * sizeof(T);
+#ifndef WIN32
+        // An overwritten record may already be mapped.
+        if (index < Nrecord_)
+            Unmap();
+        const char* buffer = reinterpret_cast<const char*>(data);
+        off_t offset = off_t(index) * off_t(size);
+        while (size > 0)
+        {
+            ssize_t Nwritten = pwrite(descriptor_, buffer, size, offset);
+            if (Nwritten < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw ErrorIO("TrajectoryFile::Write",
+                              "Unable to write in file \"" + file_name_
+                              + "\".");
+            }
+            buffer += Nwritten;
+            size -= size_t(Nwritten);
+            offset += Nwritten;
+        }
+#else
+        if (index == buffer_index_)
+            buffer_index_ = -1;
+        stream_.clear();
+        stream_.seekp(streampos(index) * streamoff(size));
+        stream_.write(reinterpret_cast<const char*>(data), size);
+        if (!stream_.good())
+            throw ErrorIO("TrajectoryFile::Write",
+                          "Unable to write in file \"" + file_name_
+                          + "\".");
+#endif
+        Nrecord_ = max(Nrecord_, index + 1);
+    }
+
+
+    //! Reads a record.
+    /*! On POSIX systems, the file is mapped in memory, and the returned
+      pointer points into the mapping: nothing is copied. The mapping is
+      private, so the values may be modified in memory without altering the
+      file. The mapping is only extended when a record beyond it is read.
+      Otherwise, the record is read in a buffer, unless it is already
+      there.
+      \param[in] index index of the record.
+      \return A pointer to the values of the record. It remains valid until
+      the next call to Read, Write, Clear or Close.
+    */
+    template <class T>
+    const T* TrajectoryFile<T>::Read(int index)
+    {
+        if (index < 0 || index >= Nrecord_)
+            throw ErrorArgument("TrajectoryFile::Read",
+                                "Unable to read record "
+                                + to_str(index) + " in file \""
+                                + file_name_ + "\", which has "
+                                + to_str(Nrecord_) + " records.");
+
+        size_t size = size_t(Nvalue_) * sizeof(T);
+#ifndef WIN32
+        if (mapping_ == 0 || size_t(index + 1) * size > mapping_size_)
+        {
+            Unmap();
+            size_t mapping_size = size_t(Nrecord_) * size;
+            void* address = mmap(0, mapping_size, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE, descriptor_, 0);
+            if (address == MAP_FAILED)
+                throw ErrorIO("TrajectoryFile::Read",
+                              "Unable to map file \"" + file_name_
+                              + "\" in memory.");
+            mapping_ = static_cast<T*>(address);
+            mapping_size_ = mapping_size;
+            // The records are mostly read backward, for which the default
+            // readahead is useless. Prefetch() gives the hints instead.
+            posix_madvise(address, mapping_size_, POSIX_MADV_RANDOM);
+        }
+        return mapping_ + size_t(index) * size_t(Nvalue_);
+#else
+        if (index != buffer_index_)
+        {
+            buffer_.Reallocate(Nvalue_);
+            stream_.clear();
+            stream_.seekg(streampos(index) * streamoff(size));
+            stream_.read(reinterpret_cast<char*>(buffer_.GetData()), size);
+            if (!stream_.good())
+                throw ErrorIO("TrajectoryFile::Read",
+                              "Unable to read in file \"" + file_name_
+                              + "\".");
+            buffer_index_ = index;
+        }
+        return buffer_.GetData();
+#endif
+    }
+
+
+    //! Announces that a record will be read soon.
+    /*! On POSIX systems, the operating system is advised to load the pages
+      of the record, if it is in the current mapping. This is only a hint:
+      nothing is done otherwise.
+      \param[in] index index of the record.
+    */
+    template <class T>
+    void TrajectoryFile<T>::Prefetch(int index)
+    {
+#ifndef WIN32
+        size_t size = size_t(Nvalue_) * sizeof(T);
+        if (mapping_ == 0 || index < 0
+            || size_t(index + 1) * size > mapping_size_)
+            return;
+        size_t first = size_t(index) * size;
+        size_t offset = first - first % page_size_;
+        posix_madvise(reinterpret_cast<char*>(mapping_) + offset,
+                      first + size - offset, POSIX_MADV_WILLNEED);
+#endif
+    }
+
+
+    //! Returns the number of records.
+    /*!
+      \return The number of records in the file.
+    */
+    template <class T>
+    int TrajectoryFile<T>::GetNrecord() const
+    {
+        return Nrecord_;
+    }
+
+
+    //! Removes the memory mapping of the file, if any.
+    template <class T>
+    void TrajectoryFile<T>::Unmap()
+    {
+#ifndef WIN32
+        if (mapping_ != 0)
+            munmap(mapping_, mapping_size_);
+        mapping_ = 0;
+        mapping_size_ = 0;
+#endif
+    }
+
+
+} // namespace Verdandi.
+
+
+#define VERDANDI_FILE_METHOD_TRAJECTORYFILE_CXX
+#endif
@@ -0,0 +1,115 @@
+// Copyright (C) 2026
+// Author(s): agent
+//
+// This file is part of the data assimilation library Verdandi.
+//
+// Verdandi is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Verdandi is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Verdandi. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Verdandi web site:
+//      http://verdandi.gforge.inria.fr/
+
+
+#ifndef VERDANDI_FILE_METHOD_TRAJECTORYFILE_HXX
+
+#ifdef WIN32
+#include <fstream>
+#endif
+
+
+namespace Verdandi
+{
+
+
+    ////////////////////
+    // TRAJECTORYFILE //
+    ////////////////////
+
+
+    //! This class stores model states in a file, as fixed-size records.
+    /*! The file is opened once and kept open until it is closed. Record
+      \a i holds the values of the \a i-th state, with no header, at offset
+      \f$i N_{value}\f$ values. On POSIX systems, the records are read
+      through a memory mapping of the file, so that a read returns a pointer
+      into the mapping and copies nothing. Otherwise, the last record read is
+      buffered.
+    */
+    template <class T>
+    class TrajectoryFile
+    {
+
+    protected:
+
+        //! Path to the file.
+        string file_name_;
+        //! Number of values per record.
+        int Nvalue_;
+        //! Number of records in the file.
+        int Nrecord_;
+
+#ifndef WIN32
+        //! File descriptor (-1 if the file is closed).
+        int descriptor_;
+        //! Memory mapping of the file (null if not mapped).
+        T* mapping_;
+        //! Size in bytes of \a mapping_.
+        size_t mapping_size_;
+        //! Size in bytes of a memory page.
+        size_t page_size_;
+#else
+        //! Stream to the file.
+        fstream stream_;
+        //! Last record read.
+        Vector<T> buffer_;
+        //! Index of the record in \a buffer_ (-1 if none).
+        int buffer_index_;
+#endif
+
+    public:
+
+        /*** Constructor and destructor ***/
+
+        TrajectoryFile();
+        ~TrajectoryFile();
+
+        /*** Methods ***/
+
+        void Open(string file_name);
+        void Close();
+        bool IsOpen() const;
+        void Clear();
+
+        void Write(int index, const T* data, int Nvalue);
+        const T* Read(int index);
+        void Prefetch(int index);
+
+        int GetNrecord() const;
+
+    protected:
+
+        void Unmap();
+
+    private:
+
+        // The file descriptor and the memory mapping are owned by the
+        // object, so that it cannot be copied.
+        TrajectoryFile(const TrajectoryFile&);
+        TrajectoryFile& operator=(const TrajectoryFile&);
+    };
+
+
+} // namespace Verdandi.
+
+
+#define VERDANDI_FILE_METHOD_TRAJECTORYFILE_HXX
+#endif
@@ -24,6 +24,8 @@
 
 #include "TrajectoryManager.hxx"
 
+#include "TrajectoryFile.cxx"
+
 #include "seldon/vector/VectorCollection.cxx"
 
 
@@ -38,7 +40,9 @@ namespace Verdandi
 
     //! Main constructor.
     template <class Model>
-    TrajectoryManager<Model>::TrajectoryManager()
+    TrajectoryManager<Model>::TrajectoryManager():
+        Nsave_call_(0), checkpoint_schedule_("uniform"), Ncheckpoint_max_(0),
+        Nstep_(0), Nrecomputed_step_(0)
     {
     }
 
@@ -66,6 +70,13 @@ namespace Verdandi
       \param[in] loaded_trajectory_recording_file loaded trajectory
       recording file.
       \param[in] Nskip_checkpoint recording period for checkpoint.
+      \param[in] checkpoint_schedule checkpointing schedule: "uniform" (a
+      checkpoint every \a Nskip_checkpoint steps, and the steps between two
+      checkpoints are recomputed at once) or "binomial" (the checkpoints
+      follow the optimal binomial schedule, which minimizes the number of
+      recomputed steps for a given number of checkpoints).
+      \param[in] Ncheckpoint_max maximum number of checkpoints held at once,
+      for the binomial schedule.
     */
     template <class Model>
     void TrajectoryManager<Model>
@@ -73,8 +84,33 @@ namespace Verdandi
                  string checkpoint_recording_file,
                  string loaded_trajectory_recording_mode,
                  string loaded_trajectory_recording_file,
-                 int Nskip_checkpoint)
+                 int Nskip_checkpoint, string checkpoint_schedule,
+                 int Ncheckpoint_max)
     {
+        if (checkpoint_schedule != "uniform"
+            && checkpoint_schedule != "binomial")
+            throw ErrorArgument("TrajectoryManager<Model>::Initialize",
+                                "The checkpoint schedule should be "
+                                "\"uniform\" or \"binomial\", not \""
+                                + checkpoint_schedule + "\".");
+        if (checkpoint_schedule == "binomial")
+        {
+            if (Ncheckpoint_max < 1)
+                throw ErrorArgument("TrajectoryManager<Model>::Initialize",
+                                    "At least one checkpoint is required "
+                                    "with the binomial schedule.");
+            if (checkpoint_recording_mode != "memory")
+                throw ErrorArgument("TrajectoryManager<Model>::Initialize",
+                                    "With the binomial schedule, the "
+                                    "checkpoints should be recorded in "
+                                    "memory.");
+        }
+        checkpoint_schedule_ = checkpoint_schedule;
+        Ncheckpoint_max_ = Ncheckpoint_max;
+        Nstep_ = 0;
+        next_checkpoint_step_ = 0;
+        current_step_ = -1;
+        Nrecomputed_step_ = 0;
         checkpoint_recording_mode_ = checkpoint_recording_mode;
         checkpoint_recording_file_ = checkpoint_recording_file;
         loaded_trajectory_recording_mode_ = loaded_trajectory_recording_mode;
@@ -85,10 +121,13 @@ namespace Verdandi
         Nstate_ = 0;
         checkpoint_index_ = -1;
         loaded_trajectory_index_ = -1;
+        mapped_state_.Nullify();
+        checkpoint_file_.Close();
+        loaded_trajectory_file_.Close();
         if (checkpoint_recording_mode_ == "disk")
-            EmptyFile(checkpoint_recording_file);
-        if (loaded_trajectory_recording_mode == "disk")
-            EmptyFile(loaded_trajectory_recording_mode);
+            checkpoint_file_.Open(checkpoint_recording_file_);
+        if (loaded_trajectory_recording_mode_ == "disk")
+            loaded_trajectory_file_.Open(loaded_trajectory_recording_file_);
     }
 
 
@@ -101,27 +140,30 @@ namespace Verdandi
     void TrajectoryManager<Model>::Save(model_state& state,
                                            double time)
     {
+        if (checkpoint_schedule_ == "binomial")
+        {
+            // The checkpoints of the binomial schedule that lie on the path
+            // to the last step are taken during the recording. The number of
+            // steps is taken from the previous recording.
+            step_time_.PushBack(time);
+            if (Nsave_call_ == next_checkpoint_step_)
+            {
+                checkpoint_.push_back(state);
+                checkpoint_step_.push_back(Nsave_call_);
+                Ncheckpoint_++;
+                next_checkpoint_step_ = GetNextCheckpointStep();
+            }
+            Nsave_call_++;
+            return;
+        }
+
         if ((Nsave_call_ % Nskip_checkpoint_) == 0)
         {
             if (checkpoint_recording_mode_ == "memory")
                 checkpoint_.push_back(state);
             else
-            {
-                fstream file_stream;
-                file_stream.open(checkpoint_recording_file_.c_str());
-#ifdef VERDANDI_CHECK_IO
-                // Checks if the file was opened.
-                if (!file_stream.is_open())
-                    throw ErrorIO("TrajectoryManager<Model>"
-                                  "::Save", "Unable to open file \""
-                                  + checkpoint_recording_file_ + "\".");
-#endif
-                streampos
-                    position = Ncheckpoint_ *
-                    (state.GetM() * sizeof(Ts) + sizeof(int));
-                file_stream.seekg(position);
-                state.Write(file_stream, true);
-            }
+                checkpoint_file_.Write(Ncheckpoint_, state.GetData(),
+                                       state.GetM());
             checkpoint_time_.PushBack(time);
             Ncheckpoint_++;
         }
@@ -138,6 +180,11 @@ namespace Verdandi
     void TrajectoryManager<Model>::SetTime(Model& model, double time)
     {
         Nstate_ = model.GetNstate();
+        if (checkpoint_schedule_ == "binomial")
+        {
+            SetTimeBinomial(model, time);
+            return;
+        }
         if (checkpoint_index_ >= 0
             && loaded_trajectory_index_ >= 0
             && loaded_time_(loaded_trajectory_index_) == time)
@@ -209,7 +256,10 @@ namespace Verdandi
         if (loaded_trajectory_recording_mode_ == "memory")
             loaded_trajectory_.clear();
         else
-            EmptyFile(loaded_trajectory_recording_file_);
+        {
+            mapped_state_.Nullify();
+            loaded_trajectory_file_.Clear();
+        }
         loaded_time_.Clear();
         model.SetTime(checkpoint_time_(checkpoint_index_));
         if (checkpoint_recording_mode_ == "memory")
@@ -219,23 +269,13 @@ namespace Verdandi
         }
         else
         {
-            ifstream file_stream;
-            file_stream.open(checkpoint_recording_file_.c_str());
-#ifdef VERDANDI_CHECK_IO
-            // Checks if the file was opened.
-            if (!file_stream.is_open())
-                throw ErrorIO("TrajectoryManager<Model>"
-                              "::SetTime", "Unable to open file \""
-                              + checkpoint_recording_file_ + "\".");
-#endif
+            // The checkpoints are loaded backward in time.
             model_state input_data;
-            streampos position;
-            position = checkpoint_index_ *
-                (model.GetNstate() * sizeof(Ts) + sizeof(int));
-            file_stream.seekg(position);
-            input_data.Read(file_stream);
-            file_stream.close();
+            input_data.SetData(Nstate_, const_cast<Ts*>(
+                                   checkpoint_file_.Read(checkpoint_index_)));
+            checkpoint_file_.Prefetch(checkpoint_index_ - 1);
             Copy(input_data, tmp);
+            input_data.Nullify();
             model.StateUpdated();
         }
 
@@ -250,34 +290,27 @@ namespace Verdandi
                 loaded_trajectory_.push_back(state);
                 loaded_time_.PushBack(tmp_time);
                 model.Forward();
+                Nrecomputed_step_++;
                 if (tmp_time == time)
                     loaded_trajectory_index_ = t;
             }
         }
         else
         {
-            fstream file_stream;
-            file_stream.open(loaded_trajectory_recording_file_.c_str());
-#ifdef VERDANDI_CHECK_IO
-            // Checks if the file was opened.
-            if (!file_stream.is_open())
-                throw ErrorIO("TrajectoryManager<Model>"
-                              "::SetTime", "Unable to open file \""
-                              + loaded_trajectory_recording_file_ + "\".");
-#endif
             double tmp_time;
             for (int t = 0; t < Nskip_checkpoint_ && !model.HasFinished();
                  t++)
             {
                 model_state& state = model.GetState();
                 tmp_time = model.GetTime();
-                state.Write(file_stream, true);
+                loaded_trajectory_file_.Write(t, state.GetData(),
+                                              state.GetM());
                 loaded_time_.PushBack(tmp_time);
                 model.Forward();
+                Nrecomputed_step_++;
                 if (tmp_time == time)
                     loaded_trajectory_index_ = t;
             }
-            file_stream.close();
         }
         Copy(saved_state, tmp);
         model.StateUpdated();
@@ -293,28 +326,23 @@ namespace Verdandi
     typename TrajectoryManager<Model>::model_state&
     TrajectoryManager<Model>::GetState()
     {
+        if (checkpoint_schedule_ == "binomial")
+            return input_data_;
+
         if (loaded_trajectory_recording_mode_ == "memory")
             return loaded_trajectory_[loaded_trajectory_index_];
 
         if (Nstate_ == 0)
             throw ErrorProcessing("TrajectoryManager<Model>::GetState()",
                                   "Nstate = 0");
-        ifstream file_stream;
-        file_stream.open(loaded_trajectory_recording_file_.c_str());
-#ifdef VERDANDI_CHECK_IO
-        // Checks if the file was opened.
-        if (!file_stream.is_open())
-            throw ErrorIO("TrajectoryManager<Model>"
-                          "::GetState", "Unable to open file \""
-                          + loaded_trajectory_recording_file_ + "\".");
-#endif
-        streampos position;
-        position = loaded_trajectory_index_ *
-            (Nstate_ * sizeof(Ts) + sizeof(int));
-        file_stream.seekg(position);
-        input_data_.Read(file_stream);
-        file_stream.close();
-        return input_data_;
+        // The record is not copied: 'mapped_state_' points to it. The states
+        // are loaded backward in time, so the previous record is announced.
+        mapped_state_.Nullify();
+        mapped_state_.SetData(Nstate_, const_cast<Ts*>(
+                                  loaded_trajectory_file_
+                                  .Read(loaded_trajectory_index_)));
+        loaded_trajectory_file_.Prefetch(loaded_trajectory_index_ - 1);
+        return mapped_state_;
     }
 
 
@@ -325,14 +353,37 @@ namespace Verdandi
     template <class Model>
     double TrajectoryManager<Model>::GetTime()
     {
+        if (checkpoint_schedule_ == "binomial")
+            return step_time_(current_step_);
         return loaded_time_(loaded_trajectory_index_);
     }
 
 
+    //! Returns the number of recomputed forward steps.
+    /*!
+      \return The number of model steps recomputed to load states since the
+      last call to Deallocate().
+    */
+    template <class Model>
+    int TrajectoryManager<Model>::GetNrecomputedStep() const
+    {
+        return Nrecomputed_step_;
+    }
+
+
     //! Clears inner vector collection.
     template <class Model>
     void TrajectoryManager<Model>::Deallocate()
     {
+        // The number of steps is kept for the checkpoints of the next
+        // recording.
+        if (Nsave_call_ > 0)
+            Nstep_ = Nsave_call_;
+        checkpoint_step_.clear();
+        step_time_.Clear();
+        next_checkpoint_step_ = 0;
+        current_step_ = -1;
+        Nrecomputed_step_ = 0;
         checkpoint_.clear();
         loaded_trajectory_.clear();
         checkpoint_time_.Clear();
@@ -341,10 +392,9 @@ namespace Verdandi
         checkpoint_index_ = -1;
         loaded_trajectory_index_ = -1;
         Nsave_call_ = 0;
-        if (checkpoint_recording_mode_ == "disk")
-            EmptyFile(checkpoint_recording_file_);
-        if (loaded_trajectory_recording_mode_ == "disk")
-            EmptyFile(loaded_trajectory_recording_file_);
+        mapped_state_.Nullify();
+        checkpoint_file_.Clear();
+        loaded_trajectory_file_.Clear();
     }
 
 
@@ -364,6 +414,134 @@ namespace Verdandi
     }
 
 
+    //! Loads the state at a given time, with the binomial schedule.
+    /*! The checkpoints after \a time are discarded. The state is then
+      recomputed from the last remaining checkpoint, and the free checkpoints
+      are placed on the way according to the binomial schedule, so that the
+      next states, requested backward in time, are recomputed at minimal
+      cost.
+      \param[in] model the model.
+      \param[in] time a given time.
+    */
+    template <class Model>
+    void TrajectoryManager<Model>::SetTimeBinomial(Model& model, double time)
+    {
+        // Searches for the step, starting from the last loaded one.
+        int step = current_step_ >= 0 ? current_step_ : Nsave_call_ - 1;
+        while (step >= 0 && step_time_(step) > time)
+            step--;
+        while (step + 1 < Nsave_call_ && step_time_(step + 1) <= time)
+            step++;
+        if (step < 0 || step_time_(step) != time)
+            throw ErrorProcessing("void TrajectoryManager<Model>"
+                                  "::SetTime(Model& model, double time)",
+                                  "No state was saved at time: "
+                                  + to_str(time) + ".");
+        if (step == current_step_)
+            return;
+        current_step_ = step;
+
+        while (checkpoint_step_.back() > step)
+        {
+            checkpoint_.pop_back();
+            checkpoint_step_.pop_back();
+            Ncheckpoint_--;
+        }
+
+        int first = checkpoint_step_.back();
+        if (first == step)
+        {
+            input_data_ = checkpoint_.back();
+            return;
+        }
+
+        model_state saved_state(model.GetNstate());
+        double saved_time;
+        model_state& tmp = model.GetState();
+        Copy(tmp, saved_state);
+        saved_time = model.GetTime();
+
+        model.SetTime(step_time_(first));
+        Copy(checkpoint_.back(), tmp);
+        model.StateUpdated();
+
+        while (first < step)
+        {
+            int Nfree = Ncheckpoint_max_ - Ncheckpoint_;
+            int last = Nfree > 0 ?
+                first + ComputeBinomialSplit(step - first + 1, Nfree) : step;
+            for (; first < last; first++)
+            {
+                model.Forward();
+                Nrecomputed_step_++;
+            }
+            if (Nfree > 0)
+            {
+                checkpoint_.push_back(model.GetState());
+                checkpoint_step_.push_back(first);
+                Ncheckpoint_++;
+            }
+        }
+        input_data_ = model.GetState();
+
+        Copy(saved_state, tmp);
+        model.StateUpdated();
+        model.SetTime(saved_time);
+    }
+
+
+    //! Returns the step of the next checkpoint during the recording.
+    /*! The checkpoints are those that the binomial schedule places on the
+      way to the last step, from the last checkpoint.
+      \return The step of the next checkpoint, or -1 if no checkpoint should
+      be recorded (e.g., because the number of steps is still unknown).
+    */
+    template <class Model>
+    int TrajectoryManager<Model>::GetNextCheckpointStep() const
+    {
+        int first = checkpoint_step_.back();
+        int Nfree = Ncheckpoint_max_ - Ncheckpoint_;
+        if (Nfree <= 0 || Nstep_ - first <= 1)
+            return -1;
+        return first + ComputeBinomialSplit(Nstep_ - first, Nfree);
+    }
+
+
+    //! Computes the optimal position of the next checkpoint.
+    /*! The states of \a Nstep consecutive steps are to be loaded backward in
+      time, from a checkpoint at the first step and with \a Nfree additional
+      checkpoints. With \f$s = N_{free} + 1\f$ and \f$\beta(s, r) = {s + r
+      \choose s}\f$, let \f$r\f$ be the smallest integer such that
+      \f$\beta(s, r) \ge N_{step}\f$. Placing the next checkpoint \f$m\f$
+      steps further, with \f$m = \max(1, \beta(s, r - 2), N_{step} - \beta(s
+      - 1, r))\f$, minimizes the number of recomputed steps, which is then
+      \f$r N_{step} - \beta(s + 1, r - 1)\f$ (Griewank, 1992).
+      \param[in] Nstep the number of steps to be loaded.
+      \param[in] Nfree the number of free checkpoints (at least 1).
+      \return The number of steps between the first step and the next
+      checkpoint.
+    */
+    template <class Model>
+    int TrajectoryManager<Model>::ComputeBinomialSplit(int Nstep,
+                                                       int Nfree) const
+    {
+        int s = Nfree + 1;
+        // beta(s, r), beta(s, r - 1), beta(s, r - 2) and beta(s - 1, r).
+        double beta = 1., beta_1 = 0., beta_2 = 0., beta_s = 1.;
+        int r = 0;
+        while (beta < double(Nstep))
+        {
+            r++;
+            beta_2 = beta_1;
+            beta_1 = beta;
+            beta_s = beta_s * double(s - 1 + r) / double(r);
+            beta = beta * double(s + r) / double(r);
+        }
+        double split = max(max(1., beta_2), double(Nstep) - beta_s);
+        return min(int(split + 0.5), Nstep - 1);
+    }
+
+
 
 } // namespace Verdandi.
 
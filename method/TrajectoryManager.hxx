@@ -19,6 +19,7 @@
 
 #ifndef VERDANDI_FILE_METHOD_TRAJECTORYMANAGER_HXX
 
+#include "TrajectoryFile.hxx"
 
 namespace Verdandi
 {
@@ -60,7 +61,7 @@ namespace Verdandi
         int Ncheckpoint_;
         //! Trajectory saved in first forward loop.
         vector<model_state> checkpoint_;
-        //! Times associated with \a checkpoint_ .
+        //! Times associated with \a checkpoint_ ("uniform").
         Vector<double> checkpoint_time_;
 
         //! Trajectory saved in backward loop.
@@ -74,6 +75,33 @@ namespace Verdandi
         //! Loaded trajectory index.
         int loaded_trajectory_index_;
 
+        //! File holding the checkpoints ("disk"), kept open.
+        TrajectoryFile<Ts> checkpoint_file_;
+        //! File holding the loaded trajectory ("disk"), kept open.
+        TrajectoryFile<Ts> loaded_trajectory_file_;
+        /*! \brief State returned by GetState() ("disk"): it shares its data
+          with the record read in \a loaded_trajectory_file_. */
+        model_state mapped_state_;
+
+        /*! \brief Checkpointing schedule: "uniform" (a checkpoint every
+          \a Nskip_checkpoint_ steps) or "binomial" (optimal binomial
+          schedule with at most \a Ncheckpoint_max_ checkpoints). */
+        string checkpoint_schedule_;
+        //! Maximum number of checkpoints held at once ("binomial").
+        int Ncheckpoint_max_;
+        //! Steps associated with \a checkpoint_ ("binomial").
+        vector<int> checkpoint_step_;
+        //! Times of all saved steps ("binomial").
+        Vector<double> step_time_;
+        //! Number of steps of the last recorded trajectory.
+        int Nstep_;
+        //! Step of the next checkpoint during the recording ("binomial").
+        int next_checkpoint_step_;
+        //! Step currently loaded ("binomial").
+        int current_step_;
+        //! Number of forward steps recomputed since the last deallocation.
+        int Nrecomputed_step_;
+
     public:
 
         /*** Constructor and destructor ***/
@@ -87,15 +115,24 @@ namespace Verdandi
                         string checkpoint_recording_file = "",
                         string loaded_trajectory_recording_mode = "memory",
                         string loaded_trajectory_recording_file = "",
-                        int Nskip_checkpoint = 1);
+                        int Nskip_checkpoint = 1,
+                        string checkpoint_schedule = "uniform",
+                        int Ncheckpoint_max = 0);
         void Save(model_state& state, double time);
         void SetTime(Model& model, double time);
 
         model_state& GetState();
         double GetTime();
+        int GetNrecomputedStep() const;
         void Deallocate();
         void EmptyFile(string file_name);
 
+    protected:
+
+        void SetTimeBinomial(Model& model, double time);
+        int GetNextCheckpointStep() const;
+        int ComputeBinomialSplit(int Nstep, int Nfree) const;
+
     };
 
 
@@ -176,7 +176,10 @@ namespace Verdandi
         Nstate_ = model_.GetNstate();
         Nobservation_  = observation_manager_.GetNobservation();
 
-        Copy(model_.GetStateErrorVariance(), background_error_variance_);
+        background_error_variance_.Reallocate(Nstate_, Nstate_);
+        background_error_variance_.Zero();
+        AddUpperPart(Ts(1), model_.GetStateErrorVariance(),
+                     background_error_variance_);
 
         if (option_display_["iteration"])
             Logger::StdOut(*this, "Initialization");
@@ -265,22 +268,22 @@ namespace Verdandi
         MessageHandler::Send(*this, "all", "::Forward begin");
 
         // Computes of background error variance Cholesky factorization.
-        model_state_error_variance background_error_variance_sqrt;
-        Copy(background_error_variance_, background_error_variance_sqrt);
-        GetCholesky(background_error_variance_sqrt);
+        SymmetricFactorization<Ts> background_error_variance_sqrt;
+        background_error_variance_sqrt.Factorize(background_error_variance_);
 
         // Computes X_n^{(i)+}.
         model_state_error_variance_row x(Nstate_);
         Copy(model_.GetState(), x);
 
         X_i_trans_.Reallocate(Nsigma_point_, Nstate_);
-        sigma_point x_col;
+        sigma_point x_col, sigma_point_sqrt;
         for (int i = 0; i < Nsigma_point_; i++)
         {
             SetRow(x, i, X_i_trans_);
+            sigma_point_sqrt = sigma_point_collection_.GetVector(i);
+            background_error_variance_sqrt.MltSquareRoot(sigma_point_sqrt);
             GetRowPointer(X_i_trans_, i, x_col);
-            MltAdd(Ts(1), background_error_variance_sqrt,
-                   sigma_point_collection_.GetVector(i), Ts(1), x_col);
+            Add(Ts(1), sigma_point_sqrt, x_col);
             x_col.Nullify();
         }
 
@@ -309,7 +312,7 @@ namespace Verdandi
             {
                 GetRowPointer(X_i_trans_, i, x_col);
                 Add(Ts(-1), x, x_col);
-                Rank1Update(Ts(1), x_col, x_col, background_error_variance_);
+                Rank1Update(Ts(1), x_col, background_error_variance_);
                 x_col.Nullify();
             }
             Mlt(alpha_, background_error_variance_);
@@ -337,8 +340,7 @@ namespace Verdandi
             {
                 GetRowPointer(X_i_trans_, i, x_col);
                 Add(Ts(-1), x, x_col);
-                Rank1Update(alpha_i_(i), x_col, x_col,
-                            background_error_variance_);
+                Rank1Update(alpha_i_(i), x_col, background_error_variance_);
                 x_col.Nullify();
             }
         }
@@ -377,20 +379,20 @@ namespace Verdandi
                             + to_str(model_.GetTime()));
 
         // Computes background error variance Cholesky factorization.
-        model_state_error_variance background_error_variance_sqrt;
-        Copy(background_error_variance_, background_error_variance_sqrt);
-        GetCholesky(background_error_variance_sqrt);
+        SymmetricFactorization<Ts> background_error_variance_sqrt;
+        background_error_variance_sqrt.Factorize(background_error_variance_);
 
         // Computes X_{n + 1}^{(i)-}.
         model_state& x = model_.GetState();
         X_i_trans_.Reallocate(Nsigma_point_, Nstate_);
-        sigma_point x_col;
+        sigma_point x_col, sigma_point_sqrt;
         for (int i = 0; i < Nsigma_point_; i++)
         {
             SetRow(x, i, X_i_trans_);
+            sigma_point_sqrt = sigma_point_collection_.GetVector(i);
+            background_error_variance_sqrt.MltSquareRoot(sigma_point_sqrt);
             GetRowPointer(X_i_trans_, i, x_col);
-            MltAdd(Ts(1), background_error_variance_sqrt,
-                   sigma_point_collection_.GetVector(i), Ts(1), x_col);
+            Add(Ts(1), sigma_point_sqrt, x_col);
             x_col.Nullify();
         }
 
@@ -448,31 +450,28 @@ namespace Verdandi
             Mlt(alpha_, P_xz);
 
             // Computes P_Z = cov(Z_{n + 1}^*, Z_{n + 1}^*).
-            model_state_error_variance P_z(Nobservation_, Nobservation_);
-            P_z.Fill(To(0));
+            // Only its upper part is stored.
+            Matrix<Ts, Symmetric, RowSymPacked> P_z(Nobservation_,
+                                                    Nobservation_);
+            P_z.Fill(Ts(0));
             for (int i = 0; i < Nsigma_point_; i++)
             {
                 GetRowPointer(Z_i_trans, i, z_col);
-                Rank1Update(To(1), z_col, z_col, P_z);
+                Rank1Update(To(1), z_col, P_z);
                 z_col.Nullify();
             }
             Mlt(alpha_, P_z);
-            Add(To(1), observation_manager_.GetErrorVariance(), P_z);
+            AddUpperPart(To(1), observation_manager_.GetErrorVariance(),
+                         P_z);
 
-            // Computes the Kalman gain K_{n + 1}.
-            matrix_state_observation K(Nstate_, Nobservation_);
-            K.Fill(Ts(0));
-            GetInverse(P_z);
-            MltAdd(Ts(1), P_xz, P_z, Ts(0), K);
-
-            // Computes X_{n + 1}^+.
-            MltAdd(Ts(1), K, observation_manager_.GetInnovation(x), Ts(1), x);
+            // Computes X_{n + 1}^+ and P_{n + 1}^+. The Kalman gain is
+            // applied through the Cholesky factorization of P_Z, and
+            // P_{n + 1}^+ is computed with a symmetric rank-k update.
+            ComputeBLUE_Cholesky(P_xz, P_z,
+                                 observation_manager_.GetInnovation(x), x,
+                                 background_error_variance_, true);
 
             model_.StateUpdated();
-
-            // Computes P_{n + 1}^+.
-            MltAdd(Ts(-1), SeldonNoTrans, K, SeldonTrans, P_xz, Ts(1),
-                   background_error_variance_);
         }
         else
         {
@@ -513,30 +512,27 @@ namespace Verdandi
             }
 
             // Computes P_Z = cov(Z_{n + 1}^*, Z_{n + 1}^*).
-            model_state_error_variance P_z(Nobservation_, Nobservation_);
-            P_z.Fill(To(0));
+            // Only its upper part is stored.
+            Matrix<Ts, Symmetric, RowSymPacked> P_z(Nobservation_,
+                                                    Nobservation_);
+            P_z.Fill(Ts(0));
             for (int i = 0; i < Nsigma_point_; i++)
             {
                 GetRowPointer(Z_i_trans, i, z_col);
-                Rank1Update(alpha_i_(i), z_col, z_col, P_z);
+                Rank1Update(alpha_i_(i), z_col, P_z);
                 z_col.Nullify();
             }
-            Add(To(1), observation_manager_.GetErrorVariance(), P_z);
+            AddUpperPart(To(1), observation_manager_.GetErrorVariance(),
+                         P_z);
 
-            // Computes the Kalman gain K_{n + 1}.
-            matrix_state_observation K(Nstate_, Nobservation_);
-            K.Fill(Ts(0));
-            GetInverse(P_z);
-            MltAdd(Ts(1), P_xz, P_z, Ts(0), K);
-
-            // Computes X_{n + 1}^+.
-            MltAdd(Ts(1), K, observation_manager_.GetInnovation(x), Ts(1), x);
+            // Computes X_{n + 1}^+ and P_{n + 1}^+. The Kalman gain is
+            // applied through the Cholesky factorization of P_Z, and
+            // P_{n + 1}^+ is computed with a symmetric rank-k update.
+            ComputeBLUE_Cholesky(P_xz, P_z,
+                                 observation_manager_.GetInnovation(x), x,
+                                 background_error_variance_, true);
 
             model_.StateUpdated();
-
-            // Computes P_{n + 1}^+.
-            MltAdd(Ts(-1), SeldonNoTrans, K, SeldonTrans, P_xz, Ts(1),
-                   background_error_variance_);
         }
 
         MessageHandler::Send(*this, "model", "analysis");
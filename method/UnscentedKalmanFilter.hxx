@@ -89,8 +89,8 @@ namespace Verdandi
         Model model_;
         //! Observation manager.
         ObservationManager observation_manager_;
-        //! Background error covariance matrix (B).
-        model_state_error_variance background_error_variance_;
+        //! Background error covariance matrix (B), upper part only.
+        Matrix<Ts, Symmetric, RowSymPacked> background_error_variance_;
 
         //! Iteration.
         int iteration_;
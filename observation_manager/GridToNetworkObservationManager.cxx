@@ -42,7 +42,8 @@ namespace Verdandi
     */
     template <class T>
     GridToNetworkObservationManager<T>
-    ::GridToNetworkObservationManager(): current_row_(-1)
+    ::GridToNetworkObservationManager():
+        error_variance_version_(0), current_row_(-1)
     {
     }
 
@@ -58,7 +59,7 @@ namespace Verdandi
     GridToNetworkObservationManager<T>
     ::GridToNetworkObservationManager(Model& model,
                                       string configuration_file):
-        current_row_(-1)
+        error_variance_version_(0), current_row_(-1)
     {
     }
 
@@ -182,6 +183,8 @@ namespace Verdandi
         // Sets all active by default.
         SetAllActive();
 
+        InitializeErrorVariance();
+
         int expected_file_size;
         expected_file_size = Nbyte_observation_ *
             int(final_time_ / (Delta_t_ * Nskip_));
@@ -212,6 +215,23 @@ namespace Verdandi
     }
 
 
+    //! Builds the observation error covariance matrix and its inverse.
+    /*! They are computed once for the current set of observations, and the
+      version of the error covariance is incremented. They should not be
+      rebuilt as long as the set of observations is unchanged.
+    */
+    template <class T>
+    void GridToNetworkObservationManager<T>::InitializeErrorVariance()
+    {
+        build_diagonal_sparse_matrix(Nobservation_, error_variance_value_,
+                                     error_variance_);
+        build_diagonal_sparse_matrix(Nobservation_,
+                                     T(T(1) / error_variance_value_),
+                                     error_variance_inverse_);
+        error_variance_version_++;
+    }
+
+
     //! Sets all observation locations as active.
     template <class T>
     void GridToNetworkObservationManager<T>::SetAllActive()
@@ -1468,6 +1488,31 @@ namespace Verdandi
     }
 
 
+    //! Applies the tangent linear operator to a block of vectors.
+    /*!
+      \param[in] X the vectors, stored in the columns of the matrix.
+      \param[out] Y the values of the tangent linear operator at the columns
+      of \a X. It is resized if needed.
+    */
+    template <class T>
+    template <class state_matrix>
+    void GridToNetworkObservationManager<T>
+    ::ApplyTangentLinearOperator(const state_matrix& X, Matrix<T>& Y) const
+    {
+        Y.Reallocate(active_interpolation_index_.GetM(), X.GetN());
+        for (int i = 0; i < Y.GetM(); i++)
+            for (int j = 0; j < Y.GetN(); j++)
+                Y(i, j) = active_interpolation_weight_(i, 0)
+                    * X(active_interpolation_index_(i, 0), j)
+                    + active_interpolation_weight_(i, 1)
+                    * X(active_interpolation_index_(i, 1), j)
+                    + active_interpolation_weight_(i, 2)
+                    * X(active_interpolation_index_(i, 2), j)
+                    + active_interpolation_weight_(i, 3)
+                    * X(active_interpolation_index_(i, 3), j);
+    }
+
+
     //! Linearized observation operator.
     /*!
       \param[in] i row index.
@@ -1609,9 +1654,7 @@ namespace Verdandi
     GridToNetworkObservationManager<T>
     ::GetErrorVariance() const
     {
-        throw ErrorUndefined(
-            string("GridToNetworkObservationManager")
-            +"::GetObservationErrorVariance()");
+        return error_variance_;
     }
 
 
@@ -1623,11 +1666,47 @@ namespace Verdandi
     const typename GridToNetworkObservationManager<T>::error_variance&
     GridToNetworkObservationManager<T>::GetErrorVarianceInverse() const
     {
-        throw ErrorUndefined(
-            "const typename"
-            "GridToNetworkObservationManager::error_variance& "
-            "GridToNetworkObservationManager::GetErrorVarianceInverse()"
-            " const");
+        return error_variance_inverse_;
+    }
+
+
+    //! Returns the version of the observation error covariance matrix.
+    /*! The version changes whenever the observation error covariance matrix
+      is rebuilt, so that any quantity derived from it (e.g., a
+      factorization) may be cached as long as the version is unchanged.
+      \return The version of the observation error covariance matrix.
+    */
+    template <class T>
+    int GridToNetworkObservationManager<T>::GetErrorVarianceVersion() const
+    {
+        return error_variance_version_;
+    }
+
+
+    //! Applies the inverse of the observation error covariance matrix.
+    /*! No matrix is copied or built.
+      \param[in,out] y on entry, a vector in observation space; on exit,
+      \f$R^{-1} y\f$.
+    */
+    template <class T>
+    void GridToNetworkObservationManager<T>
+    ::ApplyErrorVarianceInverse(observation& y) const
+    {
+        Mlt(T(T(1) / error_variance_value_), y);
+    }
+
+
+    //! Applies the inverse of the square root of the error covariance.
+    /*! Since \f$R = \sigma^2 I\f$, its Cholesky factor is \f$\sigma I\f$, and
+      \f$\|R^{-\frac 12} y\|^2 = y^T R^{-1} y\f$.
+      \param[in,out] y on entry, a vector in observation space; on exit,
+      \f$R^{-\frac 12} y\f$.
+    */
+    template <class T>
+    void GridToNetworkObservationManager<T>
+    ::ApplyErrorVarianceInverseSqrt(observation& y) const
+    {
+        Mlt(T(T(1) / sqrt(error_variance_value_)), y);
     }
 
 
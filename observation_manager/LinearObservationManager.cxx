@@ -42,7 +42,8 @@ namespace Verdandi
       with this implementation.
     */
     template <class T>
-    LinearObservationManager<T>::LinearObservationManager():current_row_(-1)
+    LinearObservationManager<T>::LinearObservationManager():
+        error_variance_version_(0), current_row_(-1)
     {
     }
 
@@ -58,7 +59,8 @@ namespace Verdandi
     LinearObservationManager<T>
     ::LinearObservationManager(Model& model,
                                string configuration_file):
-        observation_aggregator_(configuration_file), current_row_(-1)
+        observation_aggregator_(configuration_file),
+        error_variance_version_(0), current_row_(-1)
     {
     }
 
@@ -288,6 +290,18 @@ namespace Verdandi
 #endif
         }
 
+        InitializeErrorVariance();
+    }
+
+
+    //! Builds the observation error covariance matrix and its inverse.
+    /*! They are computed once for the current set of observations, and the
+      version of the error covariance is incremented. They should not be
+      rebuilt as long as the set of observations is unchanged.
+    */
+    template <class T>
+    void LinearObservationManager<T>::InitializeErrorVariance()
+    {
 #ifdef VERDANDI_OBSERVATION_ERROR_SPARSE
         build_diagonal_sparse_matrix(Nobservation_, error_variance_value_,
                                      error_variance_);
@@ -302,7 +316,7 @@ namespace Verdandi
         error_variance_inverse_.SetIdentity();
         Mlt(T(T(1)/ error_variance_value_), error_variance_inverse_);
 #endif
-
+        error_variance_version_++;
     }
 
 
@@ -2000,6 +2014,48 @@ namespace Verdandi
     }
 
 
+    //! Applies the tangent linear operator to a block of vectors.
+    /*! The operator is applied to all columns of \a X at once, so that the
+      cost is that of a single (sparse) matrix-matrix product.
+      \param[in] X the vectors, stored in the columns of the matrix.
+      \param[out] Y the values of the tangent linear operator at the columns
+      of \a X. It is resized if needed.
+    */
+    template <class T>
+    template <class state_matrix>
+    void LinearObservationManager<T>
+    ::ApplyTangentLinearOperator(const state_matrix& X, Matrix<T>& Y) const
+    {
+        if (operator_scaled_identity_)
+        {
+            Y.Reallocate(X.GetM(), X.GetN());
+            for (int i = 0; i < X.GetM(); i++)
+                for (int j = 0; j < X.GetN(); j++)
+                    Y(i, j) = operator_diagonal_value_ * X(i, j);
+        }
+
+        // Operator defined in a file.
+        else
+        {
+            Y.Reallocate(tangent_operator_matrix_.GetM(), X.GetN());
+#if defined(VERDANDI_TANGENT_LINEAR_OPERATOR_SPARSE)    \
+    && !defined(VERDANDI_WITH_MPI)
+            // Only the non-zero entries of the operator are visited.
+            Y.Fill(T(0));
+            const int* ptr = tangent_operator_matrix_.GetPtr();
+            const int* ind = tangent_operator_matrix_.GetInd();
+            const T* data = tangent_operator_matrix_.GetData();
+            for (int i = 0; i < tangent_operator_matrix_.GetM(); i++)
+                for (int p = ptr[i]; p < ptr[i + 1]; p++)
+                    for (int j = 0; j < X.GetN(); j++)
+                        Y(i, j) += data[p] * X(ind[p], j);
+#else
+            MltAdd(T(1), tangent_operator_matrix_, X, T(0), Y);
+#endif
+        }
+    }
+
+
     //! Linearized observation operator.
     /*!
       \param[in] i row index.
@@ -2148,6 +2204,46 @@ namespace Verdandi
     }
 
 
+    //! Returns the version of the observation error covariance matrix.
+    /*! The version changes whenever the observation error covariance matrix
+      is rebuilt, so that any quantity derived from it (e.g., a
+      factorization) may be cached as long as the version is unchanged.
+      \return The version of the observation error covariance matrix.
+    */
+    template <class T>
+    int LinearObservationManager<T>::GetErrorVarianceVersion() const
+    {
+        return error_variance_version_;
+    }
+
+
+    //! Applies the inverse of the observation error covariance matrix.
+    /*! No matrix is copied or built.
+      \param[in,out] y on entry, a vector in observation space; on exit,
+      \f$R^{-1} y\f$.
+    */
+    template <class T>
+    void LinearObservationManager<T>
+    ::ApplyErrorVarianceInverse(observation& y) const
+    {
+        Mlt(T(T(1) / error_variance_value_), y);
+    }
+
+
+    //! Applies the inverse of the square root of the error covariance.
+    /*! Since \f$R = \sigma^2 I\f$, its Cholesky factor is \f$\sigma I\f$, and
+      \f$\|R^{-\frac 12} y\|^2 = y^T R^{-1} y\f$.
+      \param[in,out] y on entry, a vector in observation space; on exit,
+      \f$R^{-\frac 12} y\f$.
+    */
+    template <class T>
+    void LinearObservationManager<T>
+    ::ApplyErrorVarianceInverseSqrt(observation& y) const
+    {
+        Mlt(T(T(1) / sqrt(error_variance_value_)), y);
+    }
+
+
 
     //! Returns the name of the class.
     /*!
@@ -196,6 +196,9 @@ namespace Verdandi
         error_variance error_variance_;
         //! Inverse of the observation error covariance matrix (R).
         error_variance error_variance_inverse_;
+        /*! \brief Version of 'error_variance_' and 'error_variance_inverse_',
+          incremented whenever the set of observations changes. */
+        int error_variance_version_;
 
         /*** Triangle interpolation ***/
 
@@ -230,6 +233,7 @@ namespace Verdandi
         template <class Model>
         void InitializeOperator(Model& model,
                                 string configuration_file);
+        void InitializeErrorVariance();
 
         void DiscardObservation(bool discard_observation);
         int CreateTrack();
@@ -458,6 +462,9 @@ namespace Verdandi
 
         template <class state>
         void ApplyTangentLinearOperator(const state& x, observation& y) const;
+        template <class state_matrix>
+        void ApplyTangentLinearOperator(const state_matrix& X,
+                                        Matrix<T>& Y) const;
         T GetTangentLinearOperator(int i, int j) const;
         tangent_linear_operator_row& GetTangentLinearOperatorRow(int row);
         const tangent_linear_operator& GetTangentLinearOperator() const;
@@ -470,6 +477,9 @@ namespace Verdandi
         T GetErrorVariance(int i, int j) const;
         const error_variance& GetErrorVariance() const;
         const error_variance& GetErrorVarianceInverse() const;
+        int GetErrorVarianceVersion() const;
+        void ApplyErrorVarianceInverse(observation& y) const;
+        void ApplyErrorVarianceInverseSqrt(observation& y) const;
 
         string GetName() const;
         void Message(string message);
@@ -236,6 +236,24 @@ namespace Verdandi
     }
 
 
+    //! Applies the tangent linear operator to a block of vectors.
+    /*! This method is called after 'SetTime' set the time at which the
+      operator is defined.
+      \param[in] X the vectors, stored in the columns of the matrix.
+      \param[out] Y the values of the tangent linear operator at the columns
+      of \a X. It is resized if needed.
+    */
+    template <class state_matrix>
+    void ObservationManagerTemplate
+    ::ApplyTangentLinearOperator(const state_matrix& X,
+                                 Matrix<double>& Y) const
+    {
+        throw ErrorUndefined(
+            "void ObservationManagerTemplate::ApplyTangentLinearOperator"
+            "(const state_matrix& X, Matrix<double>& Y) const");
+    }
+
+
     //! Returns an element of the tangent linear operator.
     /*! This method is called after 'SetTime' set the time at which the
       operator is defined.
@@ -340,6 +358,47 @@ namespace Verdandi
     }
 
 
+    //! Returns the version of the observation error covariance matrix.
+    /*! The version should change whenever the observation error covariance
+      matrix changes, so that the methods may cache its factorization.
+      \return The version of the observation error covariance matrix.
+    */
+    int ObservationManagerTemplate::GetErrorVarianceVersion() const
+    {
+        throw ErrorUndefined("int ObservationManagerTemplate"
+                             "::GetErrorVarianceVersion() const");
+    }
+
+
+    //! Applies the inverse of the observation error covariance matrix.
+    /*!
+      \param[in,out] y on entry, a vector in observation space; on exit,
+      \f$R^{-1} y\f$.
+    */
+    void ObservationManagerTemplate
+    ::ApplyErrorVarianceInverse(observation& y) const
+    {
+        throw ErrorUndefined("void ObservationManagerTemplate"
+                             "::ApplyErrorVarianceInverse(observation& y) "
+                             "const");
+    }
+
+
+    //! Applies the inverse of a square root of the error covariance matrix.
+    /*!
+      \param[in,out] y on entry, a vector in observation space; on exit,
+      \f$R^{-\frac 12} y\f$, so that \f$\|R^{-\frac 12} y\|^2 = y^T R^{-1}
+      y\f$.
+    */
+    void ObservationManagerTemplate
+    ::ApplyErrorVarianceInverseSqrt(observation& y) const
+    {
+        throw ErrorUndefined("void ObservationManagerTemplate"
+                             "::ApplyErrorVarianceInverseSqrt(observation& "
+                             "y) const");
+    }
+
+
     //! Returns the name of the class.
     /*!
       \return The name of the class.
@@ -117,6 +117,9 @@ namespace Verdandi
 
         template <class state>
         void ApplyTangentLinearOperator(const state& x, observation& y) const;
+        template <class state_matrix>
+        void ApplyTangentLinearOperator(const state_matrix& X,
+                                        Matrix<double>& Y) const;
         double GetTangentLinearOperator(int i, int j) const;
         tangent_linear_operator_row& GetTangentLinearOperatorRow(int row);
         const tangent_linear_operator& GetTangentLinearOperator() const;
@@ -127,6 +130,9 @@ namespace Verdandi
         double GetErrorVariance(int i, int j) const;
         const error_variance& GetErrorVariance() const;
         const error_variance& GetErrorVarianceInverse() const;
+        int GetErrorVarianceVersion() const;
+        void ApplyErrorVarianceInverse(observation& y) const;
+        void ApplyErrorVarianceInverseSqrt(observation& y) const;
 
         string GetName() const;
         void Message(string message);
@@ -1759,6 +1759,44 @@ namespace Verdandi
     }
 
 
+    //! Returns the version of the observation error covariance matrix.
+    /*! The observation error covariance matrix is only built in Initialize,
+      so that its version never changes.
+      \return The version of the observation error covariance matrix.
+    */
+    template <class T>
+    int PetscLinearObservationManager<T>::GetErrorVarianceVersion() const
+    {
+        return 0;
+    }
+
+
+    //! Applies the inverse of the observation error covariance matrix.
+    /*!
+      \param[in,out] y on entry, a vector in observation space; on exit,
+      \f$R^{-1} y\f$.
+    */
+    template <class T>
+    void PetscLinearObservationManager<T>
+    ::ApplyErrorVarianceInverse(observation& y) const
+    {
+        Mlt(T(T(1) / error_variance_value_), y);
+    }
+
+
+    //! Applies the inverse of the square root of the error covariance.
+    /*! Since \f$R = \sigma^2 I\f$, its Cholesky factor is \f$\sigma I\f$.
+      \param[in,out] y on entry, a vector in observation space; on exit,
+      \f$R^{-\frac 12} y\f$.
+    */
+    template <class T>
+    void PetscLinearObservationManager<T>
+    ::ApplyErrorVarianceInverseSqrt(observation& y) const
+    {
+        Mlt(T(T(1) / sqrt(error_variance_value_)), y);
+    }
+
+
 
     //! Returns the name of the class.
     /*!
@@ -427,6 +427,9 @@ namespace Verdandi
         T GetErrorVariance(int i, int j) const;
         const error_variance& GetErrorVariance() const;
         const error_variance& GetErrorVarianceInverse() const;
+        int GetErrorVarianceVersion() const;
+        void ApplyErrorVarianceInverse(observation& y) const;
+        void ApplyErrorVarianceInverseSqrt(observation& y) const;
 
         string GetName() const;
         void Message(string message);
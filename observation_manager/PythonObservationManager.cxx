@@ -36,7 +36,8 @@ namespace Verdandi
 
 
     //! Constructor.
-    PythonObservationManager::PythonObservationManager()
+    PythonObservationManager::PythonObservationManager():
+        error_variance_version_(0), error_variance_factorization_version_(-1)
     {
         Py_Initialize();
         import_array();
@@ -160,6 +161,7 @@ namespace Verdandi
             throw ErrorPythonUndefined("PythonObservationManager::SetTime",
                                        string(function_name), "(self, time)",
                                        module_);
+        error_variance_version_++;
     }
 
 
@@ -381,6 +383,33 @@ namespace Verdandi
     }
 
 
+    //! Applies the tangent linear operator to a block of vectors.
+    /*! This method is called after 'SetTime' set the time at which the
+      operator is defined. The Python method 'ApplyTangentLinearOperator' is
+      called for each column of \a X.
+      \param[in] X the vectors, stored in the columns of the matrix.
+      \param[out] Y the values of the tangent linear operator at the columns
+      of \a X. It is resized if needed.
+    */
+    template <class state_matrix>
+    void PythonObservationManager
+    ::ApplyTangentLinearOperator(const state_matrix& X,
+                                 Matrix<double>& Y) const
+    {
+        Vector<double> x(X.GetM());
+        observation y;
+        for (int j = 0; j < X.GetN(); j++)
+        {
+            for (int i = 0; i < X.GetM(); i++)
+                x(i) = X(i, j);
+            ApplyTangentLinearOperator(x, y);
+            if (j == 0)
+                Y.Reallocate(y.GetLength(), X.GetN());
+            SetCol(y, j, Y);
+        }
+    }
+
+
     //! Returns an element of the tangent linear operator.
     /*! This method is called after 'SetTime' set the time at which the
       operator is defined.
@@ -560,7 +589,7 @@ namespace Verdandi
       \return The observation error covariance matrix.
     */
     const PythonObservationManager::error_variance&
-    PythonObservationManager::GetErrorVariance()
+    PythonObservationManager::GetErrorVariance() const
     {
         error_variance_.Nullify();
 
@@ -596,7 +625,7 @@ namespace Verdandi
       \return The inverse of the matrix of the observation error covariance.
     */
     const PythonObservationManager::error_variance&
-    PythonObservationManager::GetErrorVarianceInverse()
+    PythonObservationManager::GetErrorVarianceInverse() const
     {
         error_variance_inverse_.Nullify();
 
@@ -628,6 +657,53 @@ namespace Verdandi
     }
 
 
+    //! Returns the version of the observation error covariance matrix.
+    /*! The version changes whenever the observation error covariance matrix
+      may have been rebuilt, so that any quantity derived from it (e.g., a
+      factorization) may be cached as long as the version is unchanged. The
+      Python observation manager may rebuild the matrix at every call to
+      SetTime, so that the version changes at every call.
+      \return The version of the observation error covariance matrix.
+    */
+    int PythonObservationManager::GetErrorVarianceVersion() const
+    {
+        return error_variance_version_;
+    }
+
+
+    //! Applies the inverse of the observation error covariance matrix.
+    /*! The inverse is provided by the Python observation manager.
+      \param[in,out] y on entry, a vector in observation space; on exit,
+      \f$R^{-1} y\f$.
+    */
+    void PythonObservationManager
+    ::ApplyErrorVarianceInverse(observation& y) const
+    {
+        observation y_copy(y);
+        MltAdd(1., GetErrorVarianceInverse(), y_copy, 0., y);
+    }
+
+
+    //! Applies the inverse of the square root of the error covariance.
+    /*! With the Cholesky decomposition \f$R = U^T U\f$, \f$U^{-T} y\f$ is
+      computed, so that \f$\|R^{-\frac 12} y\|^2 = y^T R^{-1} y\f$. The
+      decomposition is kept as long as the version of \f$R\f$ is
+      unchanged.
+      \param[in,out] y on entry, a vector in observation space; on exit,
+      \f$R^{-\frac 12} y\f$.
+    */
+    void PythonObservationManager
+    ::ApplyErrorVarianceInverseSqrt(observation& y) const
+    {
+        if (error_variance_factorization_version_ != error_variance_version_)
+        {
+            error_variance_factorization_.Factorize(GetErrorVariance());
+            error_variance_factorization_version_ = error_variance_version_;
+        }
+        error_variance_factorization_.SolveSquareRoot(y);
+    }
+
+
     //! Returns the name of the class.
     /*!
       \return The name of the class.
@@ -80,9 +80,17 @@ namespace Verdandi
         tangent_linear_operator tangent_operator_matrix_;
 
         //! Observation error covariance matrix (R).
-        error_variance error_variance_;
+        mutable error_variance error_variance_;
         //! Inverse of the observation error covariance matrix (R).
-        error_variance error_variance_inverse_;
+        mutable error_variance error_variance_inverse_;
+        /*! \brief Version of the observation error covariance matrix. It
+          changes whenever the time is set, since the Python observation
+          manager may then rebuild the matrix. */
+        int error_variance_version_;
+        //! Cholesky factorization of R.
+        mutable SymmetricFactorization<double> error_variance_factorization_;
+        //! Version of R when it was factorized (-1 if never).
+        mutable int error_variance_factorization_version_;
 
         //! Index of the row of H  currently stored.
         int current_row_;
@@ -139,6 +147,9 @@ namespace Verdandi
 
         template <class state>
         void ApplyTangentLinearOperator(const state& x, observation& y) const;
+        template <class state_matrix>
+        void ApplyTangentLinearOperator(const state_matrix& X,
+                                        Matrix<double>& Y) const;
         double GetTangentLinearOperator(int i, int j) const;
         tangent_linear_operator_row& GetTangentLinearOperatorRow(int row);
         const tangent_linear_operator& GetTangentLinearOperator();
@@ -147,8 +158,11 @@ namespace Verdandi
         void ApplyAdjointOperator(const state& x, observation& y) const;
 
         double GetErrorVariance(int i, int j) const;
-        const error_variance& GetErrorVariance();
-        const error_variance& GetErrorVarianceInverse();
+        const error_variance& GetErrorVariance() const;
+        const error_variance& GetErrorVarianceInverse() const;
+        int GetErrorVarianceVersion() const;
+        void ApplyErrorVarianceInverse(observation& y) const;
+        void ApplyErrorVarianceInverseSqrt(observation& y) const;
 
         string GetName() const;
         void Message(string message);
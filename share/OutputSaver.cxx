@@ -31,6 +31,116 @@ namespace Verdandi
 {
 
 
+#ifdef VERDANDI_HAS_CXX11
+    /////////////////
+    // OUTPUTQUEUE //
+    /////////////////
+
+
+    //! Main constructor.
+    /*! Starts the background thread.
+      \param[in] capacity maximum number of pending writes.
+    */
+    OutputQueue::OutputQueue(size_t capacity):
+        capacity_(capacity), stop_(false)
+    {
+        thread_ = thread(&OutputQueue::Run, this);
+    }
+
+
+    //! Destructor.
+    /*! Completes the pending writes and stops the background thread. */
+    OutputQueue::~OutputQueue()
+    {
+        {
+            lock_guard<mutex> lock(mutex_);
+            stop_ = true;
+        }
+        changed_.notify_all();
+        thread_.join();
+    }
+
+
+    //! Appends a write to the queue.
+    /*! If the queue is full, this method waits until a pending write is
+      completed.
+      \param[in] task the write to be carried out by the background thread.
+    */
+    void OutputQueue::Push(function<void()> task)
+    {
+        unique_lock<mutex> lock(mutex_);
+        changed_.wait(lock, [this]
+                      {
+                          return task_.size() < capacity_ || error_;
+                      });
+        CheckError();
+        task_.push_back(task);
+        lock.unlock();
+        changed_.notify_all();
+    }
+
+
+    //! Waits until all pending writes are completed.
+    void OutputQueue::Flush()
+    {
+        unique_lock<mutex> lock(mutex_);
+        changed_.wait(lock, [this]
+                      {
+                          return task_.empty();
+                      });
+        CheckError();
+    }
+
+
+    //! Executes the writes until the queue is stopped and empty.
+    void OutputQueue::Run()
+    {
+        unique_lock<mutex> lock(mutex_);
+        while (true)
+        {
+            changed_.wait(lock, [this]
+                          {
+                              return stop_ || !task_.empty();
+                          });
+            if (task_.empty())
+                return;
+
+            // The task stays in the queue while it is executed, so that
+            // 'Flush' waits for its completion.
+            function<void()> task = task_.front();
+            lock.unlock();
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                lock.lock();
+                if (!error_)
+                    error_ = current_exception();
+                lock.unlock();
+            }
+            lock.lock();
+            task_.pop_front();
+            changed_.notify_all();
+        }
+    }
+
+
+    //! Rethrows the first exception raised by a write, if any.
+    /*! The mutex should be locked by the caller. */
+    void OutputQueue::CheckError()
+    {
+        if (error_)
+        {
+            exception_ptr error = error_;
+            error_ = exception_ptr();
+            rethrow_exception(error);
+        }
+    }
+#endif
+
+
     /////////////////////////////////
     // CONSTRUCTORS AND DESTRUCTOR //
     /////////////////////////////////
@@ -38,7 +148,8 @@ namespace Verdandi
 
     //! Default constructor.
     OutputSaver::OutputSaver():
-        save_period_(0), time_tolerance_(0), is_active_(true)
+        save_period_(0), time_tolerance_(0), is_active_(true),
+        asynchronous_(false), queue_size_(2)
     {
     }
 
@@ -50,12 +161,65 @@ namespace Verdandi
       configuration is to be read.
     */
     OutputSaver::OutputSaver(string configuration_file, string section_name):
-        save_period_(0), time_tolerance_(0), is_active_(true)
+        save_period_(0), time_tolerance_(0), is_active_(true),
+        asynchronous_(false), queue_size_(2)
     {
         Initialize(configuration_file, section_name);
     }
 
 
+    //! Copy constructor.
+    /*! In asynchronous mode, the copy has its own queue and background
+      thread.
+      \param[in] output_saver the output saver to be copied.
+    */
+    OutputSaver::OutputSaver(const OutputSaver& output_saver):
+        save_period_(0), time_tolerance_(0), is_active_(true),
+        asynchronous_(false), queue_size_(2)
+    {
+        *this = output_saver;
+    }
+
+
+    //! Assignment operator.
+    /*! The pending writes of both output savers are completed first, since
+      they may share files. In asynchronous mode, the output saver keeps its
+      own queue and background thread.
+      \param[in] output_saver the output saver to be copied.
+      \return This output saver.
+    */
+    OutputSaver& OutputSaver::operator=(const OutputSaver& output_saver)
+    {
+        if (this == &output_saver)
+            return *this;
+
+        Flush();
+#ifdef VERDANDI_HAS_CXX11
+        if (output_saver.queue_)
+            output_saver.queue_->Flush();
+#endif
+
+        save_period_ = output_saver.save_period_;
+        time_tolerance_ = output_saver.time_tolerance_;
+        mode_ = output_saver.mode_;
+        group_ = output_saver.group_;
+        dataset_ = output_saver.dataset_;
+        mode_scalar_ = output_saver.mode_scalar_;
+        variable_list_ = output_saver.variable_list_;
+        is_active_ = output_saver.is_active_;
+        asynchronous_ = output_saver.asynchronous_;
+        queue_size_ = output_saver.queue_size_;
+#ifdef VERDANDI_HAS_CXX11
+        if (asynchronous_)
+            queue_.reset(new OutputQueue(size_t(queue_size_)));
+        else
+            queue_.reset();
+#endif
+
+        return *this;
+    }
+
+
     //! Initializes the output saver with a configuration file.
     /*! Reads the configuration.
       \param[in] configuration_file the configuration file.
@@ -91,6 +255,24 @@ namespace Verdandi
         configuration.Set("dataset", "", "data", dataset_);
         configuration.Set("mode_scalar", "", "text", mode_scalar_);
 
+        // Pending writes of a former configuration are completed first.
+        Flush();
+        configuration.Set("asynchronous", "", false, asynchronous_);
+#ifdef VERDANDI_HAS_CXX11
+        if (asynchronous_)
+        {
+            configuration.Set("queue_size", "v >= 1", 2, queue_size_);
+            queue_.reset(new OutputQueue(size_t(queue_size_)));
+        }
+        else
+            queue_.reset();
+#else
+        if (asynchronous_)
+            throw ErrorConfiguration("OutputSaver::Initialize",
+                                     "The asynchronous mode requires "
+                                     "C++11 support.");
+#endif
+
         vector<string> variable_vector;
         configuration.Set("variable_list", variable_vector);
 
@@ -155,8 +337,22 @@ namespace Verdandi
 
 
     //! Destructor.
+    /*! In asynchronous mode, the pending writes are completed. An error
+      raised by a pending write cannot be rethrown by the destructor; a
+      Verdandi error has already been logged when it was raised.
+    */
     OutputSaver::~OutputSaver()
     {
+#ifdef VERDANDI_HAS_CXX11
+        if (queue_)
+            try
+            {
+                queue_->Flush();
+            }
+            catch (...)
+            {
+            }
+#endif
     }
 
 
@@ -187,12 +383,37 @@ namespace Verdandi
     }
 
 
+    //! Are the writes carried out by a background thread?
+    /*!
+      \return True if the output saver is in asynchronous mode, false
+      otherwise.
+    */
+    bool OutputSaver::IsAsynchronous() const
+    {
+        return asynchronous_;
+    }
+
+
+    //! Waits until all pending writes are completed.
+    /*! In asynchronous mode, the output files are complete only after this
+      method returns. An exception raised by a pending write is rethrown. In
+      synchronous mode, this method does nothing.
+    */
+    void OutputSaver::Flush()
+    {
+#ifdef VERDANDI_HAS_CXX11
+        if (queue_)
+            queue_->Flush();
+#endif
+    }
+
+
     //! Writes \a x of type double in a text file.
     /*!
       \param[in] x double to be written.
       \param[in] file_name output filename.
     */
-    void OutputSaver::WriteText(const double& x, string file_name) const
+    void OutputSaver::WriteText(const double& x, string file_name)
     {
         ofstream file(file_name.c_str(), ofstream::app);
 #ifdef VERDANDI_CHECK_IO
@@ -215,7 +436,7 @@ namespace Verdandi
       \param[in] time corresponding time of the variable.
     */
     void OutputSaver::WriteHDF5(const double& x, string file_name,
-                                string group_name, string dataset_name) const
+                                string group_name, string dataset_name)
     {
         Vector<double> temp;
         temp.Resize(1);
@@ -244,6 +465,8 @@ namespace Verdandi
             return;
         }
 
+        // Pending writes must not be appended after the file is emptied.
+        Flush();
         ofstream output_stream(im->second.GetFile().c_str());
         output_stream.close();
         im->second.HasToEmptyFile(false);
@@ -253,6 +476,7 @@ namespace Verdandi
     //! Empties the output files of all registered variables.
     void OutputSaver::Empty()
     {
+        Flush();
         map<string, Variable>::iterator im;
         for (im = variable_list_.begin(); im != variable_list_.end(); im++)
         {
@@ -301,7 +525,7 @@ namespace Verdandi
       \param[in] file_name output filename.
     */
     template <>
-    void OutputSaver::WriteBinary(const float& x, string file_name) const
+    void OutputSaver::WriteBinary(const float& x, string file_name)
     {
         ofstream file(file_name.c_str(), ofstream::app);
 #ifdef VERDANDI_CHECK_IO
@@ -320,7 +544,7 @@ namespace Verdandi
       \param[in] file_name output filename.
     */
     template <>
-    void OutputSaver::WriteBinary(const int& x, string file_name) const
+    void OutputSaver::WriteBinary(const int& x, string file_name)
     {
         ofstream file(file_name.c_str(), ofstream::app);
 #ifdef VERDANDI_CHECK_IO
@@ -338,7 +562,7 @@ namespace Verdandi
       \param[in] x variable to be written.
       \param[in] file_name output filename.
     */
-    void OutputSaver::WriteBinary(const double& x, string file_name) const
+    void OutputSaver::WriteBinary(const double& x, string file_name)
     {
         ofstream file(file_name.c_str(), ofstream::app);
 #ifdef VERDANDI_CHECK_IO
@@ -29,11 +29,69 @@
 #include <fstream>
 #include <string>
 
+#ifdef VERDANDI_HAS_CXX11
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <exception>
+#endif
+
 
 namespace Verdandi
 {
 
 
+#ifdef VERDANDI_HAS_CXX11
+    /////////////////
+    // OUTPUTQUEUE //
+    /////////////////
+
+
+    //! Bounded queue of writes carried out by a background thread.
+    /*! The writes are executed in the order they were pushed. If the queue
+      is full, 'Push' waits until a write is completed. An exception raised
+      by a write is rethrown by the next call to 'Push' or 'Flush'.
+    */
+    class OutputQueue
+    {
+
+    private:
+
+        //! Maximum number of pending writes.
+        size_t capacity_;
+        //! Pending writes. The first one is being executed.
+        deque<function<void()> > task_;
+        //! Mutex protecting the queue.
+        mutex mutex_;
+        //! Notified whenever a write is pushed or completed.
+        condition_variable changed_;
+        //! Should the background thread stop once the queue is empty?
+        bool stop_;
+        //! First exception raised by a write.
+        exception_ptr error_;
+        //! Background thread.
+        thread thread_;
+
+    public:
+
+        OutputQueue(size_t capacity);
+        ~OutputQueue();
+
+        void Push(function<void()> task);
+        void Flush();
+
+    private:
+
+        void Run();
+        void CheckError();
+
+    };
+#endif
+
+
     /////////////////
     // OUTPUTSAVER //
     /////////////////
@@ -69,12 +127,23 @@ namespace Verdandi
         //! Boolean to indicate if the output saver is active or not.
         bool is_active_;
 
+        //! Are the writes carried out by a background thread?
+        bool asynchronous_;
+        //! Maximum number of pending writes in asynchronous mode.
+        int queue_size_;
+#ifdef VERDANDI_HAS_CXX11
+        //! Queue of the asynchronous writes, owned by this output saver.
+        unique_ptr<OutputQueue> queue_;
+#endif
+
     public:
 
         /*** Constructors and destructor ***/
 
         OutputSaver();
         OutputSaver(string configuration_file, string method_name);
+        OutputSaver(const OutputSaver& output_saver);
+        OutputSaver& operator=(const OutputSaver& output_saver);
         void Initialize(string configuration_file, string method_name);
         void Initialize(VerdandiOps& configuration);
         void Activate();
@@ -87,6 +156,8 @@ namespace Verdandi
         /*** Methods ***/
 
         bool IsSaved(string variable_name) const;
+        bool IsAsynchronous() const;
+        void Flush();
 
         template <class S>
         void Save(const S& x, double time, string variable_name);
@@ -99,27 +170,29 @@ namespace Verdandi
                   string variable_name);
 #endif
 
-        void WriteText(const double& x, string file_name) const;
+        static void WriteText(const double& x, string file_name);
         template <class S>
-        void WriteText(const S& x, string file_name) const;
+        static void WriteText(const S& x, string file_name);
 #ifdef VERDANDI_WITH_HDF5
         template <class S>
-        void WriteHDF5(const S& x, string file_name,
-                       string group_name, string dataset_name) const;
-        void WriteHDF5(const double& x, string file_name,
-                       string group_name, string dataset_name) const;
+        static void WriteHDF5(const S& x, string file_name,
+                              string group_name, string dataset_name);
+        static void WriteHDF5(const double& x, string file_name,
+                              string group_name, string dataset_name);
 #endif
         template <class S>
-        void WriteBinary(const S& x, string file_name) const;
+        static void WriteBinary(const S& x, string file_name);
 
-        void WriteBinary(const double& x, string file_name) const;
+        static void WriteBinary(const double& x, string file_name);
         template <class T, class Prop, class Allocator>
-        void WriteBinary(const Matrix<T, Prop, RowSparse, Allocator>& x,
-                         string file_name) const;
+        static void
+        WriteBinary(const Matrix<T, Prop, RowSparse, Allocator>& x,
+                    string file_name);
 
         template <class T, class Prop, class Allocator>
-        void WriteBinary(const Matrix<T, Prop, ColSparse, Allocator>& x,
-                         string file_name) const;
+        static void
+        WriteBinary(const Matrix<T, Prop, ColSparse, Allocator>& x,
+                    string file_name);
 
 
         template <class S>
@@ -140,6 +213,10 @@ namespace Verdandi
         void SetVariable(Variable& variable);
         void SetVariableFile(Variable& variable);
 
+        template <class S>
+        static void Write(const S& x, string mode, string file_name,
+                          string group_name, string dataset_name);
+
     };
 
 
@@ -59,8 +59,23 @@ namespace Verdandi
                     variable_name + "_time";
                 Vector<double> vector_time(1);
                 vector_time(0) = time;
-                WriteHDF5(vector_time, variable.GetFile(), group_,
-                          dataset_time_name);
+#ifdef VERDANDI_HAS_CXX11
+                if (asynchronous_)
+                {
+                    string file_name = variable.GetFile();
+                    string group_name = group_;
+                    queue_->Push([vector_time, file_name, group_name,
+                                  dataset_time_name]()
+                                 {
+                                     WriteHDF5(vector_time, file_name,
+                                               group_name,
+                                               dataset_time_name);
+                                 });
+                }
+                else
+#endif
+                    WriteHDF5(vector_time, variable.GetFile(), group_,
+                              dataset_time_name);
             }
 #endif
         }
@@ -98,16 +113,29 @@ namespace Verdandi
         SetVariable<S>(variable);
         if (variable.HasToEmptyFile())
             Empty(variable_name);
-        if (variable.GetMode() == "text")
-            WriteText(x, variable.GetFile());
-        else if (variable.GetMode() == "binary")
-            WriteBinary(x, variable.GetFile());
-#ifdef VERDANDI_WITH_HDF5
-        else if (variable.GetMode() == "HDF")
+
+#ifdef VERDANDI_HAS_CXX11
+        if (asynchronous_)
         {
-            WriteHDF5(x, variable.GetFile(), group_, variable_name);
+            // The background thread writes a snapshot of 'x', so that 'x'
+            // may be modified as soon as this method returns. The task only
+            // holds values, and it does not depend on this output saver.
+            shared_ptr<const S> snapshot = make_shared<const S>(x);
+            string mode = variable.GetMode();
+            string file_name = variable.GetFile();
+            string group_name = group_;
+            queue_->Push([snapshot, mode, file_name, group_name,
+                          variable_name]()
+                         {
+                             Write(*snapshot, mode, file_name, group_name,
+                                   variable_name);
+                         });
+            return;
         }
 #endif
+
+        Write(x, variable.GetMode(), variable.GetFile(), group_,
+              variable_name);
     }
 
 
@@ -152,13 +180,38 @@ namespace Verdandi
 
 
 
+    //! Writes \a x in a file with a given format.
+    /*!
+      \param[in] x variable to be written.
+      \param[in] mode the format: "text", "binary" or "HDF".
+      \param[in] file_name output filename.
+      \param[in] group_name name of the group \a x must be stored in (HDF
+      format).
+      \param[in] dataset_name name of the dataset \a x must be stored in (HDF
+      format).
+    */
+    template <class S>
+    void OutputSaver::Write(const S& x, string mode, string file_name,
+                            string group_name, string dataset_name)
+    {
+        if (mode == "text")
+            WriteText(x, file_name);
+        else if (mode == "binary")
+            WriteBinary(x, file_name);
+#ifdef VERDANDI_WITH_HDF5
+        else if (mode == "HDF")
+            WriteHDF5(x, file_name, group_name, dataset_name);
+#endif
+    }
+
+
     //! Writes \a x in a text file.
     /*!
       \param[in] x variable to be written.
       \param[in] file_name output filename.
     */
     template <class S>
-    void OutputSaver::WriteText(const S& x, string file_name) const
+    void OutputSaver::WriteText(const S& x, string file_name)
     {
         ofstream file(file_name.c_str(), ofstream::app);
 #ifdef VERDANDI_CHECK_IO
@@ -182,7 +235,7 @@ namespace Verdandi
     */
     template <class S>
     void OutputSaver::WriteHDF5(const S& x, string file_name,
-                                string group_name, string dataset_name) const
+                                string group_name, string dataset_name)
     {
         DISP(file_name);
         x.WriteHDF5(file_name, group_name, dataset_name);
@@ -195,7 +248,7 @@ namespace Verdandi
       \param[in] file_name output filename.
     */
     template <class S>
-    void OutputSaver::WriteBinary(const S& x, string file_name) const
+    void OutputSaver::WriteBinary(const S& x, string file_name)
     {
         ofstream file(file_name.c_str(), ofstream::app | ofstream::binary);
 #ifdef VERDANDI_CHECK_IO
@@ -217,7 +270,7 @@ namespace Verdandi
     template <class T, class Prop, class Allocator>
     void OutputSaver
     ::WriteBinary(const Matrix<T, Prop, RowSparse, Allocator>& x,
-                  string file_name) const
+                  string file_name)
     {
         throw ErrorUndefined("WriteBinary(const Matrix<T, Prop, RowSparse, "
                              "Allocator>& x, string file_name)");
@@ -233,7 +286,7 @@ namespace Verdandi
     template <class T, class Prop, class Allocator>
     void OutputSaver
     ::WriteBinary(const Matrix<T, Prop, ColSparse, Allocator>& x,
-                  string file_name) const
+                  string file_name)
     {
         throw ErrorUndefined("WriteBinary(const Matrix<T, Prop, ColSparse, "
                              "Allocator>& x, string file_name)");
@@ -260,6 +313,8 @@ namespace Verdandi
         if (im->second.GetMode().empty())
             SetVariable<S>(im->second);
 
+        // Pending writes must not be appended after the file is emptied.
+        Flush();
         ofstream output_stream(im->second.GetFile().c_str());
         output_stream.close();
         im->second.HasToEmptyFile(false);
@@ -0,0 +1,110 @@
+// Copyright (C) 2026
+// Author(s): agent
+//
+// This file is part of the data assimilation library Verdandi.
+//
+// Verdandi is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Verdandi is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Verdandi. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Verdandi web site:
+//      http://verdandi.gforge.inria.fr/
+
+
+#ifndef VERDANDI_FILE_SHARE_SYMMETRICFACTORIZATION_HXX
+
+
+namespace Verdandi
+{
+
+
+    ////////////////////////////
+    // SYMMETRICFACTORIZATION //
+    ////////////////////////////
+
+
+    //! Factorization of a symmetric matrix, kept for repeated solves.
+    /*! The matrix \f$A\f$ is factorized once, in symmetric packed storage,
+      either with a Cholesky decomposition \f$A = U^T U\f$ (for a symmetric
+      positive definite matrix) or with a Bunch-Kaufman decomposition \f$A =
+      U D U^T\f$ ("LDLt", for a symmetric indefinite matrix). The factor is
+      then used to apply \f$A^{-1}\f$ to vectors and matrices, so that the
+      inverse of \f$A\f$ never needs to be formed.
+    */
+    template <class T>
+    class SymmetricFactorization
+    {
+    protected:
+
+        //! Factorization: "Cholesky" or "LDLt".
+        string method_;
+        //! Factor of the matrix, in symmetric packed storage.
+        Matrix<T, Symmetric, RowSymPacked> factor_;
+        //! Pivots of the "LDLt" factorization.
+        Vector<int> pivot_;
+        //! Is a factorization available?
+        bool is_factorized_;
+
+    public:
+
+        /*** Constructors ***/
+
+        SymmetricFactorization();
+        SymmetricFactorization(string method);
+
+        /*** Methods ***/
+
+        void SetMethod(string method);
+        string GetMethod() const;
+
+        template <class MatrixType>
+        void Factorize(const MatrixType& A);
+        template <class T0, class Prop0, class Allocator0>
+        void Factorize(const Matrix<T0, Prop0, RowSymPacked, Allocator0>& A);
+        void Clear();
+
+        bool IsFactorized() const;
+        int GetM() const;
+        const Matrix<T, Symmetric, RowSymPacked>& GetFactor() const;
+
+        template <class T0, class Allocator0>
+        void Solve(Vector<T0, VectFull, Allocator0>& x) const;
+        template <class T0, class Allocator0>
+        void SolveSquareRoot(Vector<T0, VectFull, Allocator0>& x) const;
+        template <class T0, class Allocator0>
+        void MltSquareRoot(Vector<T0, VectFull, Allocator0>& x) const;
+
+        template <class MatrixType>
+        void SolveRow(MatrixType& X) const;
+        template <class MatrixType>
+        void SolveSquareRootRow(MatrixType& X) const;
+        template <class MatrixType>
+        void SolveColumn(MatrixType& X) const;
+
+        template <class MatrixType>
+        void GetInverse(MatrixType& A_inv) const;
+
+    protected:
+
+        void ComputeFactor();
+        void CheckFactorized(string function, int size) const;
+    };
+
+
+} // namespace Verdandi.
+
+
+#include "share/SymmetricFactorization.txx"
+
+
+#define VERDANDI_FILE_SHARE_SYMMETRICFACTORIZATION_HXX
+#endif
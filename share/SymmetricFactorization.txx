@@ -0,0 +1,368 @@
+// Copyright (C) 2026
+// Author(s): agent
+//
+// This file is part of the data assimilation library Verdandi.
+//
+// Verdandi is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Verdandi is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Verdandi. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Verdandi web site:
+//      http://verdandi.gforge.inria.fr/
+
+
+#ifndef VERDANDI_FILE_SHARE_SYMMETRICFACTORIZATION_TXX
+#define VERDANDI_FILE_SHARE_SYMMETRICFACTORIZATION_TXX
+
+
+namespace Verdandi
+{
+
+
+    ////////////////////////////
+    // SYMMETRICFACTORIZATION //
+    ////////////////////////////
+
+
+    /////////////////
+    // CONSTRUCTOR //
+    /////////////////
+
+
+    //! Default constructor.
+    /*! The factorization is a Cholesky decomposition. */
+    template <class T>
+    SymmetricFactorization<T>::SymmetricFactorization():
+        method_("Cholesky"), is_factorized_(false)
+    {
+    }
+
+
+    //! Main constructor.
+    /*!
+      \param[in] method the factorization: "Cholesky" or "LDLt".
+    */
+    template <class T>
+    SymmetricFactorization<T>::SymmetricFactorization(string method):
+        is_factorized_(false)
+    {
+        SetMethod(method);
+    }
+
+
+    /////////////
+    // METHODS //
+    /////////////
+
+
+    //! Sets the factorization method.
+    /*! Any previous factorization is cleared.
+      \param[in] method the factorization: "Cholesky" (symmetric positive
+      definite matrices) or "LDLt" (symmetric indefinite matrices).
+    */
+    template <class T>
+    void SymmetricFactorization<T>::SetMethod(string method)
+    {
+        if (method != "Cholesky" && method != "LDLt")
+            throw ErrorArgument("SymmetricFactorization::SetMethod",
+                                "The factorization should be \"Cholesky\" or"
+                                " \"LDLt\", not \"" + method + "\".");
+        method_ = method;
+        Clear();
+    }
+
+
+    //! Returns the factorization method.
+    /*!
+      \return The factorization: "Cholesky" or "LDLt".
+    */
+    template <class T>
+    string SymmetricFactorization<T>::GetMethod() const
+    {
+        return method_;
+    }
+
+
+    //! Factorizes a symmetric matrix.
+    /*! Only the upper part of \a A is read.
+      \param[in] A a symmetric matrix, in any storage.
+    */
+    template <class T>
+    template <class MatrixType>
+    void SymmetricFactorization<T>::Factorize(const MatrixType& A)
+    {
+        int n = A.GetM();
+        if (A.GetN() != n)
+            throw ErrorArgument("SymmetricFactorization::Factorize",
+                                "The matrix has dimensions "
+                                + to_str(n) + " x " + to_str(A.GetN())
+                                + ", but it should be square.");
+
+        factor_.Reallocate(n, n);
+        for (int i = 0; i < n; i++)
+            for (int j = i; j < n; j++)
+                factor_(i, j) = A(i, j);
+
+        ComputeFactor();
+    }
+
+
+    //! Factorizes a symmetric matrix stored in packed form.
+    /*!
+      \param[in] A a symmetric matrix.
+    */
+    template <class T>
+    template <class T0, class Prop0, class Allocator0>
+    void SymmetricFactorization<T>
+    ::Factorize(const Matrix<T0, Prop0, RowSymPacked, Allocator0>& A)
+    {
+        int n = A.GetM();
+        factor_.Reallocate(n, n);
+        T* factor = factor_.GetData();
+        const T0* data = A.GetData();
+        for (int k = 0; k < factor_.GetDataSize(); k++)
+            factor[k] = data[k];
+
+        ComputeFactor();
+    }
+
+
+    //! Clears the factorization.
+    template <class T>
+    void SymmetricFactorization<T>::Clear()
+    {
+        factor_.Clear();
+        pivot_.Clear();
+        is_factorized_ = false;
+    }
+
+
+    //! Is a factorization available?
+    /*!
+      \return True if a matrix has been factorized, false otherwise.
+    */
+    template <class T>
+    bool SymmetricFactorization<T>::IsFactorized() const
+    {
+        return is_factorized_;
+    }
+
+
+    //! Returns the dimension of the factorized matrix.
+    /*!
+      \return The number of rows of the factorized matrix.
+    */
+    template <class T>
+    int SymmetricFactorization<T>::GetM() const
+    {
+        return factor_.GetM();
+    }
+
+
+    //! Returns the factor.
+    /*!
+      \return The factor \f$U\f$ ("Cholesky", \f$A = U^T U\f$) or the
+      Bunch-Kaufman factors ("LDLt"), in symmetric packed storage.
+    */
+    template <class T>
+    const Matrix<T, Symmetric, RowSymPacked>&
+    SymmetricFactorization<T>::GetFactor() const
+    {
+        return factor_;
+    }
+
+
+    //! Applies the inverse of the factorized matrix to a vector.
+    /*!
+      \param[in,out] x on entry, the vector \f$x\f$; on exit, \f$A^{-1}
+      x\f$.
+    */
+    template <class T>
+    template <class T0, class Allocator0>
+    void SymmetricFactorization<T>
+    ::Solve(Vector<T0, VectFull, Allocator0>& x) const
+    {
+        CheckFactorized("SymmetricFactorization::Solve", x.GetM());
+
+        if (method_ == "Cholesky")
+        {
+            SolveCholesky(SeldonTrans, factor_, x);
+            SolveCholesky(SeldonNoTrans, factor_, x);
+        }
+        else
+            SolveLU(factor_, pivot_, x);
+    }
+
+
+    //! Applies the inverse of the transposed Cholesky factor to a vector.
+    /*! With \f$A = U^T U\f$, \f$U^{-T} x\f$ is computed, so that its squared
+      norm is \f$x^T A^{-1} x\f$.
+      \param[in,out] x on entry, the vector \f$x\f$; on exit, \f$U^{-T}
+      x\f$.
+    */
+    template <class T>
+    template <class T0, class Allocator0>
+    void SymmetricFactorization<T>
+    ::SolveSquareRoot(Vector<T0, VectFull, Allocator0>& x) const
+    {
+        CheckFactorized("SymmetricFactorization::SolveSquareRoot", x.GetM());
+
+        if (method_ != "Cholesky")
+            throw ErrorProcessing("SymmetricFactorization::SolveSquareRoot",
+                                  "The square root is only available with a"
+                                  " Cholesky factorization.");
+
+        SolveCholesky(SeldonTrans, factor_, x);
+    }
+
+
+    //! Applies the transposed Cholesky factor to a vector.
+    /*! With \f$A = U^T U\f$, \f$U^T x\f$ is computed, so that \f$U^T\f$ is
+      a square root of \f$A\f$.
+      \param[in,out] x on entry, the vector \f$x\f$; on exit, \f$U^T x\f$.
+    */
+    template <class T>
+    template <class T0, class Allocator0>
+    void SymmetricFactorization<T>
+    ::MltSquareRoot(Vector<T0, VectFull, Allocator0>& x) const
+    {
+        CheckFactorized("SymmetricFactorization::MltSquareRoot", x.GetM());
+
+        if (method_ != "Cholesky")
+            throw ErrorProcessing("SymmetricFactorization::MltSquareRoot",
+                                  "The square root is only available with a"
+                                  " Cholesky factorization.");
+
+        MltCholesky(SeldonTrans, factor_, x);
+    }
+
+
+    //! Applies the inverse of the factorized matrix to matrix rows.
+    /*!
+      \param[in,out] X on entry, the matrix \f$X\f$; on exit, \f$X
+      A^{-1}\f$.
+    */
+    template <class T>
+    template <class MatrixType>
+    void SymmetricFactorization<T>::SolveRow(MatrixType& X) const
+    {
+        CheckFactorized("SymmetricFactorization::SolveRow", X.GetN());
+
+        Vector<T> row;
+        for (int i = 0; i < X.GetM(); i++)
+        {
+            GetRow(X, i, row);
+            Solve(row);
+            SetRow(row, i, X);
+        }
+    }
+
+
+    //! Applies the inverse of the Cholesky factor to matrix rows.
+    /*! With \f$A = U^T U\f$, \f$X U^{-1}\f$ is computed, so that \f$(X
+      U^{-1}) (X U^{-1})^T = X A^{-1} X^T\f$.
+      \param[in,out] X on entry, the matrix \f$X\f$; on exit, \f$X
+      U^{-1}\f$.
+    */
+    template <class T>
+    template <class MatrixType>
+    void SymmetricFactorization<T>::SolveSquareRootRow(MatrixType& X) const
+    {
+        CheckFactorized("SymmetricFactorization::SolveSquareRootRow",
+                        X.GetN());
+
+        Vector<T> row;
+        for (int i = 0; i < X.GetM(); i++)
+        {
+            GetRow(X, i, row);
+            SolveSquareRoot(row);
+            SetRow(row, i, X);
+        }
+    }
+
+
+    //! Applies the inverse of the factorized matrix to matrix columns.
+    /*!
+      \param[in,out] X on entry, the matrix \f$X\f$; on exit, \f$A^{-1}
+      X\f$.
+    */
+    template <class T>
+    template <class MatrixType>
+    void SymmetricFactorization<T>::SolveColumn(MatrixType& X) const
+    {
+        CheckFactorized("SymmetricFactorization::SolveColumn", X.GetM());
+
+        Vector<T> column;
+        for (int j = 0; j < X.GetN(); j++)
+        {
+            GetCol(X, j, column);
+            Solve(column);
+            SetCol(column, j, X);
+        }
+    }
+
+
+    //! Computes the inverse of the factorized matrix.
+    /*! The inverse is computed from the factor. This should only be used
+      when the inverse itself is needed, and not to solve linear systems.
+      \param[out] A_inv the inverse of the factorized matrix.
+    */
+    template <class T>
+    template <class MatrixType>
+    void SymmetricFactorization<T>::GetInverse(MatrixType& A_inv) const
+    {
+        CheckFactorized("SymmetricFactorization::GetInverse", GetM());
+
+        A_inv.Reallocate(GetM(), GetM());
+        A_inv.SetIdentity();
+        SolveRow(A_inv);
+    }
+
+
+    //! Factorizes the matrix stored in 'factor_'.
+    template <class T>
+    void SymmetricFactorization<T>::ComputeFactor()
+    {
+        if (method_ == "Cholesky")
+        {
+            pivot_.Clear();
+            GetCholesky(factor_);
+        }
+        else
+            GetLU(factor_, pivot_);
+        is_factorized_ = true;
+    }
+
+
+    //! Checks that a factorization of the proper size is available.
+    /*!
+      \param[in] function the name of the calling function.
+      \param[in] size the expected dimension of the factorized matrix.
+    */
+    template <class T>
+    void SymmetricFactorization<T>::CheckFactorized(string function,
+                                                    int size) const
+    {
+        if (!is_factorized_)
+            throw ErrorProcessing(function, "No matrix has been factorized.");
+        if (size != GetM())
+            throw ErrorArgument(function, "The factorized matrix has "
+                                "dimensions " + to_str(GetM()) + " x "
+                                + to_str(GetM()) + ", but the operand has "
+                                "dimension " + to_str(size) + ".");
+    }
+
+
+} // namespace Verdandi.
+
+
+#endif
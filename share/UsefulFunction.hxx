@@ -46,6 +46,16 @@ namespace Verdandi
                         const Vector<T>& step, const Vector<int>& shape,
                         Vector<T>& coordinate);
 
+    /*** Covariance localization ***/
+
+    template <class T>
+    T gaspari_cohn(T distance, T radius);
+    template <class T, class Prop, class Storage, class Allocator>
+    void schur_localize(const Matrix<double>& coordinate_row,
+                        const Matrix<double>& coordinate_column,
+                        double radius,
+                        Matrix<T, Prop, Storage, Allocator>& M);
+
     /*** From Talos library ***/
 
     bool is_num(const string& s);
@@ -79,6 +89,33 @@ namespace Verdandi
     template <class T, class Allocator>
     void GetInverse(Matrix<T, General, RowSparse, Allocator>& A);
 
+    template <class T0, class T1, class Allocator1,
+              class T2, class Allocator2>
+    void RankKUpdate(T0 alpha,
+                     const Matrix<T1, General, RowMajor, Allocator1>& W,
+                     Matrix<T2, General, RowMajor, Allocator2>& B);
+    template <class T0, class T1, class Allocator1,
+              class T2, class Prop2, class Allocator2>
+    void RankKUpdate(T0 alpha,
+                     const Matrix<T1, General, RowMajor, Allocator1>& W,
+                     Matrix<T2, Prop2, RowSymPacked, Allocator2>& B);
+    template <class T0, class T1, class Prop1, class Storage1,
+              class Allocator1, class T2, class Prop2, class Allocator2>
+    void AddUpperPart(T0 alpha,
+                      const Matrix<T1, Prop1, Storage1, Allocator1>& A,
+                      Matrix<T2, Prop2, RowSymPacked, Allocator2>& B);
+
+    template <class T0, class Allocator0, class T1, class Allocator1>
+    T1 QuadraticForm(const Matrix<T0, General, RowMajor, Allocator0>& A,
+                     const Vector<T1, VectFull, Allocator1>& x);
+    template <class T0, class Allocator0, class T1, class Allocator1>
+    T1 QuadraticForm(const Matrix<T0, General, RowSparse, Allocator0>& A,
+                     const Vector<T1, VectFull, Allocator1>& x);
+    template <class T0, class Prop0, class Storage0, class Allocator0,
+              class T1, class Storage1, class Allocator1>
+    T1 QuadraticForm(const Matrix<T0, Prop0, Storage0, Allocator0>& A,
+                     const Vector<T1, Storage1, Allocator1>& x);
+
     template <class T0, class Allocator0,
               class T1, class Allocator1>
     void Copy(const Matrix<T0, General, RowMajor, Allocator0>& A,
@@ -100,6 +100,78 @@ namespace Verdandi
     }
 
 
+    //! Returns the Gaspari-Cohn correlation function.
+    /*! This is the fifth-order piecewise rational function of Gaspari and
+      Cohn (1999), with compact support. It is equal to 1 at \a distance 0
+      and vanishes for \a distance greater than twice \a radius.
+      \param[in] distance distance between the two points.
+      \param[in] radius half-width of the support.
+      \return The correlation between two points at the given distance.
+    */
+    template <class T>
+    T gaspari_cohn(T distance, T radius)
+    {
+        T r = abs(distance) / radius;
+        if (r >= T(2))
+            return T(0);
+        T r2 = r * r;
+        T r3 = r2 * r;
+        if (r <= T(1))
+            return T(-0.25) * r2 * r3 + T(0.5) * r2 * r2 + T(0.625) * r3
+                - T(5) / T(3) * r2 + T(1);
+        return r2 * r3 / T(12) - T(0.5) * r2 * r2 + T(0.625) * r3
+            + T(5) / T(3) * r2 - T(5) * r + T(4) - T(2) / (T(3) * r);
+    }
+
+
+    //! Applies a Gaspari-Cohn localization to a matrix.
+    /*! The matrix \a M is multiplied, element by element (Schur product), by
+      the correlations \f$\rho(d_{ij})\f$ where \f$d_{ij}\f$ is the
+      Euclidean distance between the point associated with the row \a i and
+      the point associated with the column \a j.
+      \param[in] coordinate_row coordinates of the points associated with the
+      rows of \a M: row \a i contains the coordinates of the \a i-th point.
+      \param[in] coordinate_column coordinates of the points associated with
+      the columns of \a M.
+      \param[in] radius half-width of the support of the correlation
+      function.
+      \param[in,out] M the matrix to be localized.
+    */
+    template <class T, class Prop, class Storage, class Allocator>
+    void schur_localize(const Matrix<double>& coordinate_row,
+                        const Matrix<double>& coordinate_column,
+                        double radius,
+                        Matrix<T, Prop, Storage, Allocator>& M)
+    {
+        int Ndimension = coordinate_row.GetN();
+        if (int(coordinate_row.GetM()) != int(M.GetM())
+            || int(coordinate_column.GetM()) != int(M.GetN())
+            || int(coordinate_column.GetN()) != Ndimension)
+            throw ErrorArgument("schur_localize",
+                                "The dimensions of the coordinates ("
+                                + to_str(coordinate_row.GetM()) + " x "
+                                + to_str(Ndimension) + " and "
+                                + to_str(coordinate_column.GetM()) + " x "
+                                + to_str(coordinate_column.GetN())
+                                + ") are not compatible with the matrix ("
+                                + to_str(M.GetM()) + " x " + to_str(M.GetN())
+                                + ").");
+
+        double distance, delta;
+        for (size_t i = 0; i < M.GetM(); i++)
+            for (size_t j = 0; j < M.GetN(); j++)
+            {
+                distance = 0.;
+                for (int d = 0; d < Ndimension; d++)
+                {
+                    delta = coordinate_row(i, d) - coordinate_column(j, d);
+                    distance += delta * delta;
+                }
+                M(i, j) *= T(gaspari_cohn(sqrt(distance), radius));
+            }
+    }
+
+
     //! Converts strings to most types.
     /*!
       \param[in] s string to be converted.
@@ -286,6 +358,198 @@ namespace Verdandi
     }
 
 
+    //! Performs a symmetric rank-k update.
+    /*! It computes \f$ B = B + \alpha W W^T \f$, where \a W has \a k
+      columns, with a single matrix-matrix product (a BLAS call if Seldon
+      is compiled with BLAS).
+      \param[in] alpha a given scalar.
+      \param[in] W a matrix with as many rows as \a B.
+      \param[in,out] B a symmetric matrix.
+    */
+    template <class T0, class T1, class Allocator1,
+              class T2, class Allocator2>
+    void RankKUpdate(T0 alpha,
+                     const Matrix<T1, General, RowMajor, Allocator1>& W,
+                     Matrix<T2, General, RowMajor, Allocator2>& B)
+    {
+        int n = W.GetM();
+
+        if (B.GetM() != n || B.GetN() != n)
+            throw ErrorArgument("RankKUpdate(alpha, W, B)",
+                                "The matrix has dimensions "
+                                + to_str(B.GetM()) + " x "
+                                + to_str(B.GetN()) + " while the factor has "
+                                + to_str(n) + " rows.");
+
+        MltAdd(T2(alpha), SeldonNoTrans, W, SeldonTrans, W, T2(1), B);
+    }
+
+
+    //! Performs a symmetric rank-k update.
+    /*! It computes \f$ B = B + \alpha W W^T \f$, where \a W has \a k
+      columns and \a B is stored in packed form. The rows of \f$W W^T\f$
+      are computed by blocks, each with one matrix-matrix product (a BLAS
+      call if Seldon is compiled with BLAS), and only their upper parts are
+      added to \a B.
+      \param[in] alpha a given scalar.
+      \param[in] W a matrix with as many rows as \a B.
+      \param[in,out] B a symmetric matrix.
+    */
+    template <class T0, class T1, class Allocator1,
+              class T2, class Prop2, class Allocator2>
+    void RankKUpdate(T0 alpha,
+                     const Matrix<T1, General, RowMajor, Allocator1>& W,
+                     Matrix<T2, Prop2, RowSymPacked, Allocator2>& B)
+    {
+        int n = W.GetM();
+        int k = W.GetN();
+
+        if (B.GetM() != n || B.GetN() != n)
+            throw ErrorArgument("RankKUpdate(alpha, W, B)",
+                                "The matrix has dimensions "
+                                + to_str(B.GetM()) + " x "
+                                + to_str(B.GetN()) + " while the factor has "
+                                + to_str(n) + " rows.");
+
+        // Number of rows of W W^T computed at once.
+        const int Nblock = 64;
+
+        Matrix<T1, General, RowMajor, Allocator1> W_block;
+        Matrix<T2, General, RowMajor, Allocator2> product;
+        for (int first = 0; first < n; first += Nblock)
+        {
+            int Nrow = min(Nblock, n - first);
+            W_block.Reallocate(Nrow, k);
+            for (int i = 0; i < Nrow; i++)
+                for (int l = 0; l < k; l++)
+                    W_block(i, l) = W(first + i, l);
+
+            product.Reallocate(Nrow, n);
+            MltAdd(T2(alpha), SeldonNoTrans, W_block, SeldonTrans, W, T2(0),
+                   product);
+
+            for (int i = 0; i < Nrow; i++)
+                for (int j = first + i; j < n; j++)
+                    B(first + i, j) += product(i, j);
+        }
+    }
+
+
+    //! Adds the upper part of a matrix to a symmetric packed matrix.
+    /*! It computes \f$ B = B + \alpha A \f$ where \a A is assumed to be
+      symmetric, so that only its upper part is read.
+      \param[in] alpha a given scalar.
+      \param[in] A a symmetric matrix, in any storage.
+      \param[in,out] B a symmetric matrix stored in packed form.
+    */
+    template <class T0, class T1, class Prop1, class Storage1,
+              class Allocator1, class T2, class Prop2, class Allocator2>
+    void AddUpperPart(T0 alpha,
+                      const Matrix<T1, Prop1, Storage1, Allocator1>& A,
+                      Matrix<T2, Prop2, RowSymPacked, Allocator2>& B)
+    {
+        int n = B.GetM();
+
+        if (A.GetM() != n || A.GetN() != n)
+            throw ErrorArgument("AddUpperPart(alpha, A, B)",
+                                "The matrices have dimensions "
+                                + to_str(A.GetM()) + " x "
+                                + to_str(A.GetN()) + " and "
+                                + to_str(n) + " x " + to_str(n) + ".");
+
+        for (int i = 0; i < n; i++)
+            for (int j = i; j < n; j++)
+                B(i, j) += alpha * A(i, j);
+    }
+
+
+    //! Computes a quadratic form with a dense matrix.
+    /*! The rows of \a A are traversed once, and no temporary vector is
+      allocated.
+      \param[in] A a square matrix.
+      \param[in] x a vector.
+      \return The value of \f$ x^T A x \f$.
+    */
+    template <class T0, class Allocator0, class T1, class Allocator1>
+    T1 QuadraticForm(const Matrix<T0, General, RowMajor, Allocator0>& A,
+                     const Vector<T1, VectFull, Allocator1>& x)
+    {
+        int n = x.GetM();
+
+        if (A.GetM() != n || A.GetN() != n)
+            throw ErrorArgument("QuadraticForm(A, x)",
+                                "The matrix has dimensions "
+                                + to_str(A.GetM()) + " x "
+                                + to_str(A.GetN()) + ", but the vector "
+                                "has " + to_str(n) + " elements.");
+
+        const T0* data = A.GetData();
+        const T1* value = x.GetData();
+        T1 result(0);
+        for (int i = 0; i < n; i++, data += n)
+        {
+            T1 row_product(0);
+            for (int j = 0; j < n; j++)
+                row_product += data[j] * value[j];
+            result += value[i] * row_product;
+        }
+        return result;
+    }
+
+
+    //! Computes a quadratic form with a sparse matrix.
+    /*! The non-zero entries of \a A are traversed once, and no temporary
+      vector is allocated.
+      \param[in] A a square matrix.
+      \param[in] x a vector.
+      \return The value of \f$ x^T A x \f$.
+    */
+    template <class T0, class Allocator0, class T1, class Allocator1>
+    T1 QuadraticForm(const Matrix<T0, General, RowSparse, Allocator0>& A,
+                     const Vector<T1, VectFull, Allocator1>& x)
+    {
+        int n = x.GetM();
+
+        if (A.GetM() != n || A.GetN() != n)
+            throw ErrorArgument("QuadraticForm(A, x)",
+                                "The matrix has dimensions "
+                                + to_str(A.GetM()) + " x "
+                                + to_str(A.GetN()) + ", but the vector "
+                                "has " + to_str(n) + " elements.");
+
+        const T0* data = A.GetData();
+        const int* ptr = A.GetPtr();
+        const int* column = A.GetInd();
+        const T1* value = x.GetData();
+        T1 result(0);
+        for (int i = 0; i < n; i++)
+        {
+            T1 row_product(0);
+            for (int j = ptr[i]; j < ptr[i + 1]; j++)
+                row_product += data[j] * value[column[j]];
+            result += value[i] * row_product;
+        }
+        return result;
+    }
+
+
+    //! Computes a quadratic form.
+    /*! This generic version computes \f$ A x \f$ in a temporary vector.
+      \param[in] A a square matrix.
+      \param[in] x a vector.
+      \return The value of \f$ x^T A x \f$.
+    */
+    template <class T0, class Prop0, class Storage0, class Allocator0,
+              class T1, class Storage1, class Allocator1>
+    T1 QuadraticForm(const Matrix<T0, Prop0, Storage0, Allocator0>& A,
+                     const Vector<T1, Storage1, Allocator1>& x)
+    {
+        Vector<T1, Storage1, Allocator1> Ax(x);
+        MltAdd(T1(1), A, x, T1(0), Ax);
+        return DotProd(x, Ax);
+    }
+
+
     //! Conversion from 'RowMajor' to 'RowSymPacked' format.
     /*!
       \param[in] A the 'RowMajor' matrix to be converted.
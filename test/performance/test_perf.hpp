@@ -119,3 +119,51 @@ TEST_F(PerformanceTest, PerformanceUKF)
         driver.FinalizeStep();
     }
 }
+
+
+/*! \brief This test compares the computation of a gain \f$K = X S^{-1}\f$,
+  with \f$S\f$ symmetric positive definite, through the explicit inverse of
+  \f$S\f$ and through 'SymmetricFactorization'. */
+TEST_F(PerformanceTest, PerformanceFactorization)
+{
+    const int Nobservation = 400;
+    const int Nstate = 1000;
+
+    // A symmetric positive definite matrix, similar to $H B H^T + R$.
+    Matrix<real> A(Nobservation, Nobservation), S(Nobservation, Nobservation);
+    for (int i = 0; i < Nobservation; i++)
+        for (int j = 0; j < Nobservation; j++)
+            A(i, j) = sin(real(i + 2 * j));
+    MltAdd(real(1), SeldonNoTrans, A, SeldonTrans, A, real(0), S);
+    for (int i = 0; i < Nobservation; i++)
+        S(i, i) += real(Nobservation);
+
+    Matrix<real> X(Nstate, Nobservation);
+    for (int i = 0; i < Nstate; i++)
+        for (int j = 0; j < Nobservation; j++)
+            X(i, j) = cos(real(3 * i + j));
+
+    // With the explicit inverse.
+    TIMER("inverse");
+    Matrix<real> S_inv(S), K_inverse(Nstate, Nobservation);
+    GetInverse(S_inv);
+    MltAdd(real(1), X, S_inv, real(0), K_inverse);
+    TIMER("inverse");
+
+    // With the factorization.
+    TIMER("factorization");
+    SymmetricFactorization<real> S_factorization;
+    S_factorization.Factorize(S);
+    Matrix<real> K_factorization(X);
+    S_factorization.SolveRow(K_factorization);
+    TIMER("factorization");
+
+    for (int i = 0; i < Nstate; i++)
+        for (int j = 0; j < Nobservation; j++)
+            EXPECT_NEAR(K_inverse(i, j), K_factorization(i, j), 1.e-10);
+
+    PRINT_TIMER("inverse");
+    PRINT_TIMER("factorization");
+    RESET_TIMER("inverse");
+    RESET_TIMER("factorization");
+}
@@ -234,6 +234,73 @@ public:
                             1.e-6 * B_dense(i, j));
     }
 
+    // Compares the symmetric BLUE with the explicit dense formulas.
+    void compute_symmetric()
+    {
+        // Symmetric positive definite B and R, and H with a sparse pattern.
+        Matrix<double> W(Nx_, Nx_), B(Nx_, Nx_), R(Ny_, Ny_);
+        W.FillRand();
+        Mlt(1. / double(RAND_MAX), W);
+        B.SetIdentity();
+        RankKUpdate(1., W, B);
+        R.SetIdentity();
+
+        Matrix<double> H_dense(Ny_, Nx_);
+        Matrix<double, General, ArrayRowSparse> H_array(Ny_, Nx_);
+        H_dense.Zero();
+        for (int i = 0; i < Ny_; i++)
+            for (int j = i % 2; j < Nx_; j += 2)
+            {
+                H_dense(i, j) = double(rand()) / double(RAND_MAX);
+                H_array.Get(i, j) = H_dense(i, j);
+            }
+        Matrix<double, General, RowSparse> H_sparse;
+        Copy(H_array, H_sparse);
+
+        Vector<double> x(Nx_), y(Ny_);
+        x.FillRand();
+        Mlt(1. / double(RAND_MAX), x);
+        y.FillRand();
+        Mlt(1. / double(RAND_MAX), y);
+
+        // Reference: K = B H' (H B H' + R)^{-1}, x + K (y - H x) and
+        // B - K H B.
+        Matrix<double> BHt(Nx_, Ny_), S(R), K(Nx_, Ny_), B_reference(B);
+        MltAdd(1., SeldonNoTrans, B, SeldonTrans, H_dense, 0., BHt);
+        MltAdd(1., H_dense, BHt, 1., S);
+        GetInverse(S);
+        MltAdd(1., BHt, S, 0., K);
+        MltAdd(-1., SeldonNoTrans, K, SeldonTrans, BHt, 1., B_reference);
+        Vector<double> innovation(y), x_reference(x);
+        MltAdd(-1., H_dense, x, 1., innovation);
+        MltAdd(1., K, innovation, 1., x_reference);
+
+        Matrix<double> tmp;
+        Matrix<double> B_dense(B);
+        Vector<double> x_dense(x);
+        ComputeBLUE_matrix(B_dense, H_dense, tmp, y, R, x_dense, false,
+                           true);
+
+        Matrix<double, Symmetric, RowSymPacked> B_packed(Nx_, Nx_);
+        for (int i = 0; i < Nx_; i++)
+            for (int j = i; j < Nx_; j++)
+                B_packed(i, j) = B(i, j);
+        Vector<double> x_packed(x);
+        ComputeBLUE_matrix(B_packed, H_sparse, tmp, y, R, x_packed, false,
+                           true);
+
+        for (int i = 0; i < Nx_; i++)
+        {
+            ASSERT_NEAR(x_dense(i), x_reference(i), 1.e-8);
+            ASSERT_NEAR(x_packed(i), x_reference(i), 1.e-8);
+            for (int j = 0; j < Nx_; j++)
+            {
+                ASSERT_NEAR(B_dense(i, j), B_reference(i, j), 1.e-8);
+                ASSERT_NEAR(B_packed(i, j), B_reference(i, j), 1.e-8);
+            }
+        }
+    }
+
     // Fills a matrix with ones.
     template <class MatrixType>
     void fill_matrix(int m, int n, MatrixType& M)
@@ -295,3 +362,18 @@ TEST_F (BLUETest, test_compute_covariance)
         compute_covariance();
     }
 }
+
+
+TEST_F (BLUETest, test_compute_symmetric)
+{
+    int Nx[3] = {10, 100,  1};
+    int Ny[3] = { 2,  70,  1};
+
+    for (int i = 0; i < 3; i++)
+    {
+        Nx_ = Nx[i];
+        Ny_ = Ny[i];
+
+        compute_symmetric();
+    }
+}
@@ -0,0 +1,69 @@
+-- Configuration of the strong-constraint 4D-Var applied to the affine test
+-- model, with the incremental minimization.
+
+
+dofile("configuration.lua")
+
+four_dimensional_variational = {
+
+   observation_tangent_linear_operator_access = "matrix",
+   observation_access = "step",
+
+   constraint = "strong",
+   minimization = "incremental",
+
+   incremental = {
+
+      Nouter_loop = 1,
+      Ninner_iteration_max = 50,
+      inner_tolerance = 1.e-10
+
+   },
+
+   weak_constraint = {
+
+      Nsub_window = 3,
+      Nthread = 1,
+      model_error_variance = 0.5
+
+   },
+
+   nlopt = {
+
+      algorithm = "LBFGS",
+      parameter_tolerance = 1.e-10,
+      cost_function_tolerance = 1.e-12,
+      Niteration_max = 1000
+
+   },
+
+   trajectory_manager = {
+
+      checkpoint_recording_mode = "memory",
+      checkpoint_recording_file = "",
+      trajectory_recording_mode = "memory",
+      trajectory_recording_file = "",
+      Nskip_step = 1,
+      checkpoint_schedule = "uniform"
+
+   },
+
+   display = {
+
+      optimization_iteration = false,
+      optimized_parameter = false,
+      iteration = false,
+      time = false,
+      analysis_time = false
+
+   },
+
+   output_saver = {
+
+      variable_list = {"forecast_time", "forecast_state",
+                       "analysis_time", "analysis_state"},
+      file = output_directory .. "4dvar-%{name}.%{extension}"
+
+   }
+
+}
@@ -0,0 +1,8 @@
+-- Configuration of the weak-constraint 4D-Var applied to the affine test
+-- model, with three sub-windows.
+
+
+dofile("configuration_4dvar.lua")
+
+four_dimensional_variational.constraint = "weak"
+four_dimensional_variational.minimization = "nonlinear"
@@ -0,0 +1,9 @@
+-- Configuration of the extended Kalman filter with a low-rank covariance
+-- whose rank is the dimension of the state, so that it should produce the
+-- same results as with the full covariance.
+
+
+dofile("configuration.lua")
+
+extended_kalman_filter.covariance_computation = "low_rank"
+extended_kalman_filter.covariance_rank = 2
@@ -0,0 +1,499 @@
+// Copyright (C) 2026
+// Author(s): agent
+//
+// This file is part of the data assimilation library Verdandi.
+//
+// Verdandi is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Verdandi is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Verdandi. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Verdandi web site:
+//      http://verdandi.gforge.inria.fr/
+
+
+#include <cmath>
+
+#include "Verdandi.hxx"
+#include "method/FourDimensionalVariational.cxx"
+#include "method/LBFGSSolver.cxx"
+using namespace Verdandi;
+
+
+//! Affine model x_{n + 1} = A x_n + f in dimension 3, with its adjoint.
+class AffineModel: public VerdandiBase
+{
+public:
+    typedef double value_type;
+    typedef Vector<double> state;
+    typedef Matrix<double> state_error_variance;
+    typedef Vector<double> state_error_variance_row;
+    typedef Matrix<double> matrix_state_observation;
+    typedef Matrix<double> tangent_linear_operator;
+    typedef Matrix<double> error_variance;
+
+protected:
+    //! Linear part of the model.
+    Matrix<double> A_;
+    //! Constant part of the model.
+    state f_;
+    state state_;
+    state adjoint_state_;
+    double time_;
+    double final_time_;
+    //! Background error covariance matrix.
+    state_error_variance state_error_variance_;
+    //! Model error covariance matrix, empty for a scaled identity.
+    error_variance error_variance_;
+    state bound_;
+    state additional_adjoint_term_;
+
+public:
+    AffineModel(): A_(3, 3), f_(3), state_(3), adjoint_state_(3),
+                   time_(0.), final_time_(8.), state_error_variance_(3, 3),
+                   additional_adjoint_term_(3)
+    {
+        A_(0, 0) = 0.9;
+        A_(0, 1) = 0.2;
+        A_(0, 2) = 0.;
+        A_(1, 0) = -0.1;
+        A_(1, 1) = 0.8;
+        A_(1, 2) = 0.3;
+        A_(2, 0) = 0.;
+        A_(2, 1) = -0.2;
+        A_(2, 2) = 0.95;
+        f_(0) = 0.1;
+        f_(1) = 0.;
+        f_(2) = -0.05;
+
+        state_(0) = 0.5;
+        state_(1) = -0.2;
+        state_(2) = 0.3;
+        adjoint_state_.Zero();
+
+        state_error_variance_.Zero();
+        state_error_variance_(0, 0) = 1.;
+        state_error_variance_(0, 1) = 0.2;
+        state_error_variance_(1, 0) = 0.2;
+        state_error_variance_(1, 1) = 0.5;
+        state_error_variance_(1, 2) = 0.1;
+        state_error_variance_(2, 1) = 0.1;
+        state_error_variance_(2, 2) = 2.;
+
+        additional_adjoint_term_.Zero();
+    }
+
+    void Initialize(string configuration_file)
+    {
+        time_ = 0.;
+    }
+
+    void InitializeStep()
+    {
+    }
+
+    void Forward()
+    {
+        state x(state_);
+        MltAdd(1., A_, x, 0., state_);
+        Add(1., f_, state_);
+        time_ += 1.;
+    }
+
+    void ApplyTangentLinearOperator(state& x)
+    {
+        state y(x);
+        MltAdd(1., A_, y, 0., x);
+    }
+
+    //! Computes A^T p + source, where p is the adjoint state.
+    void BackwardAdjoint(state& source)
+    {
+        state p(adjoint_state_);
+        MltAdd(1., SeldonTrans, A_, p, 0., adjoint_state_);
+        Add(1., source, adjoint_state_);
+    }
+
+    bool HasFinished() const
+    {
+        return time_ >= final_time_;
+    }
+
+    void FinalizeStep()
+    {
+    }
+
+    void Finalize()
+    {
+    }
+
+    int GetNstate() const
+    {
+        return 3;
+    }
+
+    double GetTime() const
+    {
+        return time_;
+    }
+
+    void SetTime(double time)
+    {
+        time_ = time;
+    }
+
+    state& GetState()
+    {
+        return state_;
+    }
+
+    void StateUpdated()
+    {
+    }
+
+    state& GetAdjointState()
+    {
+        return adjoint_state_;
+    }
+
+    void AdjointStateUpdated()
+    {
+    }
+
+    state& GetStateLowerBound()
+    {
+        return bound_;
+    }
+
+    state& GetStateUpperBound()
+    {
+        return bound_;
+    }
+
+    double GetAdditionalCostTerm()
+    {
+        return 0.;
+    }
+
+    state& GetAdditionalAdjointTerm()
+    {
+        return additional_adjoint_term_;
+    }
+
+    state_error_variance& GetStateErrorVariance()
+    {
+        return state_error_variance_;
+    }
+
+    error_variance& GetErrorVariance()
+    {
+        return error_variance_;
+    }
+
+    string GetName() const
+    {
+        return "AffineModel";
+    }
+};
+
+
+/*! \brief Observation manager that observes two linear combinations of the
+  state every other step. */
+class AffineObservationManager: public VerdandiBase
+{
+public:
+    typedef Matrix<double> tangent_linear_operator;
+    typedef Vector<double> tangent_linear_operator_row;
+    typedef Matrix<double> error_variance;
+    typedef Vector<double> observation;
+
+protected:
+    tangent_linear_operator H_;
+    error_variance R_inv_;
+    observation observation_;
+    observation innovation_;
+    double time_;
+
+public:
+    AffineObservationManager(): H_(2, 3), R_inv_(2, 2), observation_(2),
+                                time_(0.)
+    {
+        H_.Zero();
+        H_(0, 0) = 1.;
+        H_(0, 2) = 0.5;
+        H_(1, 1) = 1.;
+        H_(1, 2) = -1.;
+        R_inv_.Zero();
+        R_inv_(0, 0) = 2.;
+        R_inv_(1, 1) = 0.5;
+    }
+
+    void Initialize(AffineModel& model, string configuration_file)
+    {
+        time_ = model.GetTime();
+    }
+
+    void DiscardObservation(bool discard_observation)
+    {
+    }
+
+    void SetTime(AffineModel& model, double time)
+    {
+        time_ = time;
+        observation_(0) = std::sin(time_);
+        observation_(1) = std::cos(time_);
+    }
+
+    bool HasObservation() const
+    {
+        return int(time_ + 0.5) % 2 == 0;
+    }
+
+    int GetNobservation() const
+    {
+        return 2;
+    }
+
+    observation& GetObservation()
+    {
+        return observation_;
+    }
+
+    observation& GetInnovation(const AffineModel::state& x)
+    {
+        innovation_.Reallocate(2);
+        Copy(observation_, innovation_);
+        MltAdd(-1., H_, x, 1., innovation_);
+        return innovation_;
+    }
+
+    void ApplyOperator(const AffineModel::state& x, observation& y) const
+    {
+        y.Reallocate(2);
+        MltAdd(1., H_, x, 0., y);
+    }
+
+    void ApplyTangentLinearOperator(const AffineModel::state& x,
+                                    observation& y) const
+    {
+        ApplyOperator(x, y);
+    }
+
+    double GetTangentLinearOperator(int i, int j) const
+    {
+        return H_(i, j);
+    }
+
+    const tangent_linear_operator& GetTangentLinearOperator() const
+    {
+        return H_;
+    }
+
+    const error_variance& GetErrorVarianceInverse() const
+    {
+        return R_inv_;
+    }
+
+    void ApplyErrorVarianceInverse(observation& y) const
+    {
+        observation z(y);
+        MltAdd(1., R_inv_, z, 0., y);
+    }
+
+    string GetName() const
+    {
+        return "AffineObservationManager";
+    }
+};
+
+
+typedef FourDimensionalVariational<AffineModel, AffineObservationManager,
+                                   LBFGSSolver<double> > AffineVariational;
+
+
+//! Gives access to the sub-windows and to the incremental 4D-Var.
+class TestFourDimensionalVariational: public AffineVariational
+{
+public:
+    using AffineVariational::InitializeSubWindow;
+    using AffineVariational::ComputeLinearizationTrajectory;
+    using AffineVariational::ApplyIncrementalHessian;
+};
+
+
+class FourDimensionalVariationalTest: public testing::Test
+{
+public:
+    typedef double (AffineVariational::*cost_function)
+    (const Vector<double>&, Vector<double>&);
+
+protected:
+    //! Step of the finite differences.
+    double epsilon_;
+    //! Relative accuracy of the finite differences.
+    double accuracy_;
+
+public:
+    void SetUp()
+    {
+        // The cost functions are quadratic, so that the centered finite
+        // differences only suffer from round-off errors.
+        epsilon_ = 1.e-3;
+        accuracy_ = 1.e-6;
+    }
+
+    //! Fills \a x with reproducible values of order 1.
+    void fill(Vector<double>& x, double seed)
+    {
+        for (int i = 0; i < x.GetM(); i++)
+            x(i) = std::sin(1.7 * double(i) + seed);
+    }
+
+    //! Checks the gradient of a cost function along the canonical basis.
+    void check_gradient(TestFourDimensionalVariational& driver,
+                        cost_function cost, const Vector<double>& x)
+    {
+        int N = x.GetM();
+        Vector<double> gradient(N), empty;
+        (driver.*cost)(x, gradient);
+
+        for (int i = 0; i < N; i++)
+        {
+            Vector<double> x_plus(x), x_minus(x);
+            x_plus(i) += epsilon_;
+            x_minus(i) -= epsilon_;
+            double derivative = ((driver.*cost)(x_plus, empty)
+                                 - (driver.*cost)(x_minus, empty))
+                / (2. * epsilon_);
+            EXPECT_NEAR(derivative, gradient(i),
+                        accuracy_ * std::max(1., std::abs(derivative)));
+        }
+    }
+};
+
+
+TEST_F(FourDimensionalVariationalTest, test_weak_constraint_gradient)
+{
+    TestFourDimensionalVariational driver;
+    driver.Initialize("configuration_4dvar_weak.lua");
+    driver.InitializeSubWindow();
+
+    // Initial states of the three sub-windows.
+    Vector<double> x(9);
+    fill(x, 0.4);
+    check_gradient(driver, &AffineVariational::CostWeakConstraint, x);
+}
+
+
+TEST_F(FourDimensionalVariationalTest, test_strong_constraint_gradient)
+{
+    TestFourDimensionalVariational driver;
+    driver.Initialize("configuration_4dvar.lua");
+
+    Vector<double> x(3);
+    fill(x, 0.4);
+    check_gradient(driver, &AffineVariational::Cost, x);
+}
+
+
+TEST_F(FourDimensionalVariationalTest, test_incremental_hessian)
+{
+    TestFourDimensionalVariational driver;
+    driver.Initialize("configuration_4dvar.lua");
+
+    Vector<double> x(3), direction(3), hessian_direction(3);
+    fill(x, 0.4);
+    driver.ComputeLinearizationTrajectory(x);
+
+    // The model is affine, so that the Hessian of the inner loop is the
+    // Hessian of the cost function, which is compared with the finite
+    // differences of the gradient.
+    for (int j = 0; j < 3; j++)
+    {
+        direction.Zero();
+        direction(j) = 1.;
+        driver.ApplyIncrementalHessian(direction, hessian_direction);
+
+        Vector<double> x_plus(x), x_minus(x), gradient_plus(3),
+            gradient_minus(3);
+        x_plus(j) += epsilon_;
+        x_minus(j) -= epsilon_;
+        driver.Cost(x_plus, gradient_plus);
+        driver.Cost(x_minus, gradient_minus);
+        for (int i = 0; i < 3; i++)
+        {
+            double derivative = (gradient_plus(i) - gradient_minus(i))
+                / (2. * epsilon_);
+            EXPECT_NEAR(derivative, hessian_direction(i),
+                        accuracy_ * std::max(1., std::abs(derivative)));
+        }
+    }
+}
+
+
+TEST_F(FourDimensionalVariationalTest, test_incremental_analysis)
+{
+    TestFourDimensionalVariational driver;
+    driver.Initialize("configuration_4dvar.lua");
+
+    Vector<double> x(3), gradient(3);
+    Copy(driver.GetModel().GetState(), x);
+    driver.Cost(x, gradient);
+    double initial_norm = Norm2(gradient);
+    ASSERT_GT(initial_norm, 0.);
+
+    // With an affine model, the conjugate gradient of the first outer loop
+    // reaches the minimum of the cost function.
+    driver.Analyze();
+    Copy(driver.GetModel().GetState(), x);
+    driver.Cost(x, gradient);
+    EXPECT_LE(Norm2(gradient), 1.e-8 * initial_norm);
+}
+
+
+TEST_F(FourDimensionalVariationalTest, test_hessian)
+{
+    TestFourDimensionalVariational driver;
+    driver.Initialize("configuration_4dvar.lua");
+
+    // The Gauss-Newton Hessian is exact for an affine model, so that it is
+    // compared with the finite differences of the gradient, along a
+    // direction which is not in the canonical basis.
+    Vector<double> x(3), direction(3), hessian_direction;
+    fill(x, 0.4);
+    fill(direction, 1.1);
+    AffineVariational::StaticHessian(x, direction, hessian_direction,
+                                     reinterpret_cast<void*>(&driver));
+    ASSERT_EQ(3, hessian_direction.GetM());
+
+    Vector<double> x_plus(x), x_minus(x), gradient_plus(3),
+        gradient_minus(3);
+    Add(epsilon_, direction, x_plus);
+    Add(-epsilon_, direction, x_minus);
+    driver.Cost(x_plus, gradient_plus);
+    driver.Cost(x_minus, gradient_minus);
+    for (int i = 0; i < 3; i++)
+    {
+        double derivative = (gradient_plus(i) - gradient_minus(i))
+            / (2. * epsilon_);
+        EXPECT_NEAR(derivative, hessian_direction(i),
+                    accuracy_ * std::max(1., std::abs(derivative)));
+    }
+
+    // A second product at the same point reuses the linearization
+    // trajectory, and the Hessian is symmetric.
+    Vector<double> other(3), hessian_other;
+    fill(other, 2.3);
+    driver.ApplyHessian(x, other, hessian_other);
+    double product = DotProd(other, hessian_direction);
+    EXPECT_NEAR(product, DotProd(direction, hessian_other),
+                accuracy_ * std::max(1., std::abs(product)));
+}
@@ -0,0 +1,154 @@
+// Copyright (C) 2026
+// Author(s): agent
+//
+// This file is part of the data assimilation library Verdandi.
+//
+// Verdandi is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Verdandi is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Verdandi. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Verdandi web site:
+//      http://verdandi.gforge.inria.fr/
+
+
+#include "Verdandi.hxx"
+#include "method/LBFGSSolver.cxx"
+using namespace Verdandi;
+
+
+//! Rosenbrock function, with an optional shift of its minimum.
+double rosenbrock(const Vector<double>& x, Vector<double>& gradient,
+                  void* shift_pointer)
+{
+    double shift = *reinterpret_cast<double*>(shift_pointer);
+    int N = x.GetM();
+    double cost = 0.;
+    if (gradient.GetM() != 0)
+        gradient.Fill(0.);
+    for (int i = 0; i < N - 1; i++)
+    {
+        double a = x(i + 1) - shift - (x(i) - shift) * (x(i) - shift);
+        double b = 1. + shift - x(i);
+        cost += 100. * a * a + b * b;
+        if (gradient.GetM() != 0)
+        {
+            gradient(i) += -400. * a * (x(i) - shift) - 2. * b;
+            gradient(i + 1) += 200. * a;
+        }
+    }
+    return cost;
+}
+
+
+class LBFGSTest: public testing::Test
+{
+protected:
+    int N_;
+
+public:
+    void minimize()
+    {
+        LBFGSSolver<double> solver;
+        solver.Initialize(N_, "LBFGS", 1.e-12, 1.e-14, 10000);
+
+        double shift = 0.;
+        Vector<double> x(N_);
+        x.Fill(-1.);
+        solver.SetParameter(x);
+        solver.Optimize(rosenbrock, &shift);
+        solver.GetParameter(x);
+        for (int i = 0; i < N_; i++)
+            EXPECT_NEAR(1., x(i), 1.e-4);
+        EXPECT_NEAR(0., solver.GetCost(), 1.e-8);
+    }
+
+    void bound()
+    {
+        LBFGSSolver<double> solver;
+        solver.Initialize(N_, "LBFGS", 1.e-12, 1.e-14, 10000);
+
+        Vector<double> upper_bound(N_);
+        upper_bound.Fill(0.5);
+        solver.SetUpperBound(upper_bound);
+
+        double shift = 0.;
+        Vector<double> x(N_);
+        x.Fill(0.);
+        solver.SetParameter(x);
+        solver.Optimize(rosenbrock, &shift);
+        solver.GetParameter(x);
+        for (int i = 0; i < N_; i++)
+            EXPECT_LE(x(i), 0.5);
+
+        // With five parameters, only the bound on x(0) is active at the
+        // minimizer, where the other components of the gradient vanish.
+        double minimizer[5] = {0.5, 0.26303737934581833, 0.07996232778898615,
+                               0.016231657292508184, 0.00026346669846143416};
+        for (int i = 0; i < N_; i++)
+            EXPECT_NEAR(minimizer[i], x(i), 1.e-5);
+        EXPECT_NEAR(2.645665887626858, solver.GetCost(), 1.e-8);
+    }
+
+    void warm_start()
+    {
+        LBFGSSolver<double> cold, warm;
+        cold.Initialize(N_, "LBFGS", 1.e-10, 1.e-12, 10000);
+        warm.Initialize(N_, "LBFGS", 1.e-10, 1.e-12, 10000);
+        cold.SetWarmStart(false);
+
+        // Both solvers minimize a first problem, then a slightly shifted
+        // problem: only one of them keeps its correction pairs.
+        double shift = 0.;
+        Vector<double> x(N_);
+        x.Fill(0.);
+        cold.SetParameter(x);
+        warm.SetParameter(x);
+        cold.Optimize(rosenbrock, &shift);
+        warm.Optimize(rosenbrock, &shift);
+        EXPECT_GT(warm.GetNpair(), 0);
+
+        shift = 1.e-3;
+        cold.Optimize(rosenbrock, &shift);
+        warm.Optimize(rosenbrock, &shift);
+        EXPECT_LE(warm.GetNevaluation(), cold.GetNevaluation());
+
+        cold.GetParameter(x);
+        for (int i = 0; i < N_; i++)
+            EXPECT_NEAR(1. + shift, x(i), 1.e-4);
+        warm.GetParameter(x);
+        for (int i = 0; i < N_; i++)
+            EXPECT_NEAR(1. + shift, x(i), 1.e-4);
+    }
+};
+
+
+TEST_F(LBFGSTest, test_minimize)
+{
+    N_ = 2;
+    minimize();
+    N_ = 10;
+    minimize();
+}
+
+
+TEST_F(LBFGSTest, test_bound)
+{
+    N_ = 5;
+    bound();
+}
+
+
+TEST_F(LBFGSTest, test_warm_start)
+{
+    N_ = 10;
+    warm_start();
+}
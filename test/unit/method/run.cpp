@@ -34,6 +34,9 @@
 #include "blue.hpp"
 #include "cholesky.hpp"
 #include "test_compare.hpp"
+#include "lbfgs.hpp"
+#include "trajectory_manager.hpp"
+#include "four_dimensional_variational.hpp"
 
 
 // Main function used to launch the Google Test framework.
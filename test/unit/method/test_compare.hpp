@@ -122,6 +122,30 @@ TEST_F(MethodCompare, test_UKF)
 }
 
 
+//! This test checks that the low-rank EKF produces the same output as EKF.
+TEST_F(MethodCompare, test_EKF_low_rank)
+{
+    // The rank of the covariance factor is the dimension of the state, so
+    // that no information is lost.
+    Verdandi::ExtendedKalmanFilter<Verdandi::QuadraticModel<real>,
+                                   Verdandi::LinearObservationManager
+                                   <real> > driver;
+
+    driver.Initialize("configuration_low_rank.lua");
+
+    while (!driver.HasFinished())
+    {
+        driver.InitializeStep();
+        driver.Forward();
+        driver.FinalizeStep();
+    }
+
+    state compared_state = driver.GetModel().GetState();
+    AssertStateEqual(compared_state, shared_state_);
+    driver.Finalize();
+}
+
+
 //! This test checks that the ROEKF produces the same output as EKF.
 TEST_F(MethodCompare, test_ROEKF)
 {
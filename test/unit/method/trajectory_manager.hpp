@@ -0,0 +1,284 @@
+// Copyright (C) 2026
+// Author(s): agent
+//
+// This file is part of the data assimilation library Verdandi.
+//
+// Verdandi is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Verdandi is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Verdandi. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Verdandi web site:
+//      http://verdandi.gforge.inria.fr/
+
+
+#include "Verdandi.hxx"
+#include "method/TrajectoryManager.cxx"
+using namespace Verdandi;
+
+
+//! Model whose state after \a k steps is (k, k^2), at time k / 2.
+class CountingModel
+{
+public:
+    typedef Vector<double> state;
+
+protected:
+    state state_;
+    double time_;
+
+public:
+    CountingModel(): state_(2), time_(0.)
+    {
+        state_.Zero();
+    }
+
+    int GetNstate() const
+    {
+        return 2;
+    }
+
+    state& GetState()
+    {
+        return state_;
+    }
+
+    void StateUpdated()
+    {
+    }
+
+    double GetTime() const
+    {
+        return time_;
+    }
+
+    void SetTime(double time)
+    {
+        time_ = time;
+    }
+
+    void Forward()
+    {
+        state_(0) += 1.;
+        state_(1) = state_(0) * state_(0);
+        time_ += 0.5;
+    }
+
+    bool HasFinished() const
+    {
+        return false;
+    }
+};
+
+
+//! Gives access to the binomial split of the trajectory manager.
+class BinomialTrajectoryManager: public TrajectoryManager<CountingModel>
+{
+public:
+    using TrajectoryManager<CountingModel>::ComputeBinomialSplit;
+};
+
+
+class TrajectoryManagerTest: public testing::Test
+{
+public:
+    //! Binomial coefficient.
+    double binomial(int n, int k)
+    {
+        if (k < 0 || k > n)
+            return 0.;
+        double value = 1.;
+        for (int i = 1; i <= k; i++)
+            value = value * double(n - k + i) / double(i);
+        return value;
+    }
+
+    /*! \brief Minimal number of recomputed steps to load \a Nstep states
+      backward with \a Ncheckpoint checkpoints, the first one being at the
+      first step (Griewank, 1992). */
+    int griewank_bound(int Nstep, int Ncheckpoint)
+    {
+        int r = 0;
+        while (binomial(Ncheckpoint + r, Ncheckpoint) < double(Nstep))
+            r++;
+        return r * Nstep - int(binomial(Ncheckpoint + r, Ncheckpoint + 1)
+                               + 0.5);
+    }
+
+    /*! \brief Number of recomputed steps when the checkpoints are placed
+      with ComputeBinomialSplit. */
+    int split_cost(BinomialTrajectoryManager& manager, int Nstep,
+                   int Ncheckpoint)
+    {
+        if (Nstep <= 1)
+            return 0;
+        if (Ncheckpoint == 1)
+            return Nstep * (Nstep - 1) / 2;
+        int split = manager.ComputeBinomialSplit(Nstep, Ncheckpoint - 1);
+        EXPECT_GE(split, 1);
+        EXPECT_LE(split, Nstep - 1);
+        return split + split_cost(manager, Nstep - split, Ncheckpoint - 1)
+            + split_cost(manager, split, Ncheckpoint);
+    }
+
+    /*! \brief Records a trajectory twice, and loads it backward after each
+      recording. */
+    void record_and_load(int Nstep, int Ncheckpoint)
+    {
+        TrajectoryManager<CountingModel> manager;
+        manager.Initialize("memory", "", "memory", "", 1, "binomial",
+                           Ncheckpoint);
+
+        // The first recording gives the number of steps, so that the
+        // checkpoints of the second recording follow the binomial schedule.
+        for (int recording = 0; recording < 2; recording++)
+        {
+            CountingModel model;
+            for (int k = 0; k < Nstep; k++)
+            {
+                manager.Save(model.GetState(), model.GetTime());
+                model.Forward();
+            }
+
+            for (int k = Nstep - 1; k >= 0; k--)
+            {
+                manager.SetTime(model, 0.5 * double(k));
+                ASSERT_DOUBLE_EQ(0.5 * double(k), manager.GetTime());
+                ASSERT_DOUBLE_EQ(double(k), manager.GetState()(0));
+                ASSERT_DOUBLE_EQ(double(k * k), manager.GetState()(1));
+            }
+
+            // The model is left as it was.
+            ASSERT_DOUBLE_EQ(double(Nstep), model.GetState()(0));
+            ASSERT_DOUBLE_EQ(0.5 * double(Nstep), model.GetTime());
+
+            if (recording == 1)
+                ASSERT_LE(manager.GetNrecomputedStep(),
+                          griewank_bound(Nstep, Ncheckpoint));
+            manager.Deallocate();
+        }
+    }
+
+    /*! \brief Records a trajectory twice on disk, with a checkpoint every
+      \a Nskip_step steps, and loads it backward after each recording. */
+    void record_and_load_disk(int Nstep, int Nskip_step)
+    {
+        TrajectoryManager<CountingModel> manager;
+        manager.Initialize("disk", "result/checkpoint.bin", "disk",
+                           "result/trajectory.bin", Nskip_step, "uniform",
+                           0);
+
+        for (int recording = 0; recording < 2; recording++)
+        {
+            CountingModel model;
+            for (int k = 0; k < Nstep; k++)
+            {
+                manager.Save(model.GetState(), model.GetTime());
+                model.Forward();
+            }
+
+            for (int k = Nstep - 1; k >= 0; k--)
+            {
+                manager.SetTime(model, 0.5 * double(k));
+                ASSERT_DOUBLE_EQ(0.5 * double(k), manager.GetTime());
+                ASSERT_DOUBLE_EQ(double(k), manager.GetState()(0));
+                ASSERT_DOUBLE_EQ(double(k * k), manager.GetState()(1));
+            }
+
+            ASSERT_DOUBLE_EQ(double(Nstep), model.GetState()(0));
+            ASSERT_DOUBLE_EQ(0.5 * double(Nstep), model.GetTime());
+            manager.Deallocate();
+        }
+    }
+};
+
+
+TEST_F(TrajectoryManagerTest, test_binomial_split)
+{
+    BinomialTrajectoryManager manager;
+    int Ncheckpoint[4] = {1, 2, 3, 5};
+    for (int i = 0; i < 4; i++)
+        for (int Nstep = 1; Nstep <= 100; Nstep++)
+            ASSERT_EQ(griewank_bound(Nstep, Ncheckpoint[i]),
+                      split_cost(manager, Nstep, Ncheckpoint[i]));
+}
+
+
+TEST_F(TrajectoryManagerTest, test_binomial_load)
+{
+    int Nstep[5] = {1, 2, 10, 57, 100};
+    int Ncheckpoint[4] = {1, 2, 3, 5};
+    for (int i = 0; i < 5; i++)
+        for (int j = 0; j < 4; j++)
+            record_and_load(Nstep[i], Ncheckpoint[j]);
+}
+
+
+TEST_F(TrajectoryManagerTest, test_file)
+{
+    TrajectoryFile<double> file;
+    file.Open("result/trajectory_file.bin");
+    ASSERT_TRUE(file.IsOpen());
+
+    double record[3];
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+            record[j] = double(10 * i + j);
+        file.Write(i, record, 3);
+    }
+    ASSERT_EQ(3, file.GetNrecord());
+    for (int i = 2; i >= 0; i--)
+        for (int j = 0; j < 3; j++)
+            ASSERT_DOUBLE_EQ(double(10 * i + j), file.Read(i)[j]);
+
+    // The new record lies beyond the mapping, which is then extended.
+    for (int j = 0; j < 3; j++)
+        record[j] = double(30 + j);
+    file.Write(3, record, 3);
+    ASSERT_EQ(4, file.GetNrecord());
+    for (int i = 3; i >= 0; i--)
+        for (int j = 0; j < 3; j++)
+            ASSERT_DOUBLE_EQ(double(10 * i + j), file.Read(i)[j]);
+
+    // An overwritten record is read again from the file.
+    for (int j = 0; j < 3; j++)
+        record[j] = double(-j);
+    file.Write(1, record, 3);
+    for (int j = 0; j < 3; j++)
+    {
+        ASSERT_DOUBLE_EQ(double(-j), file.Read(1)[j]);
+        ASSERT_DOUBLE_EQ(double(20 + j), file.Read(2)[j]);
+    }
+
+    // After clearing, the records may have another size.
+    file.Clear();
+    ASSERT_TRUE(file.IsOpen());
+    ASSERT_EQ(0, file.GetNrecord());
+    file.Write(0, record, 2);
+    ASSERT_EQ(1, file.GetNrecord());
+    ASSERT_DOUBLE_EQ(0., file.Read(0)[0]);
+    ASSERT_DOUBLE_EQ(-1., file.Read(0)[1]);
+
+    file.Close();
+    ASSERT_FALSE(file.IsOpen());
+    ASSERT_EQ(0, file.GetNrecord());
+}
+
+
+TEST_F(TrajectoryManagerTest, test_disk_load)
+{
+    int Nstep[4] = {1, 2, 10, 57};
+    int Nskip_step[3] = {1, 3, 10};
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 3; j++)
+            record_and_load_disk(Nstep[i], Nskip_step[j]);
+}
@@ -37,6 +37,7 @@
 #endif
 
 #include "test_function_inverse.hpp"
+#include "test_quadratic_form.hpp"
 
 #ifdef VERDANDI_HAS_CXX11
 #include "test_random.hpp"
@@ -0,0 +1,75 @@
+// Copyright (C) 2026
+// Author(s): agent
+//
+// This file is part of the data assimilation library Verdandi.
+//
+// Verdandi is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Verdandi is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Verdandi. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Verdandi web site:
+//      http://verdandi.gforge.inria.fr/
+
+
+
+#include "Verdandi.hxx"
+
+using namespace Verdandi;
+
+
+class QuadraticFormTest: public testing::Test
+{
+protected:
+    int Nloop_;
+    int N_;
+
+public:
+    void quadratic_form()
+    {
+        typedef double real;
+        Matrix<real> A_dense;
+        Matrix<real, General, RowSparse> A;
+        Matrix<real, General, ArrayRowSparse> A_array;
+        Vector<real> x, Ax;
+
+        for (int k = 0; k < Nloop_; k++)
+        {
+            A_array.Reallocate(N_, N_);
+            for (int l = 0; l < int(N_ * N_ / 4); l++)
+                A_array.AddInteraction(rand() % N_, rand() % N_,
+                                       real(rand()) / real(RAND_MAX));
+            Copy(A_array, A);
+            Copy(A, A_dense);
+
+            x.Reallocate(N_);
+            x.FillRand();
+            Mlt(real(1) / real(RAND_MAX), x);
+
+            Ax.Reallocate(N_);
+            MltAdd(real(1), A_dense, x, real(0), Ax);
+            real reference = DotProd(x, Ax);
+
+            EXPECT_NEAR(reference, QuadraticForm(A_dense, x),
+                        1.e-12 * abs(reference));
+            EXPECT_NEAR(reference, QuadraticForm(A, x),
+                        1.e-12 * abs(reference));
+        }
+    }
+};
+
+
+TEST_F (QuadraticFormTest, test_quadratic_form)
+{
+    Nloop_ = 10;
+    N_ = 15;
+    quadratic_form();
+}